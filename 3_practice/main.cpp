@@ -6,10 +6,11 @@
 #include <complex.h>
 #include <string.h>
 
+#include "../9_practice/src/pulse/pulse_shape.h"
+
 #define ADC_CAPACITY 12
 #define BITS_SHIFT 4
 #define TAU 10
-#define TAU_ON_BITS TAU*2
 #define MESSAGE "Hello My Beuatiful World"
 
 uint8_t* stob(char* str, int* out_bits_count) {
@@ -43,30 +44,6 @@ uint8_t* stob(char* str, int* out_bits_count) {
     return bits;
 }
 
-int16_t* bits_to_signal(uint8_t* bits, int bits_count, int tx_mtu){
-
-    // allocate memory
-    int16_t* tx_buff = (int16_t*)malloc(sizeof(int16_t) * tx_mtu * 2);
-
-    // iterate on bitts
-    for (int i = 0; i < bits_count; i += 1)
-    {   
-        // fill tx_buff with samples
-        for(int j = i*TAU_ON_BITS; j < i*TAU_ON_BITS + 20 && j < tx_mtu*2; j+=2){
-            if(bits[i]){
-                tx_buff[j] = 2047 << 4;    // I
-                tx_buff[j+1] = -2047 << 4; // Q
-            } else{
-                tx_buff[j] = 0;      //I
-                tx_buff[j+1] = 0;    //Q
-            }
-        }
-    }
-
-    return tx_buff;
-}
-
-
 int main(){
     FILE *rx_samples = fopen("rx_samples.txt", "w");
     FILE *tx_samples = fopen("tx_samples.txt", "w");
@@ -130,8 +107,11 @@ int main(){
     // Выделяем память под буферы RX и TX
     int bits_count;
     uint8_t* bits = stob(MESSAGE, &bits_count);
-    int tx_mtu = bits_count * TAU;
-    int16_t* tx_buff = bits_to_signal(bits, bits_count, tx_mtu);
+    // Прямоугольные импульсы по TAU отсчетов на бит, таблица формы считается при компиляции
+    using TxPulse = PulseShaper<PulseType::Rect, TAU>;
+    int tx_mtu = TxPulse::output_length(bits_count);
+    int16_t* tx_buff = (int16_t*)malloc(sizeof(int16_t) * tx_mtu * 2);
+    TxPulse::shape_bits_cs16(bits, bits_count, 2047 << BITS_SHIFT, -(2047 << BITS_SHIFT), tx_buff, tx_mtu);
  
     //заполнение tx_buff значениями сэмплов первые 16 бит - I, вторые 16 бит - Q.
 
@@ -1,6 +1,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <stdint.h>
+
+#include "../9_practice/src/export/npy.h"
 
 // BPSK модуляция
 double* BPSK_modulation(int* bits, int bits_count) {
@@ -42,96 +45,99 @@ double* QPSK_modulation(int* bits, int bits_count) {
     return IQ_samples;
 }
 
-// Функция для сохранения данных для построения графиков
-void save_plot_data(const char* filename, double* I_samples, double* Q_samples, int samples_count, int Fs) {
-    FILE* file = fopen(filename, "w");
-    if(file == nullptr) return;
-    
-    // Сохраняем I компоненту
-    fprintf(file, "I_samples = [");
-    for(int i = 0; i < samples_count; i++) {
-        for(int j = 0; j < Fs; j++) {
-            fprintf(file, "%.2f", I_samples[i]);
-            if(i < samples_count - 1 || j < Fs - 1) fprintf(file, ", ");
-        }
-    }
-    fprintf(file, "]\n\n");
-    
-    // Сохраняем Q компоненту
-    fprintf(file, "Q_samples = [");
-    for(int i = 0; i < samples_count; i++) {
-        for(int j = 0; j < Fs; j++) {
-            fprintf(file, "%.2f", Q_samples[i]);
-            if(i < samples_count - 1 || j < Fs - 1) fprintf(file, ", ");
-        }
-    }
-    fprintf(file, "]\n\n");
-    
-    // Сохраняем временную ось
-    fprintf(file, "t = [");
-    double total_time = (double)(samples_count * Fs) / Fs;
-    for(int i = 0; i < samples_count * Fs; i++) {
-        fprintf(file, "%.3f", (double)i / Fs);
-        if(i < samples_count * Fs - 1) fprintf(file, ", ");
-    }
-    fprintf(file, "]\n");
-    
-    fclose(file);
+// Функция для сохранения данных для построения графиков.
+// Символы хранятся один раз, а не Fs раз: растяжение до отсчетов и временную ось
+// скрипт строит сам по upsample_factor. Формат .npz читается numpy.load().
+void save_plot_data(const char* filename, double* I_samples, double* Q_samples, int samples_count, int Fs,
+                    const char* modulation_type) {
+    NpzWriter archive;
+    if(!archive.open(filename)) return;
+
+    archive.add("I_symbols", I_samples, {(size_t)samples_count});
+    archive.add("Q_symbols", Q_samples, {(size_t)samples_count});
+    archive.add_scalar<int32_t>("upsample_factor", Fs);
+    archive.add_string("modulation", modulation_type);
+    archive.close();
 }
 
 // Функция для создания Python скрипта для построения графиков
-void create_python_plot_script(const char* modulation_type) {
+void create_python_plot_script() {
     FILE* script = fopen("plot_signal.py", "w");
     if(script == nullptr) return;
-    
-    fprintf(script, "import matplotlib.pyplot as plt\n");
-    fprintf(script, "import numpy as np\n\n");
-    
-    fprintf(script, "def plot_modulation():\n");
-    fprintf(script, "    # Загружаем данные\n");
-    fprintf(script, "    with open('plot_data.txt', 'r') as f:\n");
-    fprintf(script, "        exec(f.read())\n\n");
-    
-    fprintf(script, "    # График I и Q компонент\n");
-    fprintf(script, "    plt.figure(figsize=(12, 8))\n\n");
-    
-    fprintf(script, "    plt.subplot(2, 1, 1)\n");
-    fprintf(script, "    plt.step(t, I_samples, where='post')\n");
-    fprintf(script, "    plt.title('%s - In-phase Component (I)')\n", modulation_type);
-    fprintf(script, "    plt.xlabel('Time (s)')\n");
-    fprintf(script, "    plt.ylabel('Amplitude')\n");
-    fprintf(script, "    plt.grid(True)\n\n");
-    
-    fprintf(script, "    plt.subplot(2, 1, 2)\n");
-    fprintf(script, "    plt.step(t, Q_samples, where='post')\n");
-    fprintf(script, "    plt.title('%s - Quadrature Component (Q)')\n", modulation_type);
-    fprintf(script, "    plt.xlabel('Time (s)')\n");
-    fprintf(script, "    plt.ylabel('Amplitude')\n");
-    fprintf(script, "    plt.grid(True)\n\n");
-    
-    fprintf(script, "    plt.tight_layout()\n");
-    fprintf(script, "    plt.show()\n\n");
-    
-    fprintf(script, "    # Создание созвездия\n");
-    fprintf(script, "    I_symbols = I_samples[::1000]  # Берем по одному sample на символ\n");
-    fprintf(script, "    Q_symbols = Q_samples[::1000]\n\n");
-    
-    fprintf(script, "    plt.figure(figsize=(8, 8))\n");
-    fprintf(script, "    plt.scatter(I_symbols, Q_symbols, s=100, c='red', marker='o')\n");
-    fprintf(script, "    plt.axhline(y=0, color='k', linestyle='-', alpha=0.3)\n");
-    fprintf(script, "    plt.axvline(x=0, color='k', linestyle='-', alpha=0.3)\n");
-    fprintf(script, "    plt.grid(True)\n");
-    fprintf(script, "    plt.title('%s Constellation Diagram')\n", modulation_type);
-    fprintf(script, "    plt.xlabel('In-phase (I)')\n");
-    fprintf(script, "    plt.ylabel('Quadrature (Q)')\n");
-    fprintf(script, "    plt.axis('equal')\n");
-    fprintf(script, "    plt.xlim(-1.5, 1.5)\n");
-    fprintf(script, "    plt.ylim(-1.5, 1.5)\n");
-    fprintf(script, "    plt.show()\n\n");
-    
-    fprintf(script, "if __name__ == '__main__':\n");
-    fprintf(script, "    plot_modulation()\n");
-    
+
+    fputs(R"PY(import sys
+import matplotlib.pyplot as plt
+import numpy as np
+
+
+class Upsampled:
+    """Ленивое растяжение символов: отсчет i берется из символа i // factor"""
+
+    def __init__(self, symbols, factor):
+        self.symbols = symbols
+        self.factor = factor
+
+    def __len__(self):
+        return len(self.symbols) * self.factor
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            start, stop, step = index.indices(len(self))
+            return self.symbols[np.arange(start, stop, step) // self.factor]
+        return self.symbols[index // self.factor]
+
+
+def plot_modulation(path):
+    # Загружаем данные
+    data = np.load(path)
+    modulation_type = data['modulation'].item().decode()
+    factor = int(data['upsample_factor'])
+    I_samples = Upsampled(data['I_symbols'], factor)
+    Q_samples = Upsampled(data['Q_symbols'], factor)
+
+    # График I и Q компонент: ступенька на символ выглядит так же, как Fs отсчетов
+    t = np.arange(len(data['I_symbols']) + 1)
+    plt.figure(figsize=(12, 8))
+
+    plt.subplot(2, 1, 1)
+    plt.step(t, np.append(data['I_symbols'], data['I_symbols'][-1]), where='post')
+    plt.title(f'{modulation_type} - In-phase Component (I)')
+    plt.xlabel('Time (s)')
+    plt.ylabel('Amplitude')
+    plt.grid(True)
+
+    plt.subplot(2, 1, 2)
+    plt.step(t, np.append(data['Q_symbols'], data['Q_symbols'][-1]), where='post')
+    plt.title(f'{modulation_type} - Quadrature Component (Q)')
+    plt.xlabel('Time (s)')
+    plt.ylabel('Amplitude')
+    plt.grid(True)
+
+    plt.tight_layout()
+    plt.show()
+
+    # Создание созвездия
+    I_symbols = I_samples[::factor]  # Берем по одному sample на символ
+    Q_symbols = Q_samples[::factor]
+
+    plt.figure(figsize=(8, 8))
+    plt.scatter(I_symbols, Q_symbols, s=100, c='red', marker='o')
+    plt.axhline(y=0, color='k', linestyle='-', alpha=0.3)
+    plt.axvline(x=0, color='k', linestyle='-', alpha=0.3)
+    plt.grid(True)
+    plt.title(f'{modulation_type} Constellation Diagram')
+    plt.xlabel('In-phase (I)')
+    plt.ylabel('Quadrature (Q)')
+    plt.axis('equal')
+    plt.xlim(-1.5, 1.5)
+    plt.ylim(-1.5, 1.5)
+    plt.show()
+
+
+if __name__ == '__main__':
+    plot_modulation(sys.argv[1] if len(sys.argv) > 1 else 'bpsk_plot_data.npz')
+)PY", script);
+
     fclose(script);
 }
 
@@ -166,10 +172,9 @@ int main() {
         bpsk_I[i] = bpsk_result[i * 2];
         bpsk_Q[i] = bpsk_result[i * 2 + 1];
     }
-    save_plot_data("bpsk_plot_data.txt", bpsk_I, bpsk_Q, bits_seq_len, 1000);
-    create_python_plot_script("BPSK");
-    printf("BPSK plot data saved to bpsk_plot_data.txt\n");
-    printf("Run 'python plot_signal.py' to view BPSK plots\n\n");
+    save_plot_data("bpsk_plot_data.npz", bpsk_I, bpsk_Q, bits_seq_len, 1000, "BPSK");
+    printf("BPSK plot data saved to bpsk_plot_data.npz\n");
+    printf("Run 'python plot_signal.py bpsk_plot_data.npz' to view BPSK plots\n\n");
 
     free(bpsk_I);
     free(bpsk_Q);
@@ -195,10 +200,9 @@ int main() {
         qpsk_I[i] = qpsk_result[i * 2];
         qpsk_Q[i] = qpsk_result[i * 2 + 1];
     }
-    save_plot_data("qpsk_plot_data.txt", qpsk_I, qpsk_Q, qpsk_symbols_count, 1000);
-    create_python_plot_script("QPSK");
-    printf("QPSK plot data saved to qpsk_plot_data.txt\n");
-    printf("Run 'python plot_signal.py' to view QPSK plots\n\n");
+    save_plot_data("qpsk_plot_data.npz", qpsk_I, qpsk_Q, qpsk_symbols_count, 1000, "QPSK");
+    printf("QPSK plot data saved to qpsk_plot_data.npz\n");
+    printf("Run 'python plot_signal.py qpsk_plot_data.npz' to view QPSK plots\n\n");
 
     free(qpsk_I);
     free(qpsk_Q);
@@ -207,9 +211,11 @@ int main() {
     free(bpsk_result);
     free(qpsk_result);
 
+    create_python_plot_script();
+
     printf("Для построения графиков выполните:\n");
-    printf("1. Для BPSK: скопируйте содержимое bpsk_plot_data.txt в plot_data.txt и запустите 'python plot_signal.py'\n");
-    printf("2. Для QPSK: скопируйте содержимое qpsk_plot_data.txt в plot_data.txt и запустите 'python plot_signal.py'\n");
+    printf("1. Для BPSK: python plot_signal.py bpsk_plot_data.npz\n");
+    printf("2. Для QPSK: python plot_signal.py qpsk_plot_data.npz\n");
 
     return 0;
 }
\ No newline at end of file
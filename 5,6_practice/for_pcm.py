@@ -2,12 +2,21 @@ import numpy as np
 import matplotlib.pyplot as plt
 from pathlib import Path
 
+try:
+    # Модуль из 9_practice: запись отображается в память без копирования
+    import sdr_dsp
+except ImportError:
+    sdr_dsp = None
+
 def visualize_pcm_signal(file_path):
     """
     Визуализирует I/Q компоненты из PCM файла
     """
     # Чтение бинарных данных
-    raw_data = np.fromfile(file_path, dtype=np.int16)
+    if sdr_dsp is not None:
+        raw_data = np.frombuffer(sdr_dsp.Capture(str(file_path)), dtype=np.int16)
+    else:
+        raw_data = np.fromfile(file_path, dtype=np.int16)
     
     # Разделение на I и Q компоненты
     in_phase = raw_data[0::2]      # Четные элементы - I компонента
@@ -13,9 +13,14 @@ def plot_iq_data(filename, modulation_type):
         print("Убедитесь, что файл находится в правильной папке")
         return
 
-    # Чтение данных
+    # Чтение данных: .npz из main.cpp (save_to_file) или старый CSV
     try:
-        data = pd.read_csv(filename)
+        if filename.endswith('.npz'):
+            archive = np.load(filename)
+            data = {'real': archive['iq'].real, 'imag': archive['iq'].imag}
+            data = pd.DataFrame(data)
+        else:
+            data = pd.read_csv(filename)
         print(f"Файл {filename} успешно загружен")
     except Exception as e:
         print(f"Ошибка при чтении файла: {e}")
@@ -90,7 +95,7 @@ create_test_file()
 # Запускаем визуализацию
 plot_iq_data('iq_data_qpsk.csv', 'BPSK')
 
-plot_iq_data('iq_data_qpsk_spread.csv', 'BPSK')
+plot_iq_data('iq_data_qpsk_spread.npz', 'BPSK')
 
 # Если у вас есть свой файл, раскомментируйте эту строку:
 # plot_iq_data('ваш_файл.csv', 'BPSK')
\ No newline at end of file
@@ -2,25 +2,24 @@
 #include <vector>
 #include <cmath>
 #include <complex>
-#include <random>
 #include <fstream>
 #include <iio.h>
 #include <thread>
 #include <chrono>
 
+#include "../9_practice/src/dsss/codes.h"
+#include "../9_practice/src/export/npy.h"
+#include "../9_practice/src/prbs/prbs.h"
+
 using namespace std;
 
-// Генерация случайных битов
-vector<int> generate_bits(int num_bits) {
-    vector<int> bits(num_bits);
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(0, 1);
-    
-    for (int i = 0; i < num_bits; i++) {
-        bits[i] = dis(gen);
-    }
-    return bits;
+// Генерация битов: PRBS вместо mt19937 - последовательность воспроизводима
+// и проверяется на приеме счетчиком BerTester из 9 практики
+vector<int> generate_bits(int num_bits, int prbs_order = 9) {
+    vector<uint8_t> packed(num_bits);
+    PrbsGenerator generator(prbs_type_from_order(prbs_order));
+    generator.fill_bits(packed.data(), packed.size());
+    return vector<int>(packed.begin(), packed.end());
 }
 
 // Функция свертки по формуле: y[n] = sum_k x[n] * h[n-k]
@@ -40,23 +39,12 @@ vector<complex<double>> custom_convolution(const vector<complex<double>>& x, con
     return y;
 }
 
-// Специальная функция для преобразования [1,1] + 9 нулей -> 10 раз [1,1]
-vector<complex<double>> apply_symbol_spreading(const vector<complex<double>>& input, int spread_factor = 10) {
-    vector<complex<double>> output;
-    
-    for (int i = 0; i < input.size(); i++) {
-        if (input[i] != complex<double>(0, 0)) {
-            // Найден символ - распространяем его на spread_factor позиций
-            for (int j = 0; j < spread_factor; j++) {
-                output.push_back(input[i]);
-            }
-        } else {
-            // Нулевой символ - добавляем как есть
-            output.push_back(input[i]);
-        }
-    }
-    
-    return output;
+// Расширение спектра DSSS: каждый символ заменяется code.length чипами кода
+// (код Баркера, m-последовательность или код Голда из 9 практики)
+vector<complex<double>> apply_dsss_spreading(const vector<complex<double>>& symbols, const SpreadingCode& code) {
+    vector<complex<double>> chips(symbols.size() * code.length);
+    dsss_spread(symbols.data(), symbols.size(), code, chips.data());
+    return chips;
 }
 
 vector<complex<double>> bpsk_modulation(const vector<int>& bits, int upsample_factor = 10) {
@@ -106,22 +94,6 @@ vector<complex<double>> qpsk_modulation(const vector<int>& bits, int upsample_fa
     return iq_samples;
 }
 
-// Upsampling с фильтром возвышения косинуса
-vector<complex<double>> upsample(const vector<complex<double>>& symbols, 
-                                int samples_per_symbol, 
-                                double beta = 0.35) {
-    int num_symbols = symbols.size();
-    int total_samples = num_symbols * samples_per_symbol;
-    vector<complex<double>> upsampled(total_samples, 0.0);
-    
-    // Простой upsampling
-    for (int i = 0; i < num_symbols; i++) {
-        upsampled[i * samples_per_symbol] = symbols[i];
-    }
-    
-    return upsampled;
-}
-
 // Конвертация complex<double> в int16_t для Pluto SDR
 vector<int16_t> convert_to_pluto_format(const vector<complex<double>>& iq_data, double scale_factor = 2000.0) {
     vector<int16_t> pluto_data(iq_data.size() * 2); // I и Q чередуются
@@ -208,53 +180,47 @@ bool transmit_with_pluto(struct iio_context* ctx, const vector<int16_t>& tx_data
     return true;
 }
 
-// Сохранение данных в файл для анализа
+// Сохранение данных в файл для анализа (.npz, читается numpy.load).
+// Биты и IQ хранятся по одному разу, соответствие сэмпл -> бит задает samples_per_bit.
 void save_to_file(const vector<complex<double>>& iq_data, 
                   const vector<int>& bits, 
                   const string& filename) {
-    ofstream file(filename);
-    
-    // Записываем заголовок
-    file << "bits,real,imag" << endl;
+    NpzWriter archive;
+    if (!archive.open(filename)) return;
+
+    vector<uint8_t> bit_values(bits.begin(), bits.end());
+    int samples_per_bit = (iq_data.size() > bits.size()) ? iq_data.size() / bits.size() : 1;
+
+    archive.add("bits", bit_values.data(), {bit_values.size()});
+    archive.add("iq", iq_data.data(), {iq_data.size()});
+    archive.add_scalar<int32_t>("samples_per_bit", samples_per_bit);
+    archive.close();
+}
+
+// Демонстрация работы расширения
+void demonstrate_spreading() {
+    cout << "\n=== ДЕМОНСТРАЦИЯ РАСШИРЕНИЯ СПЕКТРА ===" << endl;
     
-    int symbols_per_bit = (iq_data.size() > bits.size()) ? iq_data.size() / bits.size() : 1;
+    SpreadingCode code = barker_code(11);
+    vector<complex<double>> test1 = {{1, 1}, {-1, 1}};
     
-    for (size_t i = 0; i < iq_data.size(); i++) {
-        int bit_index = i / symbols_per_bit;
-        if (bit_index < bits.size()) {
-            file << bits[bit_index] << "," 
-                 << iq_data[i].real() << "," 
-                 << iq_data[i].imag() << endl;
-        } else {
-            file << "0," << iq_data[i].real() << "," << iq_data[i].imag() << endl;
-        }
+    cout << "Код " << code.name << ": ";
+    for (size_t c = 0; c < code.length; c++) {
+        cout << (code.sign(c) > 0 ? "+" : "-");
     }
+    cout << endl;
     
-    file.close();
-}
-
-// Демонстрация работы преобразования
-void demonstrate_spreading() {
-    cout << "\n=== ДЕМОНСТРАЦИЯ ПРЕОБРАЗОВАНИЯ ===" << endl;
-    
-    // Тест 1: [1,1] и 9 нулей
-    vector<complex<double>> test1 = {
-        {1, 1}, {1, 1},  // первые 2 сэмпла (1,1)
-        {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}  // 9 нулей
-    };
-    
-    cout << "ТЕСТ 1: [1,1] и 9 нулей" << endl;
-    cout << "Входные сэмплы: ";
-    for (int i = 0; i < 11; i++) {
-        cout << "(" << test1[i].real() << "," << test1[i].imag() << ") ";
+    cout << "Входные символы: ";
+    for (const auto& symbol : test1) {
+        cout << "(" << symbol.real() << "," << symbol.imag() << ") ";
     }
     cout << endl;
     
-    vector<complex<double>> result1 = apply_symbol_spreading(test1, 10);
+    vector<complex<double>> result1 = apply_dsss_spreading(test1, code);
     
-    cout << "Сэмплы после преобразования: ";
-    for (int i = 0; i < 10; i++) {
-        cout << "(" << result1[i].real() << "," << result1[i].imag() << ") ";
+    cout << "Чипы после расширения: ";
+    for (const auto& chip : result1) {
+        cout << "(" << chip.real() << "," << chip.imag() << ") ";
     }
     cout << endl;
 }
@@ -265,13 +231,13 @@ int main() {
     
     // Параметры
     int num_bits = 1000; // Количество битов
-    int samples_per_symbol = 4;   // Samples per symbol для upsampling
+    SpreadingCode code = barker_code(11);  // barker_code(13), m_sequence_code(7), gold_code(7, n)
     string modulation = "qpsk";   // "bpsk" или "qpsk"
     long long sample_rate = 1000000;  // 1 MHz
     long long frequency = 1000000000; // 1 GHz
     
     cout << "\n=== ОСНОВНАЯ ПРОГРАММА ===" << endl;
-    cout << "Генерация " << num_bits << " случайных битов..." << endl;
+    cout << "Генерация " << num_bits << " битов PRBS-9..." << endl;
     vector<int> bits = generate_bits(num_bits);
     
     vector<complex<double>> modulated_symbols;
@@ -279,31 +245,28 @@ int main() {
     // Модуляция
     if (modulation == "bpsk") {
         cout << "BPSK модуляция..." << endl;
-        modulated_symbols = bpsk_modulation(bits);
+        modulated_symbols = bpsk_modulation(bits, 1);
     } else if (modulation == "qpsk") {
         cout << "QPSK модуляция..." << endl;
-        modulated_symbols = qpsk_modulation(bits);
+        modulated_symbols = qpsk_modulation(bits, 1);
     } else {
         cerr << "Неизвестный тип модуляции: " << modulation << endl;
         return 1;
     }
     
-    cout << "Upsampling (" << samples_per_symbol << " samples per symbol)..." << endl;
-    vector<complex<double>> upsampled_iq = upsample(modulated_symbols, samples_per_symbol);
-    
-    // ПРИМЕНЯЕМ ПРЕОБРАЗОВАНИЕ ДЛЯ РАСПРОСТРАНЕНИЯ СИМВОЛОВ
-    cout << "\nПрименение преобразования для распространения символов..." << endl;
-    vector<complex<double>> spread_iq = apply_symbol_spreading(upsampled_iq, 10);
+    // Расширение спектра: один отсчет на чип
+    cout << "\nРасширение спектра кодом " << code.name << " (" << code.length << " чипов на символ)..." << endl;
+    vector<complex<double>> spread_iq = apply_dsss_spreading(modulated_symbols, code);
     
-    // Выводим сэмплы до и после преобразования
-    cout << "\nПервые 30 сэмплов ДО преобразования: " << endl;
-    for (int i = 0; i < min(30, (int)upsampled_iq.size()); i++) {
-        cout << "Сэмпл " << i << ": (" << upsampled_iq[i].real() << ", " << upsampled_iq[i].imag() << ")" << endl;
+    // Выводим символы и чипы
+    cout << "\nПервые 3 символа: " << endl;
+    for (int i = 0; i < min(3, (int)modulated_symbols.size()); i++) {
+        cout << "Символ " << i << ": (" << modulated_symbols[i].real() << ", " << modulated_symbols[i].imag() << ")" << endl;
     }
     
-    cout << "\nПервые 30 сэмплов ПОСЛЕ преобразования: " << endl;
-    for (int i = 0; i < min(30, (int)spread_iq.size()); i++) {
-        cout << "Сэмпл " << i << ": (" << spread_iq[i].real() << ", " << spread_iq[i].imag() << ")" << endl;
+    cout << "\nПервые 33 чипа: " << endl;
+    for (int i = 0; i < min(33, (int)spread_iq.size()); i++) {
+        cout << "Чип " << i << ": (" << spread_iq[i].real() << ", " << spread_iq[i].imag() << ")" << endl;
     }
     
     // Инициализация Pluto SDR
@@ -336,11 +299,11 @@ int main() {
     }
     
     // Сохранение результатов в файл
-    string filename = "iq_data_" + modulation + "_spread.csv";
+    string filename = "iq_data_" + modulation + "_spread.npz";
     save_to_file(spread_iq, bits, filename);
     
     cout << "\nДанные сохранены в " << filename << endl;
-    cout << "Количество сэмплов после преобразования: " << spread_iq.size() << endl;
+    cout << "Количество чипов после расширения: " << spread_iq.size() << endl;
     
     return 0;
 }
\ No newline at end of file
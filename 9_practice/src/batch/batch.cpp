@@ -0,0 +1,511 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <memory>
+#include <sys/stat.h>
+
+#include "batch/batch.h"
+#include "capture/capture_file.h"
+#include "export/npy.h"
+#include "fft/fft.h"
+#include "filter/fir.h"
+#include "modulation/mapper.h"
+#include "prbs/ber_tester.h"
+
+// Символов для выбора фазы символьной решетки в куске
+constexpr size_t BATCH_SYNC_SYMBOLS = 4096;
+
+// Отсчеты записи: отображенный файл или разобранный текст
+struct CaptureSource {
+    CaptureFile mapped;
+    std::vector<int16_t> text;
+    const int16_t* iq = nullptr;
+    size_t samples = 0;
+};
+
+// Вклад одного куска; суммы, а не средние, чтобы куски складывались без весов
+struct ChunkResult {
+    uint64_t samples = 0;
+    double power_sum = 0;
+    double peak = 0;
+    uint64_t clipped = 0;
+    double dc_i = 0;
+    double dc_q = 0;
+
+    size_t timing_phase = 0;
+    uint64_t symbols = 0;
+    double error_power = 0;
+
+    uint64_t ber_bits = 0;
+    uint64_t ber_errors = 0;
+    bool locked = false;
+
+    std::vector<double> psd;
+    size_t psd_frames = 0;
+    double seconds = 0;
+};
+
+struct CaptureJob {
+    std::vector<ChunkResult> chunks;
+};
+
+static bool ends_with(const std::string& text, const char* suffix) {
+    size_t n = strlen(suffix);
+    return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+bool parse_batch_stages(const std::string& text, unsigned& stages) {
+    stages = 0;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t comma = text.find(',', pos);
+        std::string name = text.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        if (name == "all") stages |= BATCH_ALL_STAGES;
+        else if (name == "cond") stages |= BATCH_CONDITION;
+        else if (name == "sync") stages |= BATCH_SYNC;
+        else if (name == "demod") stages |= BATCH_DEMOD;
+        else if (name == "ber") stages |= BATCH_BER;
+        else if (name == "psd") stages |= BATCH_PSD;
+        else if (!name.empty()) return false;
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    if ((stages & BATCH_BER) && !(stages & BATCH_DEMOD)) return false;
+    if ((stages & BATCH_DEMOD) && !(stages & BATCH_SYNC)) return false;
+    return stages != 0;
+}
+
+static void collect_captures(const std::string& path, std::vector<std::string>& out) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return;
+    if (S_ISREG(info.st_mode)) {
+        if (ends_with(path, ".pcm") || ends_with(path, ".txt")) out.push_back(path);
+        return;
+    }
+    if (!S_ISDIR(info.st_mode)) return;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        collect_captures(path + "/" + entry->d_name, out);
+    }
+    closedir(dir);
+}
+
+std::vector<std::string> find_captures(const std::string& path) {
+    std::vector<std::string> captures;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+        // Явно указанный файл берется с любым расширением
+        captures.push_back(path);
+        return captures;
+    }
+    collect_captures(path, captures);
+    std::sort(captures.begin(), captures.end());
+    return captures;
+}
+
+bool load_text_capture(const std::string& path, std::vector<int16_t>& iq) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        printf("Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+    std::string text;
+    char buffer[65536];
+    size_t read_bytes;
+    while ((read_bytes = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, read_bytes);
+    fclose(file);
+
+    iq.clear();
+    const char* p = text.c_str();
+    while ((p = strchr(p, '(')) != nullptr) {
+        char* end;
+        long i = strtol(p + 1, &end, 10);
+        if (end == p + 1) {
+            ++p;
+            continue;
+        }
+        p = end;
+        while (*p == ' ') ++p;
+        if (*p != ',') continue;
+        long q = strtol(p + 1, &end, 10);
+        if (end == p + 1) continue;
+        p = end;
+        iq.push_back(saturate_int16(static_cast<float>(i)));
+        iq.push_back(saturate_int16(static_cast<float>(q)));
+    }
+    return true;
+}
+
+static bool open_source(const std::string& path, CaptureSource& source) {
+    if (ends_with(path, ".txt")) {
+        if (!load_text_capture(path, source.text)) return false;
+        source.iq = source.text.data();
+        source.samples = source.text.size() / 2;
+        return true;
+    }
+    if (!source.mapped.open(path)) return false;
+    source.iq = source.mapped.data();
+    source.samples = source.mapped.samples_count();
+    return true;
+}
+
+// Знак поворота на k * 2 pi / order (order = 2 или 4) без тригонометрии
+static cf32 rotation(size_t k, size_t order) {
+    static const cf32 turns[4] = {cf32(1, 0), cf32(0, 1), cf32(-1, 0), cf32(0, -1)};
+    return turns[(k * 4 / order) % 4];
+}
+
+// Ближайшая точка созвездия (мапперы: BPSK +-1, QPSK +-QPSK_AMPLITUDE)
+static cf32 nearest_point(cf32 y, BatchModulation modulation) {
+    if (modulation == BatchModulation::BPSK) return cf32(y.real() < 0 ? -1.0f : 1.0f, 0.0f);
+    return cf32(y.real() < 0 ? -QPSK_AMPLITUDE : QPSK_AMPLITUDE, y.imag() < 0 ? -QPSK_AMPLITUDE : QPSK_AMPLITUDE);
+}
+
+static void raw_statistics(const int16_t* iq, size_t count, ChunkResult& result) {
+    const int limit = static_cast<int>(CS16_FULL_SCALE);
+    double power = 0, peak = 0;
+    int64_t sum_i = 0, sum_q = 0;
+    uint64_t clipped = 0;
+    for (size_t n = 0; n < count; ++n) {
+        int i = iq[2 * n], q = iq[2 * n + 1];
+        double p = double(i) * i + double(q) * q;
+        power += p;
+        peak = std::max(peak, p);
+        sum_i += i;
+        sum_q += q;
+        clipped += std::abs(i) >= limit || std::abs(q) >= limit;
+    }
+    result.samples = count;
+    result.power_sum = power;
+    result.peak = peak;
+    result.clipped = clipped;
+    result.dc_i = static_cast<double>(sum_i);
+    result.dc_q = static_cast<double>(sum_q);
+}
+
+// Welch: окна с шагом fft_size / 2 на глобальной сетке, начала окон - внутри [start, end)
+static void accumulate_psd(const cf32* x, size_t first, size_t start, size_t end, size_t last,
+                           const BatchConfig& config, ChunkResult& result) {
+    const size_t n = config.fft_size;
+    const size_t hop = n / 2;
+    FftPlan plan(n);
+    std::vector<float> window(n);
+    for (size_t k = 0; k < n; ++k) window[k] = static_cast<float>(window_value(Window::Blackman, k, n));
+
+    std::vector<cf32> frame(n);
+    result.psd.assign(n, 0.0);
+    for (size_t pos = (start + hop - 1) / hop * hop; pos < end && pos + n <= last; pos += hop) {
+        const cf32* src = x + (pos - first);
+        for (size_t k = 0; k < n; ++k) frame[k] = src[k] * window[k];
+        plan.execute(frame.data());
+        for (size_t k = 0; k < n; ++k) result.psd[k] += std::norm(frame[k]);
+        ++result.psd_frames;
+    }
+}
+
+// Синхронизация, демодуляция и BER: символы на глобальной решетке phase + k * sps, интегрирование
+// за символ; фаза несущей - по M-й степени символов, неоднозначность k * 2pi/M
+// снимается BER-тестером (берется поворот, на котором он синхронизировался)
+static void demodulate(const cf32* x, size_t first, size_t start, size_t end, size_t last,
+                       const BatchConfig& config, ChunkResult& result) {
+    const size_t sps = config.samples_per_symbol;
+    const size_t order = config.modulation == BatchModulation::BPSK ? 2 : 4;
+    const float inv_sps = 1.0f / sps;
+
+    auto integrate = [&](size_t s) {
+        cf32 sum = 0;
+        const cf32* src = x + (s - first);
+        for (size_t k = 0; k < sps; ++k) sum += src[k];
+        return sum * inv_sps;
+    };
+    auto grid_start = [&](size_t from, size_t phase) {
+        return from <= phase ? phase : (from - phase + sps - 1) / sps * sps + phase;
+    };
+
+    // Фаза решетки: максимум энергии после интегратора (на прямоугольном импульсе
+    // интегратор, сдвинутый с границы символа, захватывает соседний символ)
+    size_t best_phase = 0;
+    double best_energy = -1;
+    for (size_t phase = 0; phase < sps; ++phase) {
+        double energy = 0;
+        size_t counted = 0;
+        for (size_t s = grid_start(start, phase); s < end && s + sps <= last && counted < BATCH_SYNC_SYMBOLS;
+             s += sps, ++counted) {
+            energy += std::norm(integrate(s));
+        }
+        if (energy > best_energy) {
+            best_energy = energy;
+            best_phase = phase;
+        }
+    }
+    result.timing_phase = best_phase;
+    if (!(config.stages & BATCH_DEMOD)) return;
+
+    std::vector<cf32> symbols;
+    size_t own_begin = 0, own_end = 0;
+    for (size_t s = grid_start(first, best_phase); s + sps <= last; s += sps) {
+        if (s < start) own_begin = symbols.size() + 1;
+        if (s < end) own_end = symbols.size() + 1;
+        symbols.push_back(integrate(s));
+    }
+    if (own_end <= own_begin) return;
+
+    // Фаза несущей и нормировка на единичную мощность
+    cf32 moment = 0;
+    double power = 0;
+    for (const cf32& y : symbols) {
+        cf32 m = y * y;
+        if (order == 4) m *= m;
+        moment += m;
+        power += std::norm(y);
+    }
+    float scale = power > 0 ? static_cast<float>(1.0 / std::sqrt(power / symbols.size())) : 1.0f;
+    cf32 correction = std::polar(scale, -std::arg(moment) / order);
+    for (cf32& y : symbols) y *= correction;
+
+    for (size_t k = own_begin; k < own_end; ++k) {
+        result.error_power += std::norm(symbols[k] - nearest_point(symbols[k], config.modulation));
+    }
+    result.symbols = own_end - own_begin;
+
+    if (!(config.stages & BATCH_BER)) return;
+
+    const size_t bps = order == 2 ? 1 : 2;
+    std::vector<cf32> rotated(symbols.size());
+    std::vector<uint8_t> bits(symbols.size() * bps);
+    for (size_t k = 0; k < order; ++k) {
+        cf32 turn = rotation(k, order);
+        for (size_t i = 0; i < symbols.size(); ++i) rotated[i] = symbols[i] * turn;
+        if (order == 2) bpsk_demap(rotated.data(), rotated.size(), bits.data());
+        else qpsk_demap(rotated.data(), rotated.size(), bits.data());
+
+        BerTester tester(config.prbs);
+        tester.process_bits(bits.data(), own_begin * bps);
+        BerStats warmup = tester.stats();
+        tester.process_bits(bits.data() + own_begin * bps, (own_end - own_begin) * bps);
+        const BerStats& total = tester.stats();
+        if (!total.locked) continue;
+
+        uint64_t checked = total.bits - warmup.bits;
+        uint64_t errors = total.errors - warmup.errors;
+        if (!result.locked || errors * std::max<uint64_t>(result.ber_bits, 1) <
+                                  result.ber_errors * std::max<uint64_t>(checked, 1)) {
+            result.locked = true;
+            result.ber_bits = checked;
+            result.ber_errors = errors;
+        }
+    }
+}
+
+static void process_chunk(const CaptureSource& source, const BatchConfig& config, size_t index,
+                          ChunkResult& result) {
+    auto started = std::chrono::steady_clock::now();
+
+    const size_t start = index * config.chunk_samples;
+    const size_t end = std::min(start + config.chunk_samples, source.samples);
+    const size_t first = start > config.overlap_samples ? start - config.overlap_samples : 0;
+    const size_t last = std::min(end + std::max(config.fft_size, config.samples_per_symbol), source.samples);
+
+    raw_statistics(source.iq + 2 * start, end - start, result);
+
+    if (config.stages & (BATCH_CONDITION | BATCH_SYNC | BATCH_PSD)) {
+        // Буфер потока переиспользуется кусками, которые достались этому потоку
+        static thread_local std::vector<cf32> samples;
+        samples.resize(last - first);
+        if (config.stages & BATCH_CONDITION) {
+            // Коррекция IQ рассчитана на круговой сигнал; BPSK лежит на одной оси,
+            // и оценка дисбаланса приняла бы его за ошибку квадратуры
+            RxConditionerConfig conditioner_config = config.conditioner;
+            if (config.modulation == BatchModulation::BPSK && (config.stages & BATCH_DEMOD)) {
+                conditioner_config.iq_enabled = false;
+            }
+            RxConditioner conditioner(conditioner_config);
+            conditioner.process_cs16(source.iq + 2 * first, samples.data(), samples.size());
+        } else {
+            cs16_to_cf32(source.iq + 2 * first, samples.data(), samples.size());
+        }
+
+        if (config.stages & BATCH_PSD) accumulate_psd(samples.data(), first, start, end, last, config, result);
+        if (config.stages & BATCH_SYNC) demodulate(samples.data(), first, start, end, last, config, result);
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+static void merge_chunks(const std::vector<ChunkResult>& chunks, const BatchConfig& config, CaptureSummary& summary) {
+    const double full_scale = double(CS16_FULL_SCALE) * CS16_FULL_SCALE;
+    double power = 0, peak = 0, dc_i = 0, dc_q = 0, error_power = 0;
+    std::vector<double> psd;
+    size_t psd_frames = 0;
+
+    for (const ChunkResult& chunk : chunks) {
+        summary.samples += chunk.samples;
+        power += chunk.power_sum;
+        peak = std::max(peak, chunk.peak);
+        summary.clipped += chunk.clipped;
+        dc_i += chunk.dc_i;
+        dc_q += chunk.dc_q;
+        summary.symbols += chunk.symbols;
+        error_power += chunk.error_power;
+        summary.ber_bits += chunk.ber_bits;
+        summary.ber_errors += chunk.ber_errors;
+        summary.ber_locked_chunks += chunk.locked;
+        summary.cpu_seconds += chunk.seconds;
+        if (!chunk.psd.empty()) {
+            psd.resize(chunk.psd.size(), 0.0);
+            for (size_t k = 0; k < psd.size(); ++k) psd[k] += chunk.psd[k];
+            psd_frames += chunk.psd_frames;
+        }
+    }
+    summary.chunks = chunks.size();
+    if (!chunks.empty()) summary.timing_phase = chunks[0].timing_phase;
+
+    double samples = std::max<double>(summary.samples, 1);
+    summary.power_dbfs = 10 * std::log10(power / samples / full_scale + 1e-30);
+    summary.peak_dbfs = 10 * std::log10(peak / full_scale + 1e-30);
+    summary.dc = cf32(static_cast<float>(dc_i / samples / CS16_FULL_SCALE),
+                      static_cast<float>(dc_q / samples / CS16_FULL_SCALE));
+    summary.evm_percent = summary.symbols ? 100.0 * std::sqrt(error_power / summary.symbols) : 0.0;
+
+    if (psd_frames == 0) return;
+
+    // Нормировка как у SpectrumEngine: на мощность окна и число кадров; ноль частоты в центр
+    const size_t n = psd.size();
+    double window_power = 0;
+    for (size_t k = 0; k < n; ++k) window_power += std::pow(window_value(Window::Blackman, k, n), 2);
+    std::vector<double> linear(n);
+    for (size_t k = 0; k < n; ++k) linear[k] = psd[(k + n / 2) % n] / (window_power * psd_frames);
+
+    summary.psd_db.resize(n);
+    for (size_t k = 0; k < n; ++k) summary.psd_db[k] = static_cast<float>(10 * std::log10(linear[k] + 1e-30));
+
+    const double bin = config.sample_rate / n;
+    size_t peak_bin = std::max_element(linear.begin(), linear.end()) - linear.begin();
+    summary.peak_frequency = (static_cast<double>(peak_bin) - n / 2) * bin;
+
+    std::vector<float> sorted = summary.psd_db;
+    std::nth_element(sorted.begin(), sorted.begin() + n / 2, sorted.end());
+    summary.noise_floor_db = sorted[n / 2];
+
+    // Полоса 99 %: по 0.5 % мощности отрезается с каждого края
+    double total = 0;
+    for (double p : linear) total += p;
+    double cumulative = 0;
+    size_t low = 0, high = n - 1;
+    for (size_t k = 0; k < n; ++k) {
+        cumulative += linear[k];
+        if (cumulative < 0.005 * total) low = k + 1;
+        if (cumulative <= 0.995 * total) high = k + 1;
+    }
+    summary.occupied_bandwidth = (std::min(high, n - 1) - std::min(low, n - 1) + 1) * bin;
+}
+
+std::vector<CaptureSummary> process_captures(const std::vector<std::string>& paths, const BatchConfig& config,
+                                             WorkPool& pool) {
+    std::vector<CaptureSummary> summaries(paths.size());
+    std::vector<CaptureJob> jobs(paths.size());
+
+    // Задача записи открывает файл и ставит куски в очередь своего потока;
+    // источник живет, пока жив хотя бы один кусок
+    for (size_t i = 0; i < paths.size(); ++i) {
+        summaries[i].path = paths[i];
+        pool.submit([&, i] {
+            auto source = std::make_shared<CaptureSource>();
+            if (!open_source(paths[i], *source)) {
+                summaries[i].error = "не удалось открыть";
+                return;
+            }
+            if (source->samples == 0) {
+                summaries[i].error = "нет отсчетов";
+                return;
+            }
+            size_t chunks = (source->samples + config.chunk_samples - 1) / config.chunk_samples;
+            jobs[i].chunks.resize(chunks);
+            for (size_t k = 0; k < chunks; ++k) {
+                pool.submit([&, i, k, source] { process_chunk(*source, config, k, jobs[i].chunks[k]); });
+            }
+        });
+    }
+    pool.wait();
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (summaries[i].error.empty()) merge_chunks(jobs[i].chunks, config, summaries[i]);
+    }
+    return summaries;
+}
+
+// Хвост пути, помещающийся в width символов
+static std::string short_path(const std::string& path, size_t width) {
+    return path.size() <= width ? path : "..." + path.substr(path.size() - (width - 3));
+}
+
+void print_summary(const std::vector<CaptureSummary>& summaries, const BatchConfig& config) {
+    printf("%-32s %10s %8s %8s %8s %7s %10s %11s %11s %8s\n", "Запись", "Отсчетов", "дБFS", "Пик", "Клип",
+           "EVM,%", "BER", "Пик PSD,Гц", "Полоса,Гц", "мс");
+    for (const CaptureSummary& s : summaries) {
+        if (!s.error.empty()) {
+            printf("%-32s %s\n", short_path(s.path, 32).c_str(), s.error.c_str());
+            continue;
+        }
+        char ber[32] = "-";
+        if (config.stages & BATCH_BER) {
+            if (s.ber_locked_chunks) snprintf(ber, sizeof(ber), "%.2e", s.ber());
+            else snprintf(ber, sizeof(ber), "нет синхр");
+        }
+        printf("%-32s %10llu %8.1f %8.1f %8llu %7.1f %10s %11.0f %11.0f %8.1f\n", short_path(s.path, 32).c_str(),
+               static_cast<unsigned long long>(s.samples), s.power_dbfs, s.peak_dbfs,
+               static_cast<unsigned long long>(s.clipped), s.evm_percent, ber, s.peak_frequency,
+               s.occupied_bandwidth, s.cpu_seconds * 1e3);
+    }
+}
+
+bool write_summary_csv(const std::string& path, const std::vector<CaptureSummary>& summaries,
+                       const BatchConfig& config) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        printf("Не удалось создать файл: %s\n", path.c_str());
+        return false;
+    }
+    fprintf(file, "path,samples,chunks,power_dbfs,peak_dbfs,clipped,dc_i,dc_q,timing_phase,symbols,evm_percent,"
+                  "ber_bits,ber_errors,ber,ber_locked_chunks,peak_frequency_hz,noise_floor_db,"
+                  "occupied_bandwidth_hz,cpu_seconds,sample_rate,error\n");
+    for (const CaptureSummary& s : summaries) {
+        fprintf(file, "\"%s\",%llu,%zu,%.3f,%.3f,%llu,%.6f,%.6f,%zu,%llu,%.3f,%llu,%llu,%.6e,%zu,%.1f,%.2f,%.1f,%.4f,%.0f,%s\n",
+                s.path.c_str(), static_cast<unsigned long long>(s.samples), s.chunks, s.power_dbfs, s.peak_dbfs,
+                static_cast<unsigned long long>(s.clipped), s.dc.real(), s.dc.imag(), s.timing_phase,
+                static_cast<unsigned long long>(s.symbols), s.evm_percent,
+                static_cast<unsigned long long>(s.ber_bits), static_cast<unsigned long long>(s.ber_errors), s.ber(),
+                s.ber_locked_chunks, s.peak_frequency, s.noise_floor_db, s.occupied_bandwidth, s.cpu_seconds,
+                config.sample_rate, s.error.c_str());
+    }
+    return fclose(file) == 0;
+}
+
+bool write_summary_npz(const std::string& path, const std::vector<CaptureSummary>& summaries,
+                       const BatchConfig& config) {
+    const size_t n = config.fft_size;
+    std::vector<float> psd(summaries.size() * n, -300.0f);
+    std::vector<double> power, ber, frequency(n);
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        if (summaries[i].psd_db.size() == n) std::copy(summaries[i].psd_db.begin(), summaries[i].psd_db.end(), &psd[i * n]);
+        power.push_back(summaries[i].power_dbfs);
+        ber.push_back(summaries[i].ber());
+    }
+    for (size_t k = 0; k < n; ++k) frequency[k] = (static_cast<double>(k) - n / 2) * config.sample_rate / n;
+
+    NpzWriter npz;
+    if (!npz.open(path)) return false;
+    bool ok = npz.add("psd_db", psd.data(), {summaries.size(), n}) && npz.add("frequency", frequency.data(), {n}) &&
+              npz.add("power_dbfs", power.data(), {summaries.size()}) && npz.add("ber", ber.data(), {summaries.size()});
+    for (size_t i = 0; i < summaries.size() && ok; ++i) {
+        ok = npz.add_string("path_" + std::to_string(i), summaries[i].path);
+    }
+    return npz.close() && ok;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "batch/work_pool.h"
+#include "conditioning/rx_conditioner.h"
+#include "prbs/prbs.h"
+#include "sub_funcs.h"
+
+// Пакетная обработка записей: каталог received_data.pcm (CS16) и rx_samples.txt
+// ("(I,Q), " из 3-4 практик) проходит цепочку
+//   подготовка -> символьная синхронизация -> демодуляция -> BER по PRBS -> PSD.
+// Каждая запись делится на куски по chunk_samples отсчетов; кусок обрабатывается
+// с разгоном overlap_samples отсчетов перед своим началом (сходятся АРУ, фаза
+// несущей и синхронизация BER-тестера), но в статистику идет только своя часть.
+// Сырые статистики и PSD по кускам совпадают с обработкой записи целиком; EVM и
+// BER - только приближенно: масштаб АРУ и фаза несущей каждого куска заново
+// сходятся на разгоне, а не переходят из предыдущего. Куски ставятся в пул из
+// задачи записи и расходятся по свободным потокам.
+
+enum BatchStage : unsigned {
+    BATCH_CONDITION = 1u << 0,
+    BATCH_SYNC = 1u << 1,
+    BATCH_DEMOD = 1u << 2,
+    BATCH_BER = 1u << 3,
+    BATCH_PSD = 1u << 4,
+};
+
+constexpr unsigned BATCH_ALL_STAGES = BATCH_CONDITION | BATCH_SYNC | BATCH_DEMOD | BATCH_BER | BATCH_PSD;
+
+enum class BatchModulation { BPSK, QPSK };
+
+struct BatchConfig {
+    unsigned stages = BATCH_ALL_STAGES;
+    size_t chunk_samples = 1 << 20;
+    size_t overlap_samples = 1 << 16;
+    double sample_rate = 1e6;
+
+    BatchModulation modulation = BatchModulation::BPSK;
+    size_t samples_per_symbol = 10;
+    PrbsType prbs = PrbsType::PRBS9;
+
+    size_t fft_size = 1024;
+    RxConditionerConfig conditioner;
+};
+
+struct CaptureSummary {
+    std::string path;
+    std::string error;           // пусто - запись обработана
+    uint64_t samples = 0;
+    size_t chunks = 0;
+
+    // Уровни по сырым отсчетам относительно CS16_FULL_SCALE
+    double power_dbfs = 0;
+    double peak_dbfs = 0;
+    uint64_t clipped = 0;
+    cf32 dc;
+
+    // Демодуляция: фаза символьной решетки первого куска, EVM по решениям
+    size_t timing_phase = 0;
+    uint64_t symbols = 0;
+    double evm_percent = 0;
+
+    uint64_t ber_bits = 0;
+    uint64_t ber_errors = 0;
+    size_t ber_locked_chunks = 0;
+
+    // PSD, дБ относительно полной шкалы, частоты от -fs/2 до +fs/2
+    std::vector<float> psd_db;
+    double peak_frequency = 0;
+    double noise_floor_db = 0;
+    double occupied_bandwidth = 0;  // 99 % мощности
+
+    double cpu_seconds = 0;         // сумма времени кусков во всех потоках
+
+    double ber() const { return ber_bits ? double(ber_errors) / ber_bits : 0.0; }
+};
+
+// "cond,sync,demod,ber,psd" или "all"; ber требует demod, demod - sync
+bool parse_batch_stages(const std::string& text, unsigned& stages);
+
+// Записи *.pcm и *.txt в каталоге и подкаталогах (или сам файл), по алфавиту
+std::vector<std::string> find_captures(const std::string& path);
+
+// Текстовая запись: пары "(I,Q)" в любом окружении
+bool load_text_capture(const std::string& path, std::vector<int16_t>& iq);
+
+// Обработка всех записей в пуле; порядок результатов совпадает с paths
+std::vector<CaptureSummary> process_captures(const std::vector<std::string>& paths, const BatchConfig& config,
+                                             WorkPool& pool);
+
+void print_summary(const std::vector<CaptureSummary>& summaries, const BatchConfig& config);
+bool write_summary_csv(const std::string& path, const std::vector<CaptureSummary>& summaries,
+                       const BatchConfig& config);
+// PSD всех записей одной матрицей [записи x fft_size] и ось частот
+bool write_summary_npz(const std::string& path, const std::vector<CaptureSummary>& summaries,
+                       const BatchConfig& config);
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "batch/batch.h"
+#include "fft/fft.h"
+#include "modulation/mapper.h"
+
+// Тестовые записи: BPSK/QPSK с прямоугольными импульсами и PRBS-данными,
+// у каждой свои шум, фаза несущей, DC и задержка; последняя - текстом как в 3-4 практиках
+static bool make_demo_captures(const std::string& directory, size_t files, size_t samples, const BatchConfig& config) {
+    mkdir(directory.c_str(), 0755);
+    std::mt19937 gen(7);
+    const size_t sps = config.samples_per_symbol;
+    const size_t bps = config.modulation == BatchModulation::QPSK ? 2 : 1;
+
+    for (size_t f = 0; f < files; ++f) {
+        size_t symbols_count = samples / sps + 1;
+        std::vector<uint8_t> bits(symbols_count * bps);
+        PrbsGenerator(config.prbs).fill_bits(bits.data(), bits.size());
+        std::vector<cf32> symbols(symbols_count);
+        if (bps == 2) qpsk_map(bits.data(), bits.size(), symbols.data());
+        else bpsk_map(bits.data(), bits.size(), symbols.data());
+
+        double snr_db = 4.0 + 2.0 * f;
+        std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(std::pow(10, -snr_db / 10) / 2)));
+        cf32 turn = std::polar(0.3f, std::uniform_real_distribution<float>(0, 2 * PI)(gen));
+        cf32 dc(0.02f * f, -0.01f * f);
+        size_t delay = std::uniform_int_distribution<size_t>(0, sps - 1)(gen);
+
+        std::vector<cf32> x(samples);
+        for (size_t n = 0; n < samples; ++n) {
+            x[n] = (n >= delay ? symbols[(n - delay) / sps] * turn : cf32()) + 0.3f * cf32(noise(gen), noise(gen)) + dc;
+        }
+        std::vector<int16_t> iq(2 * samples);
+        cf32_to_cs16(x.data(), iq.data(), samples);
+
+        bool text = f + 1 == files;
+        std::string path = directory + "/capture_" + std::to_string(f) + (text ? ".txt" : ".pcm");
+        FILE* file = fopen(path.c_str(), text ? "w" : "wb");
+        if (!file) {
+            printf("Не удалось создать файл: %s\n", path.c_str());
+            return false;
+        }
+        if (text) {
+            for (size_t n = 0; n < samples; ++n) fprintf(file, "(%d,%d), ", iq[2 * n], iq[2 * n + 1]);
+        } else {
+            fwrite(iq.data(), sizeof(int16_t), iq.size(), file);
+        }
+        fclose(file);
+        printf("%s: SNR %.0f дБ, задержка %zu\n", path.c_str(), snr_db, delay);
+    }
+    return true;
+}
+
+// Использование:
+//   batch.out <каталог | файл>... [chain=all] [modulation=bpsk] [sps=10] [prbs=9] [chunk=1048576]
+//             [overlap=65536] [fft=1024] [rate=1e6] [threads=0] [csv=summary.csv] [npz=]
+//   batch.out demo=<каталог> [files=6] [samples=4000000] ... - создать тестовые записи и обработать их
+// chain - этапы через запятую: cond, sync, demod, ber, psd (ber требует demod, demod - sync)
+int main(int argc, char** argv) {
+    BatchConfig config;
+    std::vector<std::string> inputs;
+    std::string csv = "summary.csv";
+    std::string npz;
+    std::string demo;
+    size_t demo_files = 6;
+    size_t demo_samples = 4000000;
+    size_t threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            inputs.push_back(arg);
+            continue;
+        }
+        std::string key = arg.substr(0, eq);
+        const char* value = arg.c_str() + eq + 1;
+        if (key == "chain") {
+            if (!parse_batch_stages(value, config.stages)) {
+                printf("Неверная цепочка: %s\n", value);
+                return -1;
+            }
+        } else if (key == "modulation") {
+            config.modulation = std::string(value) == "qpsk" ? BatchModulation::QPSK : BatchModulation::BPSK;
+        } else if (key == "sps") config.samples_per_symbol = strtoul(value, nullptr, 10);
+        else if (key == "prbs") config.prbs = prbs_type_from_order(atoi(value));
+        else if (key == "chunk") config.chunk_samples = strtoul(value, nullptr, 10);
+        else if (key == "overlap") config.overlap_samples = strtoul(value, nullptr, 10);
+        else if (key == "fft") config.fft_size = strtoul(value, nullptr, 10);
+        else if (key == "rate") config.sample_rate = atof(value);
+        else if (key == "threads") threads = strtoul(value, nullptr, 10);
+        else if (key == "csv") csv = value;
+        else if (key == "npz") npz = value;
+        else if (key == "demo") demo = value;
+        else if (key == "files") demo_files = strtoul(value, nullptr, 10);
+        else if (key == "samples") demo_samples = strtoul(value, nullptr, 10);
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (config.samples_per_symbol == 0 || config.chunk_samples == 0 || !is_power_of_two(config.fft_size) ||
+        config.fft_size < 2) {
+        printf("sps > 0, chunk > 0, fft - степень двойки\n");
+        return -1;
+    }
+
+    if (!demo.empty()) {
+        if (!make_demo_captures(demo, demo_files, demo_samples, config)) return -1;
+        inputs.push_back(demo);
+    }
+    if (inputs.empty()) {
+        printf("Укажите каталог или файлы записей (или demo=<каталог>)\n");
+        return -1;
+    }
+
+    std::vector<std::string> paths;
+    for (const std::string& input : inputs) {
+        std::vector<std::string> found = find_captures(input);
+        paths.insert(paths.end(), found.begin(), found.end());
+    }
+    if (paths.empty()) {
+        printf("Записей *.pcm / *.txt не найдено\n");
+        return -1;
+    }
+
+    WorkPool pool(threads);
+    printf("Записей: %zu, потоков: %zu, кусок %zu отсчетов + разгон %zu\n", paths.size(), pool.threads_count(),
+           config.chunk_samples, config.overlap_samples);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CaptureSummary> summaries = process_captures(paths, config, pool);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    print_summary(summaries, config);
+
+    uint64_t samples = 0;
+    double cpu_seconds = 0;
+    for (const CaptureSummary& s : summaries) {
+        samples += s.samples;
+        cpu_seconds += s.cpu_seconds;
+    }
+    printf("Итого %.1f Мотсч за %.2f с (%.1f Мотсч/с), загрузка %.1f потока, перехватов задач: %llu\n",
+           samples / 1e6, seconds, samples / seconds / 1e6, cpu_seconds / seconds,
+           static_cast<unsigned long long>(pool.steals()));
+
+    if (!csv.empty() && write_summary_csv(csv, summaries, config)) printf("Таблица: %s\n", csv.c_str());
+    if (!npz.empty() && write_summary_npz(npz, summaries, config)) printf("PSD: %s\n", npz.c_str());
+    return 0;
+}
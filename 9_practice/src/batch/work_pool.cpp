@@ -0,0 +1,93 @@
+#include "batch/work_pool.h"
+
+// Пул и номер очереди текущего потока (nullptr - поток не из пула)
+static thread_local WorkPool* current_pool = nullptr;
+static thread_local size_t current_lane = 0;
+
+static size_t default_threads(size_t threads_count) {
+    if (threads_count) return threads_count;
+    size_t cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+WorkPool::WorkPool(size_t threads_count) : lanes(default_threads(threads_count)) {
+    for (size_t index = 0; index < lanes.size(); ++index) {
+        lanes[index].thread = std::thread(&WorkPool::worker, this, index);
+    }
+}
+
+WorkPool::~WorkPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    for (Lane& lane : lanes) lane.thread.join();
+}
+
+void WorkPool::submit(Task task) {
+    size_t index = current_pool == this ? current_lane : next_lane++ % lanes.size();
+    ++pending;
+    // queued увеличивается до того, как задача появится в очереди, и под sleep_mutex:
+    // счетчик не уходит в минус, а поток не уснет между проверкой условия и notify
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        ++queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lanes[index].mutex);
+        lanes[index].tasks.push_back(std::move(task));
+    }
+    wakeup.notify_one();
+}
+
+void WorkPool::wait() {
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    idle.wait(lock, [&] { return pending == 0; });
+}
+
+bool WorkPool::pop_own(size_t index, Task& task) {
+    Lane& lane = lanes[index];
+    std::lock_guard<std::mutex> lock(lane.mutex);
+    if (lane.tasks.empty()) return false;
+    task = std::move(lane.tasks.back());
+    lane.tasks.pop_back();
+    return true;
+}
+
+bool WorkPool::steal(size_t index, Task& task) {
+    for (size_t offset = 1; offset < lanes.size(); ++offset) {
+        Lane& lane = lanes[(index + offset) % lanes.size()];
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        if (lane.tasks.empty()) continue;
+        task = std::move(lane.tasks.front());
+        lane.tasks.pop_front();
+        ++steal_count;
+        return true;
+    }
+    return false;
+}
+
+void WorkPool::worker(size_t index) {
+    current_pool = this;
+    current_lane = index;
+
+    while (true) {
+        Task task;
+        if (pop_own(index, task) || steal(index, task)) {
+            --queued;
+            task();
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wakeup.wait(lock, [&] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
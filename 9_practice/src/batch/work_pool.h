@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing).
+// У каждого потока своя очередь: задачи, поставленные из рабочего потока, кладутся
+// в его же очередь и берутся с конца (последняя поставленная - еще в кэше).
+// Свободный поток забирает задачи с начала чужих очередей - самые крупные, поставленные
+// раньше всех. Задачи извне раздаются по очередям по кругу.
+class WorkPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads_count = 0 - по числу ядер
+    explicit WorkPool(size_t threads_count = 0);
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    size_t threads_count() const { return lanes.size(); }
+
+    // Можно вызывать из задач: так крупная задача делится на части
+    void submit(Task task);
+
+    // Дожидается выполнения всех задач, включая поставленные из задач
+    void wait();
+
+    uint64_t steals() const { return steal_count; }
+
+private:
+    struct Lane {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    bool pop_own(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+    void worker(size_t index);
+
+    std::vector<Lane> lanes;
+
+    // Сон и ожидание: queued - задач в очередях, pending - еще не выполненных
+    std::mutex sleep_mutex;
+    std::condition_variable wakeup;
+    std::condition_variable idle;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> next_lane{0};
+    std::atomic<uint64_t> steal_count{0};
+    bool stopping = false;
+};
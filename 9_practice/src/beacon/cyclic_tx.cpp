@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "beacon/cyclic_tx.h"
+#include "nco/nco.h"
+
+// Отставание от часов, после которого передача считается прерванной
+constexpr double CYCLIC_LAG_TOLERANCE = 0.002;
+
+CyclicTransmitter::CyclicTransmitter(TxStream& stream, const CyclicConfig& config)
+    : stream(stream), config(config) {}
+
+CyclicTransmitter::~CyclicTransmitter() {
+    stop();
+}
+
+void CyclicTransmitter::load(const cf32* waveform, size_t samples_count, float scale) {
+    std::vector<cf32> period_signal(samples_count + config.gap_samples);
+    for (size_t n = 0; n < samples_count; ++n) period_signal[n] = waveform[n] * scale;
+    build_cache(period_signal);
+}
+
+void CyclicTransmitter::load_cs16(const int16_t* iq, size_t samples_count) {
+    std::vector<cf32> period_signal(samples_count + config.gap_samples);
+    cs16_to_cf32(iq, period_signal.data(), samples_count);
+    build_cache(period_signal);
+}
+
+void CyclicTransmitter::build_cache(std::vector<cf32>& period_signal) {
+    period = period_signal.size();
+    if (period == 0) return;
+
+    // Целое число оборотов фазы за период: f = round(f * N / fs) * fs / N
+    applied_offset = 0.0;
+    if (config.frequency_offset != 0.0) {
+        double cycles = std::round(config.frequency_offset * period / config.sample_rate);
+        applied_offset = cycles * config.sample_rate / period;
+        Nco nco(config.sample_rate, applied_offset);
+        nco.mix(period_signal.data(), period_signal.data(), period);
+    }
+
+    // Период и его начало длиной mtu: окно с любого места периода непрерывно
+    size_t mtu = stream.mtu();
+    cache.resize(2 * (period + mtu));
+    cf32_to_cs16(period_signal.data(), cache.data(), period);
+    for (size_t n = 0; n < mtu; ++n) {
+        size_t source = n % period;
+        cache[2 * (period + n)] = cache[2 * source];
+        cache[2 * (period + n) + 1] = cache[2 * source + 1];
+    }
+}
+
+void CyclicTransmitter::start() {
+    if (active || period == 0) return;
+    active = true;
+    worker = std::thread(&CyclicTransmitter::transmit_loop, this);
+}
+
+void CyclicTransmitter::stop() {
+    active = false;
+    if (worker.joinable()) worker.join();
+}
+
+CyclicStats CyclicTransmitter::stats() const {
+    CyclicStats result;
+    result.samples_sent = samples_sent;
+    result.samples_skipped = samples_skipped;
+    result.underflows = underflows;
+    result.repeats = period ? (result.samples_sent + result.samples_skipped) / period : 0;
+    return result;
+}
+
+// Сколько отсчетов пропустить, чтобы вернуться на сетку после паузы lag_seconds
+size_t CyclicTransmitter::skip_to_schedule(double lag_seconds) {
+    underflows++;
+    size_t skip = static_cast<size_t>(std::ceil((lag_seconds + CYCLIC_LAG_TOLERANCE) * config.sample_rate));
+    samples_skipped += skip;
+    return skip;
+}
+
+void CyclicTransmitter::transmit_loop() {
+    const size_t mtu = stream.mtu();
+    const bool timed = config.start_time_ns != 0;
+
+    size_t position = 0;       // смещение в периоде
+    uint64_t stream_samples = 0;  // отсчетов на временной оси с начала передачи
+    int flags = timed ? STREAM_HAS_TIME : 0;
+    auto wall_start = std::chrono::steady_clock::now();
+
+    const uint64_t total = config.repeats * period;
+
+    while (active) {
+        size_t count = mtu;
+        if (total) {
+            if (stream_samples >= total) break;
+            count = static_cast<size_t>(std::min<uint64_t>(mtu, total - stream_samples));
+        }
+
+        long long time_ns = config.start_time_ns + static_cast<long long>(stream_samples * 1e9 / config.sample_rate);
+        long result = stream.write(&cache[2 * position], count, time_ns, flags, config.timeout_us);
+        if (result < 0) {
+            printf("Ошибка передачи: %ld\n", result);
+            break;
+        }
+        if (result == 0) continue;
+
+        flags = 0;
+        samples_sent += result;
+        stream_samples += result;
+        position = (position + result) % period;
+
+        // Опустошение: по статусу устройства или по отставанию потока от часов.
+        // С меткой времени разрыв - от места сетки, где продолжится передача, до события
+        bool late = false;
+        double lag = 0.0;
+        long long event_time = 0;
+        if (stream.poll_underflow(&event_time, 0)) {
+            late = true;
+            double next_time = config.start_time_ns + stream_samples * 1e9 / config.sample_rate;
+            if (timed && event_time > next_time) lag = (event_time - next_time) * 1e-9;
+        }
+
+        // С меткой времени первый отсчет ждет start_time_ns на устройстве, и часы хоста
+        // с ним не связаны: отставание видно только по статусу устройства
+        if (!timed) {
+            double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+            double stream_time = stream_samples / config.sample_rate;
+            if (stream_time + CYCLIC_LAG_TOLERANCE < wall) {
+                late = true;
+                lag = std::max(lag, wall - stream_time);
+            }
+        }
+
+        if (late) {
+            size_t skip = skip_to_schedule(lag);
+            stream_samples += skip;
+            position = (position + skip) % period;
+            printf("Опустошение буфера TX: пропущено %.2f мс, продолжение по сетке периодов\n",
+                   skip * 1e3 / config.sample_rate);
+            if (timed) flags = STREAM_HAS_TIME;
+        }
+    }
+    active = false;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "sdr/device.h"
+
+// Непрерывная циклическая передача: сигнал модулируется один раз и кладется в кэш
+// вместе с паузой, дальше поток передачи только отдает окна кэша в writeStream.
+// Кэш - период (сигнал + пауза) и еще mtu отсчетов его начала, поэтому любое окно
+// из mtu отсчетов лежит в памяти подряд и копировать на стыке периодов ничего не нужно.
+//
+// Непрерывность: первый буфер уходит с меткой времени, следующие - встык.
+// Сдвиг частоты округляется до целого числа периодов несущей на период передачи,
+// тогда фаза на стыке повторов не скачет. При опустошении буфера (сообщение
+// устройства, без метки времени - еще и отставание от часов) передача перескакивает
+// на текущее место сетки периодов и продолжается с новой меткой времени, так что
+// сетка не смещается.
+
+struct CyclicConfig {
+    double sample_rate = 1000000;
+    size_t gap_samples = 0;          // пауза между повторами
+    double frequency_offset = 0.0;   // сдвиг частоты в полосе, Гц
+    long long start_time_ns = 0;     // время первого отсчета; 0 - без метки времени
+    uint64_t repeats = 0;            // 0 - до stop()
+    long timeout_us = 100000;
+};
+
+struct CyclicStats {
+    uint64_t samples_sent = 0;
+    uint64_t repeats = 0;
+    uint64_t underflows = 0;
+    uint64_t samples_skipped = 0;    // отсчеты, пропущенные из-за опустошения
+};
+
+class CyclicTransmitter {
+public:
+    CyclicTransmitter(TxStream& stream, const CyclicConfig& config);
+    ~CyclicTransmitter();
+
+    CyclicTransmitter(const CyclicTransmitter&) = delete;
+    CyclicTransmitter& operator=(const CyclicTransmitter&) = delete;
+
+    // Один раз перед start(): сигнал в полной шкале [-1, 1) или уже в CS16
+    void load(const cf32* waveform, size_t samples_count, float scale = 1.0f);
+    void load_cs16(const int16_t* iq, size_t samples_count);
+
+    // Фактический сдвиг частоты после округления
+    double frequency_offset() const { return applied_offset; }
+    size_t period_samples() const { return period; }
+
+    void start();
+    void stop();
+    bool running() const { return active; }
+
+    CyclicStats stats() const;
+
+private:
+    void build_cache(std::vector<cf32>& period_signal);
+    void transmit_loop();
+    size_t skip_to_schedule(double lag_seconds);
+
+    TxStream& stream;
+    CyclicConfig config;
+    double applied_offset = 0.0;
+
+    std::vector<int16_t> cache;
+    size_t period = 0;
+
+    std::thread worker;
+    std::atomic<bool> active{false};
+
+    std::atomic<uint64_t> samples_sent{0};
+    std::atomic<uint64_t> underflows{0};
+    std::atomic<uint64_t> samples_skipped{0};
+};
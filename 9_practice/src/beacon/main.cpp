@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "beacon/cyclic_tx.h"
+#include "modulation/mapper.h"
+#include "pulse/pulse_shape.h"
+
+constexpr size_t BEACON_SPS = 8;
+using BeaconPulse = PulseShaper<PulseType::RaisedCosine, BEACON_SPS, 6, 35>;
+
+// Строка -> биты, старший бит символа первым (как stob в 3-4 практиках)
+static std::vector<uint8_t> message_bits(const std::string& message) {
+    std::vector<uint8_t> bits;
+    for (unsigned char c : message) {
+        for (int j = 7; j >= 0; --j) bits.push_back((c >> j) & 1);
+    }
+    return bits;
+}
+
+// Использование: beacon.out [message=...] [mod=bpsk|qpsk] [gap=1000] [offset=0] [repeats=0]
+//                           [seconds=10] backend=... uri=... [tx_gain=...]
+int main(int argc, char** argv) {
+    DeviceConfig device_config;
+    CyclicConfig config;
+    std::string message = "Hello My Beuatiful World";
+    std::string modulation = "bpsk";
+    double seconds = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "message") message = value;
+        else if (key == "mod") modulation = value;
+        else if (key == "gap") config.gap_samples = strtoul(value, nullptr, 10);
+        else if (key == "offset") config.frequency_offset = atof(value);
+        else if (key == "repeats") config.repeats = strtoull(value, nullptr, 10);
+        else if (key == "seconds") seconds = atof(value);
+        else if (!parse_device_arg(arg, device_config)) {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    config.sample_rate = device_config.sample_rate;
+
+    // Модуляция один раз: биты -> символы -> импульсы приподнятого косинуса
+    std::vector<uint8_t> bits = message_bits(message);
+    if (modulation == "qpsk" && bits.size() % 2) bits.push_back(0);
+    size_t symbols_count = modulation == "qpsk" ? bits.size() / 2 : bits.size();
+    std::vector<cf32> symbols(symbols_count);
+    if (modulation == "qpsk") qpsk_map(bits.data(), bits.size(), symbols.data());
+    else bpsk_map(bits.data(), bits.size(), symbols.data());
+
+    std::vector<cf32> waveform(BeaconPulse::output_length(symbols_count));
+    BeaconPulse::shape(symbols.data(), symbols_count, waveform.data(), waveform.size());
+
+    std::unique_ptr<Device> device = make_device(device_config);
+    if (!device) return -1;
+    std::unique_ptr<TxStream> tx = device->open_tx();
+    if (!tx) {
+        printf("Не удалось открыть поток передачи\n");
+        return -1;
+    }
+
+    CyclicTransmitter transmitter(*tx, config);
+    // Запас по амплитуде на выбросы приподнятого косинуса
+    transmitter.load(waveform.data(), waveform.size(), 0.5f);
+    printf("Период %zu отсчетов (%.3f мс), сдвиг частоты %.1f Гц\n", transmitter.period_samples(),
+           transmitter.period_samples() * 1e3 / config.sample_rate, transmitter.frequency_offset());
+
+    auto start = std::chrono::steady_clock::now();
+    transmitter.start();
+    while (transmitter.running() &&
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    transmitter.stop();
+
+    CyclicStats stats = transmitter.stats();
+    printf("Передано %llu отсчетов, повторов %llu, опустошений %llu (пропущено %llu отсчетов)\n",
+           (unsigned long long)stats.samples_sent, (unsigned long long)stats.repeats,
+           (unsigned long long)stats.underflows, (unsigned long long)stats.samples_skipped);
+    return 0;
+}
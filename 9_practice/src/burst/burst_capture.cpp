@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+
+#include "burst/burst_capture.h"
+
+// Средняя мощность шага в долях полной шкалы; независимые суммы векторизуются
+static float step_mean_power(const int16_t* iq) {
+    constexpr size_t LANES = 8;
+    float acc[LANES] = {};
+    for (size_t n = 0; n < 2 * BURST_STEP; n += LANES) {
+        for (size_t l = 0; l < LANES; ++l) {
+            float v = iq[n + l];
+            acc[l] += v * v;
+        }
+    }
+    float sum = 0;
+    for (size_t l = 0; l < LANES; ++l) sum += acc[l];
+    return sum / (BURST_STEP * CS16_FULL_SCALE * CS16_FULL_SCALE);
+}
+
+static float to_db(float power) {
+    return 10.0f * std::log10(power + 1e-20f);
+}
+
+BurstCapture::BurstCapture(const BurstConfig& config, double sample_rate)
+    : config(config), sample_rate(sample_rate), history(2 * config.pre_trigger),
+      step_power(std::max<size_t>(1, config.window_steps), 0.0f) {
+    pending.reserve(2 * BURST_STEP);
+}
+
+BurstCapture::~BurstCapture() {
+    close();
+}
+
+bool BurstCapture::open(const std::string& prefix) {
+    close();
+    data_file = fopen((prefix + ".pcm").c_str(), "wb");
+    index_file = fopen((prefix + ".idx").c_str(), "w");
+    if (!data_file || !index_file) {
+        printf("Не удалось создать файлы %s.pcm / %s.idx\n", prefix.c_str(), prefix.c_str());
+        close();
+        return false;
+    }
+    fprintf(index_file, "# first_sample time_ns file_offset length peak_dbfs noise_dbfs\n");
+    return true;
+}
+
+void BurstCapture::close() {
+    if (in_burst) end_burst();
+    if (data_file) fclose(data_file);
+    if (index_file) fclose(index_file);
+    data_file = nullptr;
+    index_file = nullptr;
+}
+
+void BurstCapture::push_history(const int16_t* iq, size_t samples_count) {
+    size_t capacity = config.pre_trigger;
+    if (capacity == 0) return;
+    for (size_t n = 0; n < samples_count; ++n) {
+        history[2 * history_pos] = iq[2 * n];
+        history[2 * history_pos + 1] = iq[2 * n + 1];
+        history_pos = (history_pos + 1) % capacity;
+    }
+    history_fill = std::min(capacity, history_fill + samples_count);
+}
+
+void BurstCapture::process_cs16(const int16_t* iq, size_t samples_count, long long time_ns) {
+    double ns_per_sample = 1e9 / sample_rate;
+    size_t pos = 0;
+
+    // Сначала дополняем шаг, оставшийся с прошлого вызова
+    if (!pending.empty()) {
+        size_t need = BURST_STEP - pending.size() / 2;
+        size_t take = std::min(need, samples_count);
+        pending.insert(pending.end(), iq, iq + 2 * take);
+        pos = take;
+        if (pending.size() == 2 * BURST_STEP) {
+            process_step(pending.data(), pending_time_ns);
+            pending.clear();
+        }
+    }
+
+    for (; pos + BURST_STEP <= samples_count; pos += BURST_STEP) {
+        process_step(iq + 2 * pos, time_ns + static_cast<long long>(pos * ns_per_sample));
+    }
+
+    if (pos < samples_count) {
+        pending.assign(iq + 2 * pos, iq + 2 * samples_count);
+        pending_time_ns = time_ns + static_cast<long long>(pos * ns_per_sample);
+    }
+}
+
+void BurstCapture::process_step(const int16_t* iq, long long time_ns) {
+    float power = step_mean_power(iq);
+
+    // Скользящее окно: вычитаем вытесняемый шаг, добавляем новый
+    window_sum += power - step_power[step_pos];
+    step_power[step_pos] = power;
+    step_pos = (step_pos + 1) % step_power.size();
+    steps_seen++;
+    if (step_pos == 0) {
+        // Пересчет суммы на каждом обороте, чтобы не копилась ошибка округления
+        window_sum = 0;
+        for (float p : step_power) window_sum += p;
+    }
+    float window_db = to_db(std::max(0.0f, window_sum) / step_power.size());
+
+    if (steps_seen <= step_power.size()) {
+        // Окно еще не заполнено: только оцениваем шум
+        noise_db = window_db;
+        push_history(iq, BURST_STEP);
+        samples_seen += BURST_STEP;
+        return;
+    }
+
+    if (!in_burst) {
+        if (window_db > noise_db + config.threshold_db) {
+            begin_burst(time_ns);
+        } else {
+            // Шум отслеживается только вне всплесков, вниз - быстрее, чем вверх
+            float k = window_db < noise_db ? 0.1f : 1.0f / static_cast<float>(config.noise_time_constant);
+            noise_db += k * (window_db - noise_db);
+            push_history(iq, BURST_STEP);
+            samples_seen += BURST_STEP;
+            return;
+        }
+    }
+
+    if (data_file) fwrite(iq, sizeof(int16_t), 2 * BURST_STEP, data_file);
+    samples_written += BURST_STEP;
+    current.length += BURST_STEP;
+    current.peak_dbfs = std::max(current.peak_dbfs, to_db(power));
+    samples_seen += BURST_STEP;
+
+    if (window_db < noise_db + config.threshold_db - config.hysteresis_db) quiet_samples += BURST_STEP;
+    else quiet_samples = 0;
+
+    if (quiet_samples >= config.hangover) {
+        end_burst();
+    } else if (current.length >= config.max_burst) {
+        // Продолжение длинного всплеска пишется новой записью без истории
+        end_burst();
+        in_burst = true;
+        current = BurstRecord{samples_seen, time_ns + static_cast<long long>(BURST_STEP * 1e9 / sample_rate),
+                              samples_written, 0, -200.0f, noise_db};
+    }
+}
+
+void BurstCapture::begin_burst(long long time_ns) {
+    in_burst = true;
+    quiet_samples = 0;
+
+    // История пишется от самого старого отсчета: две части кольца
+    size_t start = (history_pos + config.pre_trigger - history_fill) % std::max<size_t>(1, config.pre_trigger);
+    size_t first_part = std::min(history_fill, config.pre_trigger - start);
+    if (history_fill && data_file) {
+        fwrite(&history[2 * start], sizeof(int16_t), 2 * first_part, data_file);
+        fwrite(&history[0], sizeof(int16_t), 2 * (history_fill - first_part), data_file);
+    }
+
+    current.first_sample = samples_seen - history_fill;
+    current.time_ns = time_ns - static_cast<long long>(history_fill * 1e9 / sample_rate);
+    current.file_offset = samples_written;
+    current.length = history_fill;
+    current.peak_dbfs = -200.0f;
+    current.noise_dbfs = noise_db;
+
+    samples_written += history_fill;
+    history_fill = 0;
+}
+
+void BurstCapture::end_burst() {
+    in_burst = false;
+    records.push_back(current);
+    if (index_file) {
+        fprintf(index_file, "%llu %lld %llu %llu %.1f %.1f\n", (unsigned long long)current.first_sample,
+                current.time_ns, (unsigned long long)current.file_offset, (unsigned long long)current.length,
+                current.peak_dbfs, current.noise_dbfs);
+        fflush(index_file);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Запись только всплесков активности вместо непрерывного потока.
+// Мощность считается по шагам BURST_STEP отсчетов и усредняется скользящим окном
+// из нескольких шагов. Всплеск начинается, когда средняя мощность превышает
+// уровень шума на threshold_db, и заканчивается, когда она держится ниже
+// threshold_db - hysteresis_db дольше hangover отсчетов. Перед началом всплеска
+// в файл попадает история из кольцевого буфера pre_trigger отсчетов.
+constexpr size_t BURST_STEP = 64;
+
+struct BurstConfig {
+    size_t window_steps = 4;          // окно усреднения мощности, в шагах
+    double threshold_db = 10.0;       // порог включения над уровнем шума
+    double hysteresis_db = 3.0;
+    size_t pre_trigger = 4096;        // отсчетов истории до срабатывания
+    size_t hangover = 2048;           // отсчетов тишины до конца всплеска
+    size_t max_burst = 1 << 24;       // длинные всплески режутся на части
+    double noise_time_constant = 200; // сглаживание уровня шума, в шагах
+};
+
+// Запись индекса: где в файле данных лежит всплеск и когда он был принят
+struct BurstRecord {
+    uint64_t first_sample;  // номер первого отсчета в исходном потоке
+    long long time_ns;      // время первого отсчета
+    uint64_t file_offset;   // смещение в файле данных, в отсчетах
+    uint64_t length;        // длина в отсчетах
+    float peak_dbfs;
+    float noise_dbfs;
+};
+
+class BurstCapture {
+public:
+    BurstCapture(const BurstConfig& config, double sample_rate);
+    ~BurstCapture();
+
+    BurstCapture(const BurstCapture&) = delete;
+    BurstCapture& operator=(const BurstCapture&) = delete;
+
+    // Создает <prefix>.pcm (CS16 всплесков подряд) и <prefix>.idx (текстовый индекс)
+    bool open(const std::string& prefix);
+    // Закрывает незаконченный всплеск и файлы
+    void close();
+
+    // time_ns - время первого отсчета блока (время устройства или системное)
+    void process_cs16(const int16_t* iq, size_t samples_count, long long time_ns);
+
+    const std::vector<BurstRecord>& bursts() const { return records; }
+    bool active() const { return in_burst; }
+    float noise_dbfs() const { return noise_db; }
+
+private:
+    void process_step(const int16_t* iq, long long time_ns);
+    void begin_burst(long long time_ns);
+    void end_burst();
+    void push_history(const int16_t* iq, size_t samples_count);
+
+    BurstConfig config;
+    double sample_rate;
+
+    FILE* data_file = nullptr;
+    FILE* index_file = nullptr;
+
+    // Кольцевая история CS16
+    std::vector<int16_t> history;
+    size_t history_pos = 0;
+    size_t history_fill = 0;
+
+    // Мощности последних шагов для скользящего окна
+    std::vector<float> step_power;
+    size_t step_pos = 0;
+    size_t steps_seen = 0;
+    float window_sum = 0;
+
+    // Неполный шаг между вызовами
+    std::vector<int16_t> pending;
+    long long pending_time_ns = 0;
+
+    float noise_db = 0;
+    bool in_burst = false;
+    size_t quiet_samples = 0;
+    uint64_t samples_seen = 0;
+    uint64_t samples_written = 0;
+
+    BurstRecord current;
+    std::vector<BurstRecord> records;
+};
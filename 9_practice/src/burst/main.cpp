@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "burst/burst_capture.h"
+#include "capture/capture_file.h"
+#include "sdr/device.h"
+
+// Использование:
+//   burst.out input=<capture.pcm> [out=bursts] [threshold=10] [pre=4096] [hangover=2048] [sample_rate=1e6]
+//   burst.out backend=soapy|iio|file uri=... [seconds=10] [out=bursts] [...]
+int main(int argc, char** argv) {
+    DeviceConfig device_config;
+    BurstConfig config;
+    std::string input;
+    std::string out = "bursts";
+    double seconds = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "input") input = value;
+        else if (key == "out") out = value;
+        else if (key == "seconds") seconds = atof(value);
+        else if (key == "threshold") config.threshold_db = atof(value);
+        else if (key == "hysteresis") config.hysteresis_db = atof(value);
+        else if (key == "pre") config.pre_trigger = strtoul(value, nullptr, 10);
+        else if (key == "hangover") config.hangover = strtoul(value, nullptr, 10);
+        else if (!parse_device_arg(arg, device_config)) {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    BurstCapture capture(config, device_config.sample_rate);
+    if (!capture.open(out)) return -1;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+
+    if (!input.empty()) {
+        CaptureFile file;
+        if (!file.open(input)) return -1;
+        capture.process_cs16(file.data(), file.samples_count(), 0);
+        total = file.samples_count();
+    } else {
+        std::unique_ptr<Device> device = make_device(device_config);
+        if (!device) return -1;
+        std::unique_ptr<RxStream> rx = device->open_rx();
+        if (!rx) return -1;
+
+        std::vector<int16_t> buffer(rx->mtu() * 2);
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+            long long time_ns = 0;
+            int flags = 0;
+            long n = rx->read(buffer.data(), rx->mtu(), &time_ns, &flags, 100000);
+            if (n < 0) break;
+            if (n == 0) continue;
+            // Без аппаратной метки - системное время приема
+            if (!(flags & STREAM_HAS_TIME)) {
+                time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            }
+            capture.process_cs16(buffer.data(), n, time_ns);
+            total += n;
+        }
+    }
+    capture.close();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t kept = 0;
+    for (const BurstRecord& r : capture.bursts()) kept += r.length;
+    printf("Обработано %llu отсчетов (%.1f Мотсч/с), всплесков %zu, записано %llu отсчетов (%.2f%%)\n",
+           (unsigned long long)total, total / elapsed / 1e6, capture.bursts().size(),
+           (unsigned long long)kept, total ? 100.0 * kept / total : 0.0);
+    printf("Уровень шума %.1f дБFS, индекс: %s.idx\n", capture.noise_dbfs(), out.c_str());
+    return 0;
+}
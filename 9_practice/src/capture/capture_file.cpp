@@ -0,0 +1,52 @@
+#include "capture/capture_file.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CaptureFile::~CaptureFile() {
+    close();
+}
+
+bool CaptureFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        printf("Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        printf("Пустой или недоступный файл: %s\n", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        printf("Ошибка mmap: %s\n", path.c_str());
+        return false;
+    }
+
+    // Читаем последовательно: подсказываем ядру читать наперед
+    madvise(address, info.st_size, MADV_SEQUENTIAL);
+
+    mapping = address;
+    mapping_size = info.st_size;
+    file_path = path;
+    return true;
+}
+
+void CaptureFile::close() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+        mapping_size = 0;
+    }
+}
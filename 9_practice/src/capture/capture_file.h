@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+#include "sub_funcs.h"
+
+// Запись CS16 (I, Q, I, Q, ...), отображенная в память через mmap.
+// Файл не читается целиком: страницы подгружаются ядром по мере обращения.
+class CaptureFile {
+public:
+    CaptureFile() = default;
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return mapping != nullptr; }
+    const int16_t* data() const { return static_cast<const int16_t*>(mapping); }
+
+    // Количество комплексных отсчетов (пар I/Q)
+    size_t samples_count() const { return mapping_size / (2 * sizeof(int16_t)); }
+
+    const std::string& path() const { return file_path; }
+
+private:
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::string file_path;
+};
@@ -0,0 +1,157 @@
+#include "channelizer/channelizer.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "filter/fir.h"
+
+Channelizer::Channelizer(const ChannelizerConfig& config)
+    : config(config),
+      filter_length(config.channels_count * config.taps_per_branch),
+      frame_step(config.channels_count / (config.oversampling ? config.oversampling : 1)),
+      plan(config.channels_count, true) {
+    size_t n = config.channels_count;
+
+    if (config.oversampling == 0 || n % config.oversampling != 0 || config.taps_per_branch == 0) {
+        throw std::invalid_argument("Неверные параметры банка фильтров");
+    }
+
+    // Прототип: ФНЧ с полосой одного канала
+    std::vector<float> prototype = design_lowpass(filter_length, 0.5 / n, Window::Blackman);
+
+    // Ветвь p отвечает за коэффициенты h[k + p*N]; храним их в порядке возрастания
+    // адреса в истории, чтобы внутренний цикл шел подряд по памяти
+    branch_taps.assign(config.taps_per_branch, std::vector<float>(2 * n));
+    for (size_t p = 0; p < config.taps_per_branch; ++p) {
+        for (size_t j = 0; j < n; ++j) {
+            float tap = prototype[n - 1 - j + p * n];
+            branch_taps[p][2 * j] = tap;
+            branch_taps[p][2 * j + 1] = tap;
+        }
+    }
+
+    history.assign(filter_length - 1, cf32(0.0f, 0.0f));
+    next_frame_end = filter_length - 1 + frame_step - 1;
+    accumulator.resize(2 * n);
+    fft_buffer.resize(n);
+}
+
+double Channelizer::channel_frequency(size_t channel, double sample_rate) const {
+    size_t n = config.channels_count;
+    double index = channel < n / 2 ? double(channel) : double(channel) - n;
+    return index * sample_rate / n;
+}
+
+void Channelizer::process(const cf32* in, size_t samples_count, std::vector<std::vector<cf32>>& out) {
+    out.resize(config.channels_count);
+    history.insert(history.end(), in, in + samples_count);
+
+    while (next_frame_end < history.size()) {
+        run_frame(next_frame_end, out);
+        next_frame_end += frame_step;
+    }
+
+    // Оставляем только то, что понадобится следующему кадру
+    size_t keep_from = next_frame_end + 1 - filter_length;
+    history.erase(history.begin(), history.begin() + keep_from);
+    next_frame_end -= keep_from;
+}
+
+void Channelizer::process_cs16(const int16_t* iq, size_t samples_count, std::vector<std::vector<cf32>>& out) {
+    convert_buffer.resize(samples_count);
+    cs16_to_cf32(iq, convert_buffer.data(), samples_count);
+    process(convert_buffer.data(), samples_count, out);
+}
+
+void Channelizer::run_frame(size_t newest, std::vector<std::vector<cf32>>& out) {
+    size_t n = config.channels_count;
+    const float* samples = reinterpret_cast<const float*>(history.data());
+    float* acc = accumulator.data();
+
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+
+    // Свертка по ветвям: acc[j] = sum_p h_p[j] * x[newest - p*N - (N-1) + j]
+    for (size_t p = 0; p < config.taps_per_branch; ++p) {
+        const float* segment = samples + 2 * (newest - p * n - (n - 1));
+        const float* taps = branch_taps[p].data();
+
+        for (size_t i = 0; i < 2 * n; ++i) {
+            acc[i] += taps[i] * segment[i];
+        }
+    }
+
+    // Циклический сдвиг на номер отсчета вместо фазовой поправки каждого канала
+    uint64_t absolute = frame_sample_index + frame_step - 1;
+    size_t shift = absolute & (n - 1);
+    for (size_t k = 0; k < n; ++k) {
+        size_t j = n - 1 - ((k + shift) & (n - 1));
+        fft_buffer[k] = cf32(acc[2 * j], acc[2 * j + 1]);
+    }
+    frame_sample_index += frame_step;
+
+    plan.execute(fft_buffer.data());
+
+    for (size_t channel = 0; channel < n; ++channel) {
+        out[channel].push_back(fft_buffer[channel]);
+    }
+}
+
+ChannelWorkers::ChannelWorkers(size_t channels_count, Handler handler)
+    : handler(std::move(handler)), lanes(channels_count) {
+    for (size_t channel = 0; channel < channels_count; ++channel) {
+        lanes[channel].thread = std::thread(&ChannelWorkers::worker, this, channel);
+    }
+}
+
+ChannelWorkers::~ChannelWorkers() {
+    stopping = true;
+    for (Lane& lane : lanes) {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.wakeup.notify_one();
+    }
+    for (Lane& lane : lanes) {
+        lane.thread.join();
+    }
+}
+
+void ChannelWorkers::dispatch(std::vector<std::vector<cf32>>& out) {
+    for (size_t channel = 0; channel < lanes.size() && channel < out.size(); ++channel) {
+        if (out[channel].empty()) continue;
+
+        Lane& lane = lanes[channel];
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.queue.push_back(std::move(out[channel]));
+        out[channel].clear();
+        lane.wakeup.notify_one();
+    }
+}
+
+void ChannelWorkers::drain() {
+    for (Lane& lane : lanes) {
+        std::unique_lock<std::mutex> lock(lane.mutex);
+        lane.idle.wait(lock, [&] { return lane.queue.empty() && !lane.busy; });
+    }
+}
+
+void ChannelWorkers::worker(size_t channel) {
+    Lane& lane = lanes[channel];
+
+    while (true) {
+        std::vector<cf32> block;
+        {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            lane.wakeup.wait(lock, [&] { return stopping || !lane.queue.empty(); });
+            if (lane.queue.empty()) return;
+
+            block = std::move(lane.queue.front());
+            lane.queue.pop_front();
+            lane.busy = true;
+        }
+
+        handler(channel, block);
+
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.busy = false;
+        if (lane.queue.empty()) lane.idle.notify_all();
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fft/fft.h"
+#include "sub_funcs.h"
+
+struct ChannelizerConfig {
+    size_t channels_count = 16;   // Число каналов N (степень двойки)
+    size_t oversampling = 1;      // 1 - критическая дискретизация, 2 - с перекрытием каналов
+    size_t taps_per_branch = 12;  // Длина фильтра в каждой полифазной ветви
+};
+
+// Полифазный банк фильтров (PFB): делит широкополосный поток на N каналов
+// с шагом fs/N. На каждый выходной кадр - одна свертка по ветвям и одно БПФ,
+// вместо N отдельных цепочек смеситель/фильтр/децимация.
+class Channelizer {
+public:
+    explicit Channelizer(const ChannelizerConfig& config);
+
+    size_t channels_count() const { return config.channels_count; }
+
+    // Децимация: на сколько входных отсчетов приходится один выходной в канале
+    size_t decimation() const { return frame_step; }
+
+    // Центральная частота канала (каналы в порядке БПФ: 0, +fs/N, ..., -fs/N)
+    double channel_frequency(size_t channel, double sample_rate) const;
+
+    // Дописывает выходные отсчеты каждого канала в out[channel]
+    void process(const cf32* in, size_t samples_count, std::vector<std::vector<cf32>>& out);
+    void process_cs16(const int16_t* iq, size_t samples_count, std::vector<std::vector<cf32>>& out);
+
+private:
+    void run_frame(size_t newest, std::vector<std::vector<cf32>>& out);
+
+    ChannelizerConfig config;
+    size_t filter_length;
+    size_t frame_step;
+    FftPlan plan;
+
+    // Коэффициенты ветвей в обратном порядке, продублированы для I и Q
+    std::vector<std::vector<float>> branch_taps;
+
+    std::vector<cf32> history;
+    size_t next_frame_end;
+    uint64_t frame_sample_index = 0;
+
+    std::vector<float> accumulator;
+    std::vector<cf32> fft_buffer;
+    std::vector<cf32> convert_buffer;
+};
+
+// Раздает выходы каналов по отдельным потокам-демодуляторам:
+// у каждого канала своя очередь и свой рабочий поток.
+class ChannelWorkers {
+public:
+    using Handler = std::function<void(size_t channel, const std::vector<cf32>& samples)>;
+
+    ChannelWorkers(size_t channels_count, Handler handler);
+    ~ChannelWorkers();
+
+    ChannelWorkers(const ChannelWorkers&) = delete;
+    ChannelWorkers& operator=(const ChannelWorkers&) = delete;
+
+    // Забирает отсчеты каналов (out очищается) и ставит их в очереди потоков
+    void dispatch(std::vector<std::vector<cf32>>& out);
+
+    // Дожидается обработки всех поставленных блоков
+    void drain();
+
+private:
+    struct Lane {
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::condition_variable idle;
+        std::deque<std::vector<cf32>> queue;
+        bool busy = false;
+        std::thread thread;
+    };
+
+    void worker(size_t channel);
+
+    Handler handler;
+    std::vector<Lane> lanes;
+    std::atomic<bool> stopping{false};
+};
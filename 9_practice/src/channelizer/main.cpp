@@ -0,0 +1,80 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "channelizer/channelizer.h"
+#include "nco/nco.h"
+
+constexpr double SAMPLING_RATE = 1000000;
+constexpr size_t BLOCK_SIZE = 1920;
+
+// Тестовый широкополосный сигнал: несколько тонов в центрах разных каналов
+std::vector<int16_t> make_test_band(const Channelizer& channelizer, size_t samples_count) {
+    const size_t active_channels[] = {1, 5, 12};
+    std::vector<cf32> band(samples_count, cf32(0.0f, 0.0f));
+    std::vector<cf32> tone(samples_count);
+    std::vector<cf32> ones(samples_count, cf32(0.25f, 0.0f));
+
+    for (size_t channel : active_channels) {
+        Nco nco(SAMPLING_RATE, channelizer.channel_frequency(channel, SAMPLING_RATE));
+        nco.mix(ones.data(), tone.data(), samples_count);
+        for (size_t i = 0; i < samples_count; ++i) band[i] += tone[i];
+    }
+
+    std::vector<int16_t> iq(samples_count * 2);
+    cf32_to_cs16(band.data(), iq.data(), samples_count);
+    return iq;
+}
+
+int main(int argc, char** argv) {
+    ChannelizerConfig config;
+    config.channels_count = 16;
+    config.oversampling = 2;
+
+    Channelizer channelizer(config);
+
+    // Каждый канал считает свою мощность в отдельном потоке (место для демодулятора)
+    std::vector<double> channel_power(config.channels_count, 0.0);
+    std::vector<size_t> channel_samples(config.channels_count, 0);
+    ChannelWorkers workers(config.channels_count, [&](size_t channel, const std::vector<cf32>& samples) {
+        for (const cf32& s : samples) channel_power[channel] += std::norm(s);
+        channel_samples[channel] += samples.size();
+    });
+
+    std::vector<std::vector<cf32>> outputs;
+
+    if (argc > 1) {
+        // Запись CS16 с диска (например, received_data.pcm из 5,6 практики)
+        FILE* capture = fopen(argv[1], "rb");
+        if (!capture) {
+            printf("Не удалось открыть файл: %s\n", argv[1]);
+            return -1;
+        }
+
+        std::vector<int16_t> block(BLOCK_SIZE * 2);
+        size_t read_samples;
+        while ((read_samples = fread(block.data(), sizeof(int16_t) * 2, BLOCK_SIZE, capture)) > 0) {
+            channelizer.process_cs16(block.data(), read_samples, outputs);
+            workers.dispatch(outputs);
+        }
+        fclose(capture);
+    } else {
+        std::vector<int16_t> band = make_test_band(channelizer, BLOCK_SIZE * 100);
+        for (size_t offset = 0; offset < band.size() / 2; offset += BLOCK_SIZE) {
+            channelizer.process_cs16(band.data() + offset * 2, BLOCK_SIZE, outputs);
+            workers.dispatch(outputs);
+        }
+    }
+
+    workers.drain();
+
+    printf("Каналов: %zu, децимация: %zu\n", channelizer.channels_count(), channelizer.decimation());
+    for (size_t channel = 0; channel < config.channels_count; ++channel) {
+        double mean_power = channel_samples[channel] ? channel_power[channel] / channel_samples[channel] : 0.0;
+        printf("Канал %2zu (%+9.0f Гц): %7.1f дБ\n", channel,
+               channelizer.channel_frequency(channel, SAMPLING_RATE),
+               10.0 * std::log10(mean_power + 1e-20));
+    }
+
+    return 0;
+}
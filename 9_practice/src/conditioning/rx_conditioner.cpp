@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "conditioning/rx_conditioner.h"
+
+static float block_coefficient(double time_constant, size_t count) {
+    if (time_constant <= 0) return 1.0f;
+    return static_cast<float>(1.0 - std::exp(-static_cast<double>(count) / time_constant));
+}
+
+RxConditioner::RxConditioner(const RxConditionerConfig& config) : config(config) {
+    // Коэффициенты для полного блока считаются один раз, exp() остается только для хвостов
+    dc_coefficient = block_coefficient(config.dc_time_constant, RX_COND_BLOCK);
+    iq_coefficient = block_coefficient(config.iq_time_constant, RX_COND_BLOCK);
+    attack_coefficient = block_coefficient(config.agc_attack, RX_COND_BLOCK);
+    decay_coefficient = block_coefficient(config.agc_decay, RX_COND_BLOCK);
+    reset();
+}
+
+float RxConditioner::coefficient(float full_block, double time_constant, size_t count) const {
+    if (first_block) return 1.0f;
+    return count == RX_COND_BLOCK ? full_block : block_coefficient(time_constant, count);
+}
+
+void RxConditioner::reset() {
+    dc_i = dc_q = 0.0f;
+    moment_ii = moment_qq = 1.0f;
+    moment_iq = 0.0f;
+    agc_gain_db = 0.0f;
+    applied_gain = 1.0f;
+    first_block = true;
+}
+
+float RxConditioner::gain_imbalance() const {
+    return moment_ii > 0 ? std::sqrt(moment_qq / moment_ii) : 1.0f;
+}
+
+float RxConditioner::phase_imbalance_deg() const {
+    float norm = std::sqrt(moment_ii * moment_qq);
+    return norm > 0 ? static_cast<float>(std::asin(moment_iq / norm) * 180.0 / PI) : 0.0f;
+}
+
+void RxConditioner::process(const cf32* in, cf32* out, size_t samples_count) {
+    for (size_t pos = 0; pos < samples_count; pos += RX_COND_BLOCK) {
+        process_block(in + pos, out + pos, std::min(RX_COND_BLOCK, samples_count - pos));
+    }
+}
+
+void RxConditioner::process_cs16(const int16_t* iq, cf32* out, size_t samples_count) {
+    cs16_to_cf32(iq, out, samples_count);
+    process(out, out, samples_count);
+}
+
+void RxConditioner::process_block(const cf32* in, cf32* out, size_t count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+
+    // Сырые моменты блока; центрирование - аналитически, без второго прохода.
+    // RX_COND_LANES независимых сумм разрывают цепочку зависимостей и векторизуются.
+    float acc_i[RX_COND_LANES] = {}, acc_q[RX_COND_LANES] = {};
+    float acc_ii[RX_COND_LANES] = {}, acc_qq[RX_COND_LANES] = {}, acc_iq[RX_COND_LANES] = {};
+    size_t n = 0;
+    for (; n + RX_COND_LANES <= count; n += RX_COND_LANES) {
+        for (size_t l = 0; l < RX_COND_LANES; ++l) {
+            float i = src[2 * (n + l)];
+            float q = src[2 * (n + l) + 1];
+            acc_i[l] += i;
+            acc_q[l] += q;
+            acc_ii[l] += i * i;
+            acc_qq[l] += q * q;
+            acc_iq[l] += i * q;
+        }
+    }
+    for (; n < count; ++n) {
+        float i = src[2 * n];
+        float q = src[2 * n + 1];
+        acc_i[0] += i;
+        acc_q[0] += q;
+        acc_ii[0] += i * i;
+        acc_qq[0] += q * q;
+        acc_iq[0] += i * q;
+    }
+    float sum_i = 0, sum_q = 0, sum_ii = 0, sum_qq = 0, sum_iq = 0;
+    for (size_t l = 0; l < RX_COND_LANES; ++l) {
+        sum_i += acc_i[l];
+        sum_q += acc_q[l];
+        sum_ii += acc_ii[l];
+        sum_qq += acc_qq[l];
+        sum_iq += acc_iq[l];
+    }
+    float scale = 1.0f / count;
+    float mean_i = sum_i * scale, mean_q = sum_q * scale;
+
+    // Первый блок сразу задает оценки, чтобы не ждать установления фильтров
+    if (config.dc_enabled) {
+        float a = coefficient(dc_coefficient, config.dc_time_constant, count);
+        dc_i += a * (mean_i - dc_i);
+        dc_q += a * (mean_q - dc_q);
+    }
+    float di = config.dc_enabled ? dc_i : 0.0f;
+    float dq = config.dc_enabled ? dc_q : 0.0f;
+
+    // E[(x - d)(y - d')] = E[xy] - d' E[x] - d E[y] + d d'
+    float c_ii = sum_ii * scale - 2 * di * mean_i + di * di;
+    float c_qq = sum_qq * scale - 2 * dq * mean_q + dq * dq;
+    float c_iq = sum_iq * scale - dq * mean_i - di * mean_q + di * dq;
+
+    // Q' = a * Q + b * I: выравнивание амплитуды и ортогонализация по I
+    float a = 1.0f, b = 0.0f;
+    if (config.iq_enabled) {
+        float k = coefficient(iq_coefficient, config.iq_time_constant, count);
+        moment_ii += k * (c_ii - moment_ii);
+        moment_qq += k * (c_qq - moment_qq);
+        moment_iq += k * (c_iq - moment_iq);
+
+        if (moment_ii > 0 && moment_qq > 0) {
+            float g = std::sqrt(moment_qq / moment_ii);
+            float s = std::max(-0.5f, std::min(0.5f, moment_iq / std::sqrt(moment_ii * moment_qq)));
+            float c = std::sqrt(1.0f - s * s);
+            a = 1.0f / (g * c);
+            b = -s / c;
+        }
+    }
+
+    float gain = 1.0f;
+    if (config.agc_enabled) {
+        float power = c_ii + a * a * c_qq + 2 * a * b * c_iq + b * b * c_ii;
+        if (power > 1e-20f) {
+            float desired = 20.0f * std::log10(config.agc_target_rms / std::sqrt(power));
+            float k = desired < agc_gain_db ? coefficient(attack_coefficient, config.agc_attack, count)
+                                            : coefficient(decay_coefficient, config.agc_decay, count);
+            agc_gain_db += k * (desired - agc_gain_db);
+            agc_gain_db = std::max(config.min_gain_db, std::min(config.max_gain_db, agc_gain_db));
+        }
+        gain = std::pow(10.0f, agc_gain_db / 20.0f);
+    }
+
+    // Линейное изменение усиления по блоку вместо ступеньки
+    float g0 = first_block ? gain : applied_gain;
+    float step = (gain - g0) / count;
+    for (n = 0; n < count; ++n) {
+        float i = src[2 * n] - di;
+        float q = src[2 * n + 1] - dq;
+        float g = g0 + step * (n + 1);
+        dst[2 * n] = g * i;
+        dst[2 * n + 1] = g * (a * q + b * i);
+    }
+
+    applied_gain = gain;
+    first_block = false;
+}
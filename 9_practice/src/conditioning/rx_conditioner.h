@@ -0,0 +1,58 @@
+#pragma once
+
+#include "sub_funcs.h"
+
+// Подготовка RX-потока для демодуляторов: удаление постоянной составляющей,
+// оценка и коррекция IQ-дисбаланса (амплитуда и фаза), цифровая АРУ.
+// Все оценки обновляются раз в блок RX_COND_BLOCK отсчетов однополюсным фильтром,
+// коэффициент на блок 1 - exp(-block / tau). Статистика блока собирается одним
+// проходом по сырым моментам, коррекция - вторым проходом без зависимостей между отсчетами.
+constexpr size_t RX_COND_BLOCK = 256;
+constexpr size_t RX_COND_LANES = 8;
+
+struct RxConditionerConfig {
+    // Постоянные времени в отсчетах
+    double dc_time_constant = 100000.0;
+    double iq_time_constant = 500000.0;
+    double agc_attack = 2000.0;    // уменьшение усиления (сигнал вырос)
+    double agc_decay = 50000.0;    // увеличение усиления (сигнал упал)
+
+    float agc_target_rms = 0.5f;
+    float min_gain_db = -20.0f;
+    float max_gain_db = 60.0f;
+
+    bool dc_enabled = true;
+    bool iq_enabled = true;
+    bool agc_enabled = true;
+};
+
+class RxConditioner {
+public:
+    explicit RxConditioner(const RxConditionerConfig& config = RxConditionerConfig());
+
+    // in и out могут совпадать
+    void process(const cf32* in, cf32* out, size_t samples_count);
+    void process_cs16(const int16_t* iq, cf32* out, size_t samples_count);
+
+    void reset();
+
+    cf32 dc_offset() const { return cf32(dc_i, dc_q); }
+    // Отношение амплитуд Q/I и фазовая ошибка квадратуры
+    float gain_imbalance() const;
+    float phase_imbalance_deg() const;
+    float gain_db() const { return agc_gain_db; }
+
+private:
+    void process_block(const cf32* in, cf32* out, size_t count);
+    float coefficient(float full_block, double time_constant, size_t count) const;
+
+    RxConditionerConfig config;
+    float dc_coefficient, iq_coefficient, attack_coefficient, decay_coefficient;
+
+    float dc_i, dc_q;
+    // Сглаженные центрированные моменты для оценки IQ-дисбаланса
+    float moment_ii, moment_qq, moment_iq;
+    float agc_gain_db;
+    float applied_gain;
+    bool first_block;
+};
@@ -0,0 +1,438 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "decimator/decimator.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define DECIM_HAVE_SSE2 1
+#endif
+
+// Разрядность входа CIC и аккумуляторов
+constexpr double CIC_INPUT_BITS = 16.0;
+constexpr double CIC_REGISTER_BITS = 32.0;
+constexpr size_t CIC_MAX_STAGES = 6;
+
+// Точек сетки частот при расчете компенсатора
+constexpr size_t COMPENSATOR_GRID = 4096;
+// Точек сетки при проверке полосы заграждения и наибольшее удлинение фильтра сверх формулы
+constexpr size_t STOPBAND_CHECK_GRID = 512;
+constexpr size_t DESIGN_MAX_EXTEND = 64;
+
+static bool cic_fits(size_t decimation, size_t stages) {
+    return CIC_INPUT_BITS + stages * std::log2(static_cast<double>(decimation)) <= CIC_REGISTER_BITS;
+}
+
+CicDecimator::CicDecimator(size_t decimation, size_t stages) : factor(decimation), stages(stages) {
+    if (factor == 0 || stages == 0 || stages > CIC_MAX_STAGES) {
+        throw std::invalid_argument("CIC: R > 0, число звеньев от 1 до 6");
+    }
+    if (!cic_fits(factor, stages)) throw std::invalid_argument("CIC: 16 + N * log2(R) больше 32 бит");
+    scale = static_cast<float>(1.0 / (std::pow(static_cast<double>(factor), static_cast<double>(stages)) *
+                                      CS16_FULL_SCALE));
+    reset();
+}
+
+void CicDecimator::reset() {
+    phase = 0;
+    integrators.assign(2 * stages, 0);
+    combs.assign(2 * stages, 0);
+}
+
+double CicDecimator::response(double frequency) const {
+    double x = PI * frequency;
+    if (std::fabs(std::sin(x / factor)) < 1e-12) return 1.0;
+    return std::pow(std::fabs(std::sin(x) / (factor * std::sin(x / factor))), static_cast<double>(stages));
+}
+
+// Число звеньев - параметр шаблона: каскад разворачивается, состояние живет в регистрах.
+// Функция файла, а не член класса, чтобы -fPIC не мешал встраиванию.
+template <size_t N>
+static size_t cic_run(const int16_t* iq, size_t samples_count, size_t factor, size_t& phase, uint32_t* integrators,
+                      uint32_t* combs, float scale, cf32* out) {
+    uint32_t acc_i[N], acc_q[N];
+    for (size_t s = 0; s < N; ++s) {
+        acc_i[s] = integrators[2 * s];
+        acc_q[s] = integrators[2 * s + 1];
+    }
+
+    size_t produced = 0;
+    size_t n = 0;
+    while (n < samples_count) {
+        // Интеграторы до ближайшего выходного отсчета - без проверок внутри
+        size_t run = std::min(factor - phase, samples_count - n);
+#ifdef DECIM_HAVE_SSE2
+        // I и Q в двух дорожках одного регистра: N сложений paddd на отсчет
+        __m128i acc[N];
+        for (size_t s = 0; s < N; ++s) acc[s] = _mm_set_epi32(0, 0, static_cast<int>(acc_q[s]), static_cast<int>(acc_i[s]));
+        for (size_t k = 0; k < run; ++k, ++n) {
+            int32_t pair;
+            memcpy(&pair, iq + 2 * n, sizeof(pair));
+            __m128i x = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_cvtsi32_si128(pair)), 16);
+            for (size_t s = 0; s < N; ++s) {
+                acc[s] = _mm_add_epi32(acc[s], x);
+                x = acc[s];
+            }
+        }
+        for (size_t s = 0; s < N; ++s) {
+            acc_i[s] = static_cast<uint32_t>(_mm_cvtsi128_si32(acc[s]));
+            acc_q[s] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc[s], 4)));
+        }
+#else
+        for (size_t k = 0; k < run; ++k, ++n) {
+            uint32_t x_i = static_cast<uint32_t>(static_cast<int32_t>(iq[2 * n]));
+            uint32_t x_q = static_cast<uint32_t>(static_cast<int32_t>(iq[2 * n + 1]));
+            for (size_t s = 0; s < N; ++s) {
+                acc_i[s] += x_i;
+                acc_q[s] += x_q;
+                x_i = acc_i[s];
+                x_q = acc_q[s];
+            }
+        }
+#endif
+        phase += run;
+        if (phase < factor) break;
+        phase = 0;
+
+        uint32_t y_i = acc_i[N - 1], y_q = acc_q[N - 1];
+        for (size_t s = 0; s < N; ++s) {
+            uint32_t d_i = y_i - combs[2 * s], d_q = y_q - combs[2 * s + 1];
+            combs[2 * s] = y_i;
+            combs[2 * s + 1] = y_q;
+            y_i = d_i;
+            y_q = d_q;
+        }
+        out[produced++] = cf32(static_cast<int32_t>(y_i) * scale, static_cast<int32_t>(y_q) * scale);
+    }
+
+    for (size_t s = 0; s < N; ++s) {
+        integrators[2 * s] = acc_i[s];
+        integrators[2 * s + 1] = acc_q[s];
+    }
+    return produced;
+}
+
+size_t CicDecimator::process(const int16_t* iq, size_t samples_count, cf32* out) {
+    uint32_t* integ = integrators.data();
+    uint32_t* comb = combs.data();
+    switch (stages) {
+        case 1: return cic_run<1>(iq, samples_count, factor, phase, integ, comb, scale, out);
+        case 2: return cic_run<2>(iq, samples_count, factor, phase, integ, comb, scale, out);
+        case 3: return cic_run<3>(iq, samples_count, factor, phase, integ, comb, scale, out);
+        case 4: return cic_run<4>(iq, samples_count, factor, phase, integ, comb, scale, out);
+        case 5: return cic_run<5>(iq, samples_count, factor, phase, integ, comb, scale, out);
+        default: return cic_run<6>(iq, samples_count, factor, phase, integ, comb, scale, out);
+    }
+}
+
+FirDecimator::FirDecimator(const std::vector<float>& taps, size_t decimation)
+    : taps_size(taps.size()), factor(decimation) {
+    if (factor == 0 || taps.size() < factor) throw std::invalid_argument("FirDecimator: D > 0, коэффициентов не меньше D");
+    // Свертка: коэффициенты в обратном порядке, каждый дважды (I и Q)
+    pair_taps.resize(2 * taps_size);
+    for (size_t k = 0; k < taps_size; ++k) pair_taps[2 * k] = pair_taps[2 * k + 1] = taps[taps_size - 1 - k];
+    reset();
+}
+
+void FirDecimator::reset() {
+    history.assign(taps_size - 1, cf32(0.0f, 0.0f));
+}
+
+static cf32 fir_dot(const float* h, const float* x, size_t taps) {
+    size_t k = 0;
+    float acc_i = 0, acc_q = 0;
+#ifdef DECIM_HAVE_SSE2
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; k + 4 <= taps; k += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(h + 2 * k), _mm_loadu_ps(x + 2 * k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(h + 2 * k + 4), _mm_loadu_ps(x + 2 * k + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    acc_i = lanes[0] + lanes[2];
+    acc_q = lanes[1] + lanes[3];
+#endif
+    for (; k < taps; ++k) {
+        acc_i += h[2 * k] * x[2 * k];
+        acc_q += h[2 * k + 1] * x[2 * k + 1];
+    }
+    return cf32(acc_i, acc_q);
+}
+
+size_t FirDecimator::process(const cf32* in, size_t samples_count, cf32* out) {
+    history.insert(history.end(), in, in + samples_count);
+    const float* x = reinterpret_cast<const float*>(history.data());
+
+    size_t produced = 0;
+    size_t pos = 0;
+    for (; pos + taps_size <= history.size(); pos += factor) {
+        out[produced++] = fir_dot(pair_taps.data(), x + 2 * pos, taps_size);
+    }
+    // pos <= history.size(), так как коэффициентов не меньше D
+    history.erase(history.begin(), history.begin() + pos);
+    return produced;
+}
+
+HalfBandDecimator::HalfBandDecimator(const std::vector<float>& taps) : taps_size(taps.size()) {
+    if (taps_size < 3 || (taps_size + 1) % 4 != 0) {
+        throw std::invalid_argument("Полуполосный фильтр: длина 4q - 1");
+    }
+    quarter = (taps_size + 1) / 4;
+    const size_t center = (taps_size - 1) / 2;
+    side.resize(quarter);
+    for (size_t j = 1; j <= quarter; ++j) side[j - 1] = taps[center - (2 * j - 1)];
+    reset();
+}
+
+void HalfBandDecimator::reset() {
+    history.assign(taps_size - 1, cf32(0.0f, 0.0f));
+}
+
+// Выходы 0 .. count - 1: y[m] = 0.5 odd[m + q - 1] + sum_j side[j] (even[m + q - j] + even[m + q + j - 1])
+static void halfband_run(const float* even, const float* odd, const float* side, size_t quarter, size_t count,
+                         cf32* out) {
+    float* y = reinterpret_cast<float*>(out);
+    size_t m = 0;
+#ifdef DECIM_HAVE_SSE2
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; m + 4 <= count; m += 4) {
+        __m128 acc0 = _mm_mul_ps(half, _mm_loadu_ps(odd + 2 * (m + quarter - 1)));
+        __m128 acc1 = _mm_mul_ps(half, _mm_loadu_ps(odd + 2 * (m + quarter + 1)));
+        for (size_t j = 1; j <= quarter; ++j) {
+            __m128 h = _mm_set1_ps(side[j - 1]);
+            const float* left = even + 2 * (m + quarter - j);
+            const float* right = even + 2 * (m + quarter + j - 1);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(h, _mm_add_ps(_mm_loadu_ps(left), _mm_loadu_ps(right))));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(h, _mm_add_ps(_mm_loadu_ps(left + 4), _mm_loadu_ps(right + 4))));
+        }
+        _mm_storeu_ps(y + 2 * m, acc0);
+        _mm_storeu_ps(y + 2 * m + 4, acc1);
+    }
+#endif
+    for (; m < count; ++m) {
+        float acc_i = 0.5f * odd[2 * (m + quarter - 1)];
+        float acc_q = 0.5f * odd[2 * (m + quarter - 1) + 1];
+        for (size_t j = 1; j <= quarter; ++j) {
+            const float* left = even + 2 * (m + quarter - j);
+            const float* right = even + 2 * (m + quarter + j - 1);
+            acc_i += side[j - 1] * (left[0] + right[0]);
+            acc_q += side[j - 1] * (left[1] + right[1]);
+        }
+        y[2 * m] = acc_i;
+        y[2 * m + 1] = acc_q;
+    }
+}
+
+size_t HalfBandDecimator::process(const cf32* in, size_t samples_count, cf32* out) {
+    history.insert(history.end(), in, in + samples_count);
+    if (history.size() < taps_size) return 0;
+
+    // Выход m использует окно history[2m .. 2m + L - 1]
+    const size_t count = (history.size() - taps_size) / 2 + 1;
+    even.resize(count + 2 * quarter - 1);
+    odd.resize(count + quarter - 1);
+    for (size_t i = 0; i < even.size(); ++i) even[i] = history[2 * i];
+    for (size_t i = 0; i < odd.size(); ++i) odd[i] = history[2 * i + 1];
+
+    halfband_run(reinterpret_cast<const float*>(even.data()), reinterpret_cast<const float*>(odd.data()),
+                 side.data(), quarter, count, out);
+    history.erase(history.begin(), history.begin() + 2 * count);
+    return count;
+}
+
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+static double kaiser_beta(double stopband_db) {
+    if (stopband_db > 50) return 0.1102 * (stopband_db - 8.7);
+    if (stopband_db > 21) return 0.5842 * std::pow(stopband_db - 21, 0.4) + 0.07886 * (stopband_db - 21);
+    return 0.0;
+}
+
+static double kaiser_window(size_t index, size_t length, double beta) {
+    if (length < 2) return 1.0;
+    double r = 2.0 * index / (length - 1) - 1.0;
+    return bessel_i0(beta * std::sqrt(std::max(0.0, 1 - r * r))) / bessel_i0(beta);
+}
+
+size_t kaiser_length(double stopband_db, double transition) {
+    return static_cast<size_t>(std::ceil((stopband_db - 7.95) / (14.36 * transition))) + 1;
+}
+
+// Наибольший уровень АЧХ КИХ на [from, 0.5] относительно усиления на нуле, дБ
+static double stopband_peak_db(const std::vector<float>& taps, double from) {
+    double dc = 0;
+    for (float tap : taps) dc += tap;
+    double peak = 0;
+    for (size_t g = 0; g <= STOPBAND_CHECK_GRID; ++g) {
+        double f = from + (0.5 - from) * g / STOPBAND_CHECK_GRID;
+        std::complex<double> sum = 0;
+        for (size_t n = 0; n < taps.size(); ++n) sum += static_cast<double>(taps[n]) * std::polar(1.0, -2 * PI * f * n);
+        peak = std::max(peak, std::abs(sum));
+    }
+    return 20 * std::log10(peak / std::fabs(dc) + 1e-30);
+}
+
+static std::vector<float> halfband_taps(size_t length, double beta) {
+    const size_t center = (length - 1) / 2;
+    std::vector<double> taps(length, 0.0);
+    double side_sum = 0;
+    for (size_t n = 0; n < length; ++n) {
+        long offset = static_cast<long>(n) - static_cast<long>(center);
+        if (offset == 0 || offset % 2 == 0) continue;
+        double x = PI * offset / 2;
+        taps[n] = 0.5 * std::sin(x) / x * kaiser_window(n, length, beta);
+        side_sum += taps[n];
+    }
+    // Центр ровно 0.5, боковые нормированы так, чтобы усиление на нуле было 1
+    std::vector<float> result(length);
+    for (size_t n = 0; n < length; ++n) result[n] = static_cast<float>(taps[n] * 0.5 / side_sum);
+    result[center] = 0.5f;
+    return result;
+}
+
+std::vector<float> design_halfband(double passband, double stopband_db) {
+    if (passband <= 0 || passband >= 0.25) throw std::invalid_argument("Полуполосный фильтр: полоса 0 .. 0.25");
+    size_t length = kaiser_length(stopband_db, 0.5 - 2 * passband);
+    size_t quarter = std::max<size_t>(1, (length + 1 + 3) / 4);
+    const double beta = kaiser_beta(stopband_db);
+
+    // Формула Кайзера на коротких фильтрах недобирает пару дБ: длина растет, пока
+    // подавление от 0.5 - passband не дойдет до заданного
+    std::vector<float> result = halfband_taps(4 * quarter - 1, beta);
+    for (size_t extra = 0; extra < DESIGN_MAX_EXTEND && stopband_peak_db(result, 0.5 - passband) > -stopband_db;
+         ++extra) {
+        result = halfband_taps(4 * ++quarter - 1, beta);
+    }
+    return result;
+}
+
+static std::vector<float> compensator_taps(const std::vector<double>& desired, size_t length, double beta) {
+    const double center = (length - 1) / 2.0;
+    const double step = 0.5 / COMPENSATOR_GRID;
+    std::vector<double> taps(length);
+    double sum = 0;
+    for (size_t n = 0; n < length; ++n) {
+        double t = n - center;
+        double value = 0;
+        for (size_t g = 0; g < COMPENSATOR_GRID; ++g) value += desired[g] * std::cos(2 * PI * (g + 0.5) * step * t);
+        taps[n] = 2 * value * step * kaiser_window(n, length, beta);
+        sum += taps[n];
+    }
+
+    std::vector<float> result(length);
+    for (size_t n = 0; n < length; ++n) result[n] = static_cast<float>(taps[n] / sum);
+    return result;
+}
+
+std::vector<float> design_cic_compensator(const CicDecimator& cic, double passband, double stopband,
+                                          double stopband_db) {
+    if (passband <= 0 || stopband <= passband || stopband > 0.5) {
+        throw std::invalid_argument("Компенсатор CIC: 0 < passband < stopband <= 0.5");
+    }
+    // Желаемая АЧХ 1 / |H_cic| обрывается посередине переходной полосы; окно Кайзера
+    // размывает обрыв на половину переходной полосы в обе стороны, не задевая полосу пропускания
+    const double edge = (passband + stopband) / 2;
+    size_t length = kaiser_length(stopband_db, (stopband - passband) / 2) | 1;
+    const double beta = kaiser_beta(stopband_db);
+
+    std::vector<double> desired(COMPENSATOR_GRID);
+    const double step = 0.5 / COMPENSATOR_GRID;
+    for (size_t g = 0; g < COMPENSATOR_GRID; ++g) {
+        double f = (g + 0.5) * step;
+        desired[g] = f < edge ? 1.0 / cic.response(f) : 0.0;
+    }
+
+    // Как и у полуполосного, длина по формуле проверяется по АЧХ
+    std::vector<float> result = compensator_taps(desired, length, beta);
+    for (size_t extra = 0; extra < DESIGN_MAX_EXTEND && stopband_peak_db(result, stopband) > -stopband_db; ++extra) {
+        length += 2;
+        result = compensator_taps(desired, length, beta);
+    }
+    return result;
+}
+
+// Наибольший R (лучше всего снимает частоту без умножений), при котором остаток - степень двойки,
+// а аккумуляторы помещаются в 32 бита
+static size_t choose_cic_decimation(const DecimatorConfig& config) {
+    if (config.decimation == 0) throw std::invalid_argument("Коэффициент децимации > 0");
+    if (config.cic_decimation) {
+        size_t rest = config.decimation / config.cic_decimation;
+        if (config.decimation % config.cic_decimation || (rest & (rest - 1))) {
+            throw std::invalid_argument("decimation / cic_decimation должно быть степенью двойки");
+        }
+        return config.cic_decimation;
+    }
+    size_t rest = 1;
+    while (config.decimation % (rest * 2) == 0) rest *= 2;
+    size_t odd_part = config.decimation / rest;
+    // Начинаем со всех двоек в CIC, кроме одной для компенсатора
+    for (size_t shift = rest > 1 ? rest / 2 : 1; ; shift /= 2) {
+        size_t r = odd_part * shift;
+        if (cic_fits(r, config.cic_stages) || shift == 1) return r;
+    }
+}
+
+DecimatorChain::DecimatorChain(const DecimatorConfig& config)
+    : config(config), cic(choose_cic_decimation(config), config.cic_stages) {
+    if (config.passband <= 0 || config.passband >= 0.25) throw std::invalid_argument("Полоса: 0 .. 0.25");
+
+    size_t rest = config.decimation / cic.decimation();
+    if (rest >= 2) {
+        // Компенсатор на выходе CIC, дальше еще rest / 2 раз: полоса в долях его входной частоты
+        double passband = config.passband / rest;
+        compensator.reset(new FirDecimator(
+            design_cic_compensator(cic, passband, 0.5 - passband, config.stopband_db), 2));
+        for (size_t stage_rest = rest / 2; stage_rest >= 2; stage_rest /= 2) {
+            halfbands.emplace_back(design_halfband(config.passband / stage_rest, config.stopband_db));
+        }
+    }
+}
+
+double DecimatorChain::multiplies_per_input() const {
+    // Вещественный коэффициент на комплексный отсчет - два умножения
+    double rate = 1.0 / cic.decimation();
+    double total = 0;
+    if (compensator) {
+        rate /= 2;
+        total += rate * 2 * compensator->taps_count();
+    }
+    for (const HalfBandDecimator& stage : halfbands) {
+        rate /= 2;
+        total += rate * 2 * ((stage.taps_count() + 1) / 4 + 1);
+    }
+    return total;
+}
+
+void DecimatorChain::reset() {
+    cic.reset();
+    if (compensator) compensator->reset();
+    for (HalfBandDecimator& stage : halfbands) stage.reset();
+}
+
+size_t DecimatorChain::process_cs16(const int16_t* iq, size_t samples_count, cf32* out) {
+    stage_a.resize(samples_count / cic.decimation() + 1);
+    size_t count = cic.process(iq, samples_count, stage_a.data());
+
+    if (compensator) {
+        stage_b.resize(count / 2 + 1);
+        count = compensator->process(stage_a.data(), count, stage_b.data());
+        stage_a.swap(stage_b);
+    }
+    for (HalfBandDecimator& stage : halfbands) {
+        stage_b.resize(count / 2 + 1);
+        count = stage.process(stage_a.data(), count, stage_b.data());
+        stage_a.swap(stage_b);
+    }
+    std::copy(stage_a.begin(), stage_a.begin() + count, out);
+    return count;
+}
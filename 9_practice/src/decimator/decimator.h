@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Многоступенчатая децимация для высоких частот дискретизации (20-60 МГц у Pluto):
+//   CIC (R, без умножений, int32) -> компенсирующий КИХ (/2) -> полуполосные фильтры (/2 каждый).
+// CIC дешево снимает основную часть частоты, но завал АЧХ sinc^N исправляет КИХ,
+// а полуполосные ступени используют то, что каждый второй коэффициент равен нулю.
+
+struct DecimatorConfig {
+    size_t decimation = 32;         // общий коэффициент: R * 2^m
+    size_t cic_decimation = 0;      // R; 0 - выбрать наибольший допустимый
+    size_t cic_stages = 4;          // N
+    double passband = 0.2;          // полоса пропускания, доля выходной частоты (0 .. 0.25)
+    double stopband_db = 80.0;      // подавление зеркал, попадающих в полосу
+};
+
+// CIC-дециматор: N интеграторов на входной частоте, N гребенчатых звеньев на выходной.
+// Арифметика по модулю 2^32: переполнение интеграторов сокращается в гребенке, нужно
+// только 16 + N * log2(R) <= 32 бит. Выход нормирован на усиление R^N и CS16_FULL_SCALE.
+class CicDecimator {
+public:
+    CicDecimator(size_t decimation, size_t stages);
+
+    size_t decimation() const { return factor; }
+
+    // Возвращает число выходных отсчетов (не больше samples_count / R + 1)
+    size_t process(const int16_t* iq, size_t samples_count, cf32* out);
+
+    // |H(f)|, f - в долях выходной частоты
+    double response(double frequency) const;
+
+    void reset();
+
+private:
+    size_t factor;
+    size_t stages;
+    size_t phase = 0;
+    float scale;
+    std::vector<uint32_t> integrators;  // по два (I, Q) на звено
+    std::vector<uint32_t> combs;
+};
+
+// КИХ с децимацией: считаются только нужные выходы, коэффициенты продублированы для I и Q
+class FirDecimator {
+public:
+    FirDecimator(const std::vector<float>& taps, size_t decimation);
+
+    size_t taps_count() const { return taps_size; }
+
+    size_t process(const cf32* in, size_t samples_count, cf32* out);
+    void reset();
+
+private:
+    size_t taps_size;
+    size_t factor;
+    std::vector<float> pair_taps;
+    std::vector<cf32> history;
+};
+
+// Полуполосный дециматор на 2: длина 4q - 1, центр 0.5, остальные четные отводы нулевые.
+// Вход делится на четные и нечетные отсчеты: нечетные дают только центр, четные - все
+// ненулевые отводы, симметричные пары складываются до умножения. Векторизация - по
+// соседним выходам (SSE2: два комплексных выхода на регистр).
+class HalfBandDecimator {
+public:
+    explicit HalfBandDecimator(const std::vector<float>& taps);
+
+    size_t taps_count() const { return taps_size; }
+
+    size_t process(const cf32* in, size_t samples_count, cf32* out);
+    void reset();
+
+private:
+    size_t taps_size;
+    size_t quarter;               // q: ненулевых боковых отводов с каждой стороны
+    std::vector<float> side;      // h[D - (2j - 1)], j = 1..q
+    std::vector<cf32> history;
+    std::vector<cf32> even;
+    std::vector<cf32> odd;
+};
+
+// Окно Кайзера на заданное подавление и переходную полосу (в долях частоты): длина и бета
+size_t kaiser_length(double stopband_db, double transition);
+std::vector<float> design_halfband(double passband, double stopband_db);
+// Компенсация CIC: 1 / |H_cic| в полосе [0, passband], ноль от stopband (доли входной частоты КИХ)
+std::vector<float> design_cic_compensator(const CicDecimator& cic, double passband, double stopband,
+                                          double stopband_db);
+
+class DecimatorChain {
+public:
+    explicit DecimatorChain(const DecimatorConfig& config);
+
+    size_t decimation() const { return config.decimation; }
+    size_t cic_decimation() const { return cic.decimation(); }
+    size_t halfband_count() const { return halfbands.size(); }
+    size_t compensator_taps() const { return compensator ? compensator->taps_count() : 0; }
+    size_t halfband_taps(size_t index) const { return halfbands[index].taps_count(); }
+
+    // Умножений на входной отсчет (оценка стоимости цепочки)
+    double multiplies_per_input() const;
+
+    // out: не меньше samples_count / decimation + 1 отсчетов
+    size_t process_cs16(const int16_t* iq, size_t samples_count, cf32* out);
+    void reset();
+
+private:
+    DecimatorConfig config;
+    CicDecimator cic;
+    std::unique_ptr<FirDecimator> compensator;
+    std::vector<HalfBandDecimator> halfbands;
+    std::vector<cf32> stage_a;
+    std::vector<cf32> stage_b;
+};
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "capture/capture_file.h"
+#include "decimator/decimator.h"
+#include "filter/fir.h"
+#include "nco/nco.h"
+
+constexpr size_t BLOCK_SIZE = 65536;
+
+// Тон с частотой frequency (доли входной частоты) амплитудой 0.5 полной шкалы
+static std::vector<int16_t> make_tone(double frequency, size_t samples_count) {
+    std::vector<cf32> ones(samples_count, cf32(0.5f, 0.0f));
+    std::vector<cf32> tone(samples_count);
+    Nco nco(1.0, frequency);
+    nco.mix(ones.data(), tone.data(), samples_count);
+    std::vector<int16_t> iq(2 * samples_count);
+    cf32_to_cs16(tone.data(), iq.data(), samples_count);
+    return iq;
+}
+
+// Усиление цепочки на частоте frequency (доли входной частоты), дБ
+static double tone_gain_db(DecimatorChain& chain, double frequency, size_t output_samples) {
+    size_t samples_count = output_samples * chain.decimation();
+    std::vector<int16_t> iq = make_tone(frequency, samples_count);
+    std::vector<cf32> out(output_samples + 1);
+    chain.reset();
+    size_t produced = chain.process_cs16(iq.data(), samples_count, out.data());
+    // Первая четверть - переходный процесс фильтров
+    double power = 0;
+    for (size_t n = produced / 4; n < produced; ++n) power += std::norm(out[n]);
+    power /= produced - produced / 4;
+    return 10 * std::log10(power / 0.25 + 1e-30);
+}
+
+template <typename Process>
+static double measure_msps(size_t samples_count, Process process) {
+    auto start = std::chrono::steady_clock::now();
+    process();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return samples_count / seconds / 1e6;
+}
+
+// Использование:
+//   decim.out [rate=61.44e6] [decimation=64] [stages=4] [cic=0] [passband=0.2] [stopband=80]
+//             [input=capture.pcm output=decimated.pcm]
+// Без input - АЧХ на тестовых тонах и скорость в сравнении с одним КИХ на входной частоте
+int main(int argc, char** argv) {
+    DecimatorConfig config;
+    config.decimation = 64;
+    double sample_rate = 61.44e6;
+    std::string input, output;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "rate") sample_rate = atof(value);
+        else if (key == "decimation") config.decimation = strtoul(value, nullptr, 10);
+        else if (key == "stages") config.cic_stages = strtoul(value, nullptr, 10);
+        else if (key == "cic") config.cic_decimation = strtoul(value, nullptr, 10);
+        else if (key == "passband") config.passband = atof(value);
+        else if (key == "stopband") config.stopband_db = atof(value);
+        else if (key == "input") input = value;
+        else if (key == "output") output = value;
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    std::unique_ptr<DecimatorChain> chain;
+    try {
+        chain.reset(new DecimatorChain(config));
+    } catch (const std::invalid_argument& error) {
+        printf("%s\n", error.what());
+        return -1;
+    }
+
+    const double output_rate = sample_rate / config.decimation;
+    printf("%.2f МГц -> %.1f кГц: CIC R=%zu N=%zu", sample_rate / 1e6, output_rate / 1e3, chain->cic_decimation(),
+           config.cic_stages);
+    if (chain->compensator_taps()) printf(", компенсатор %zu отв. /2", chain->compensator_taps());
+    for (size_t k = 0; k < chain->halfband_count(); ++k) printf(", полуполосный %zu отв. /2", chain->halfband_taps(k));
+    printf("\n");
+
+    if (!input.empty()) {
+        CaptureFile capture;
+        if (!capture.open(input)) return -1;
+        FILE* file = output.empty() ? nullptr : fopen(output.c_str(), "wb");
+        if (!output.empty() && !file) {
+            printf("Не удалось создать файл: %s\n", output.c_str());
+            return -1;
+        }
+        std::vector<cf32> out(BLOCK_SIZE / config.decimation + 1);
+        std::vector<int16_t> iq(2 * out.size());
+        size_t produced = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t pos = 0; pos < capture.samples_count(); pos += BLOCK_SIZE) {
+            size_t n = std::min(BLOCK_SIZE, capture.samples_count() - pos);
+            size_t count = chain->process_cs16(capture.data() + 2 * pos, n, out.data());
+            if (file) {
+                cf32_to_cs16(out.data(), iq.data(), count);
+                fwrite(iq.data(), sizeof(int16_t), 2 * count, file);
+            }
+            produced += count;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (file) fclose(file);
+        printf("%zu -> %zu отсчетов, %.1f Мотсч/с\n", capture.samples_count(), produced,
+               capture.samples_count() / seconds / 1e6);
+        return 0;
+    }
+
+    // АЧХ: тоны в полосе и на частотах, которые после децимации попадают в полосу
+    const double fp = config.passband;
+    printf("\nЧастота (доли выходной)   Усиление, дБ\n");
+    const double in_band[] = {0.0, fp / 2, fp};
+    for (double f : in_band) {
+        printf("  %6.3f  полоса          %7.2f\n", f, tone_gain_db(*chain, f / config.decimation, 4096));
+    }
+    const double aliases[] = {1 - fp, 1 + fp / 2, 2 - fp / 2, 3 + fp, config.decimation / 4.0 + fp,
+                              config.decimation / 2.0 - fp};
+    for (double f : aliases) {
+        printf("  %6.3f  зеркало         %7.2f\n", f, tone_gain_db(*chain, f / config.decimation, 4096));
+    }
+
+    // Скорость на шумоподобном сигнале, блоками как из readStream
+    const size_t bench_samples = 1 << 24;
+    std::vector<int16_t> band(2 * BLOCK_SIZE);
+    uint32_t seed = 1;
+    for (int16_t& x : band) {
+        seed = seed * 1664525u + 1013904223u;
+        x = static_cast<int16_t>(static_cast<int32_t>(seed) >> 20);
+    }
+    std::vector<cf32> out(BLOCK_SIZE / config.decimation + 1);
+    chain->reset();
+    double chain_msps = measure_msps(bench_samples, [&] {
+        for (size_t done = 0; done < bench_samples; done += BLOCK_SIZE) {
+            chain->process_cs16(band.data(), BLOCK_SIZE, out.data());
+        }
+    });
+
+    // Для сравнения: один КИХ с той же полосой и подавлением на входной частоте
+    const double transition = (1 - 2 * fp) / config.decimation;
+    std::vector<float> single_taps =
+        design_lowpass(kaiser_length(config.stopband_db, transition), 0.5 / config.decimation, Window::Blackman);
+    FirDecimator single(single_taps, config.decimation);
+    std::vector<cf32> samples(BLOCK_SIZE);
+    cs16_to_cf32(band.data(), samples.data(), BLOCK_SIZE);
+    const size_t single_samples = bench_samples / 16;
+    double single_msps = measure_msps(single_samples, [&] {
+        for (size_t done = 0; done < single_samples; done += BLOCK_SIZE) {
+            single.process(samples.data(), BLOCK_SIZE, out.data());
+        }
+    });
+
+    printf("\nЦепочка: %.1f умножений на входной отсчет, %.1f Мотсч/с\n", chain->multiplies_per_input(), chain_msps);
+    printf("Один КИХ (%zu отв.): %.1f умножений на входной отсчет, %.1f Мотсч/с\n", single_taps.size(),
+           2.0 * single_taps.size() / config.decimation, single_msps);
+    return 0;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+// Расширяющие коды DSSS: Баркер, m-последовательности и коды Голда.
+// Чипы упакованы по 64 в слово, первый чип - младший бит; чип 0 -> +1, чип 1 -> -1
+// (как бит в мапперах). Заголовочный файл без зависимостей, подключается и из практик:
+// #include "../9_practice/src/dsss/codes.h"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct SpreadingCode {
+    std::vector<uint64_t> chips;
+    size_t length = 0;
+    std::string name;
+
+    int chip(size_t index) const { return (chips[index / 64] >> (index % 64)) & 1; }
+    // +1 / -1
+    int sign(size_t index) const { return 1 - 2 * chip(index); }
+};
+
+inline SpreadingCode code_from_bits(const std::vector<uint8_t>& bits, const std::string& name) {
+    SpreadingCode code;
+    code.length = bits.size();
+    code.name = name;
+    code.chips.assign((bits.size() + 63) / 64, 0);
+    for (size_t i = 0; i < bits.size(); ++i) code.chips[i / 64] |= uint64_t(bits[i] & 1) << (i % 64);
+    return code;
+}
+
+// Коды Баркера длины 7, 11, 13 (боковые лепестки автокорреляции не больше 1)
+inline SpreadingCode barker_code(size_t length) {
+    switch (length) {
+        case 7: return code_from_bits({0, 0, 0, 1, 1, 0, 1}, "barker7");
+        case 11: return code_from_bits({0, 0, 0, 1, 1, 1, 0, 1, 1, 0, 1}, "barker11");
+        case 13: return code_from_bits({0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 1, 0}, "barker13");
+    }
+    throw std::invalid_argument("Коды Баркера: длина 7, 11 или 13");
+}
+
+// Предпочтительные пары многочленов для кодов Голда: отводы без старшей степени,
+// рекурсия b[k] = XOR b[k - t] по t из {n, отводы}
+struct GoldPair {
+    int degree;
+    std::vector<int> first;
+    std::vector<int> second;
+};
+
+inline GoldPair gold_pair(int degree) {
+    switch (degree) {
+        case 5: return {5, {2}, {4, 3, 2}};
+        case 6: return {6, {1}, {5, 2, 1}};
+        case 7: return {7, {3}, {3, 2, 1}};
+        case 9: return {9, {4}, {6, 4, 3}};
+        case 10: return {10, {3}, {8, 3, 2}};     // первая - G1 из GPS C/A; вторая не G2, но пара тоже предпочтительная
+        case 11: return {11, {2}, {8, 5, 2}};
+    }
+    throw std::invalid_argument("Коды Голда: степень 5, 6, 7, 9, 10 или 11");
+}
+
+// m-последовательность длины 2^n - 1 по рекурсии b[k] = b[k - n] ^ XOR b[k - t]; начальное состояние - единицы
+inline std::vector<uint8_t> m_sequence_bits(int degree, const std::vector<int>& taps) {
+    size_t length = (size_t(1) << degree) - 1;
+    std::vector<uint8_t> bits(length + degree);
+    for (int k = 0; k < degree; ++k) bits[k] = 1;
+    for (size_t k = degree; k < bits.size(); ++k) {
+        uint8_t value = bits[k - degree];
+        for (int t : taps) value ^= bits[k - t];
+        bits[k] = value;
+    }
+    bits.resize(length);
+    return bits;
+}
+
+// m-последовательность: первый многочлен предпочтительной пары степени degree
+inline SpreadingCode m_sequence_code(int degree) {
+    GoldPair pair = gold_pair(degree);
+    return code_from_bits(m_sequence_bits(degree, pair.first), "m" + std::to_string(degree));
+}
+
+// Код Голда с номером index: 0 и 1 - сами m-последовательности пары,
+// 2 + s - их сумма со сдвигом s второй последовательности (s < 2^n - 1)
+inline SpreadingCode gold_code(int degree, size_t index) {
+    GoldPair pair = gold_pair(degree);
+    std::vector<uint8_t> a = m_sequence_bits(degree, pair.first);
+    std::vector<uint8_t> b = m_sequence_bits(degree, pair.second);
+    size_t length = a.size();
+    if (index >= length + 2) throw std::invalid_argument("Номер кода Голда больше 2^n");
+
+    std::vector<uint8_t> bits(length);
+    for (size_t i = 0; i < length; ++i) {
+        if (index == 0) bits[i] = a[i];
+        else if (index == 1) bits[i] = b[i];
+        else bits[i] = a[i] ^ b[(i + index - 2) % length];
+    }
+    return code_from_bits(bits, "gold" + std::to_string(degree) + "/" + std::to_string(index));
+}
+
+// Расширение: каждый символ умножается на весь код, out - count * code.length чипов.
+// Чипы читаются словами, знак меняется без умножения
+template <typename T>
+void dsss_spread(const std::complex<T>* symbols, size_t count, const SpreadingCode& code, std::complex<T>* out) {
+    for (size_t s = 0; s < count; ++s) {
+        const std::complex<T> positive = symbols[s], negative = -symbols[s];
+        std::complex<T>* chips_out = out + s * code.length;
+        for (size_t c = 0; c < code.length; c += 64) {
+            uint64_t word = code.chips[c / 64];
+            size_t n = code.length - c < 64 ? code.length - c : 64;
+            for (size_t b = 0; b < n; ++b) chips_out[c + b] = (word >> b) & 1 ? negative : positive;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstring>
+
+#include "dsss/despreader.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define DSSS_HAVE_SSE2 1
+#endif
+
+constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+static float flip(float value, uint32_t mask) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits ^= mask;
+    memcpy(&value, &bits, sizeof(bits));
+    return value;
+}
+
+DsssDespreader::DsssDespreader(const SpreadingCode& code) : length(code.length), masks(code.length) {
+    // Запас в четыре чипа: векторный цикл сжатия читает маски блоками
+    pair_masks.assign(2 * length + 4, 0);
+    for (size_t c = 0; c < length; ++c) {
+        masks[c] = code.chip(c) ? SIGN_BIT : 0;
+        pair_masks[2 * c] = pair_masks[2 * c + 1] = masks[c];
+    }
+}
+
+bool DsssDespreader::acquire(const cf32* in, size_t samples_count, size_t periods, DsssAcquisition& result,
+                             std::vector<float>* metric) const {
+    if (periods == 0 || samples_count < acquisition_samples(periods)) return false;
+
+    const size_t blocks = (length + DSSS_PHASE_BLOCK - 1) / DSSS_PHASE_BLOCK;
+    std::vector<float> power(blocks * DSSS_PHASE_BLOCK, 0.0f);
+    const float* x = reinterpret_cast<const float*>(in);
+
+    for (size_t period = 0; period < periods; ++period) {
+        for (size_t block = 0; block < blocks; ++block) {
+            // Фазы p .. p + 7 периода period: окна начинаются с отсчетов start .. start + 7
+            const float* window = x + 2 * (period * length + block * DSSS_PHASE_BLOCK);
+            float corr[2 * DSSS_PHASE_BLOCK];
+#ifdef DSSS_HAVE_SSE2
+            __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+            for (size_t c = 0; c < length; ++c) {
+                __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(masks[c])));
+                const float* chip = window + 2 * c;
+                acc0 = _mm_add_ps(acc0, _mm_xor_ps(_mm_loadu_ps(chip), sign));
+                acc1 = _mm_add_ps(acc1, _mm_xor_ps(_mm_loadu_ps(chip + 4), sign));
+                acc2 = _mm_add_ps(acc2, _mm_xor_ps(_mm_loadu_ps(chip + 8), sign));
+                acc3 = _mm_add_ps(acc3, _mm_xor_ps(_mm_loadu_ps(chip + 12), sign));
+            }
+            _mm_storeu_ps(corr, acc0);
+            _mm_storeu_ps(corr + 4, acc1);
+            _mm_storeu_ps(corr + 8, acc2);
+            _mm_storeu_ps(corr + 12, acc3);
+#else
+            std::fill(corr, corr + 2 * DSSS_PHASE_BLOCK, 0.0f);
+            for (size_t c = 0; c < length; ++c) {
+                const float* chip = window + 2 * c;
+                for (size_t k = 0; k < 2 * DSSS_PHASE_BLOCK; ++k) corr[k] += flip(chip[k], masks[c]);
+            }
+#endif
+            for (size_t p = 0; p < DSSS_PHASE_BLOCK; ++p) {
+                power[block * DSSS_PHASE_BLOCK + p] += corr[2 * p] * corr[2 * p] + corr[2 * p + 1] * corr[2 * p + 1];
+            }
+        }
+    }
+
+    power.resize(length);
+    size_t best = std::max_element(power.begin(), power.end()) - power.begin();
+    double others = 0;
+    for (size_t p = 0; p < length; ++p) {
+        if (p != best) others += power[p];
+    }
+    others = length > 1 ? others / (length - 1) : 0.0;
+    result.phase = best;
+    result.peak_ratio = others > 0 ? static_cast<float>(power[best] / others) : 0.0f;
+    if (metric) metric->swap(power);
+    return true;
+}
+
+size_t DsssDespreader::despread(const cf32* in, size_t samples_count, cf32* symbols) const {
+    const size_t count = samples_count / length;
+    const float scale = 1.0f / length;
+    const uint32_t* pm = pair_masks.data();
+
+    for (size_t s = 0; s < count; ++s) {
+        const float* x = reinterpret_cast<const float*>(in + s * length);
+        size_t c = 0;
+        float sum_i = 0, sum_q = 0;
+#ifdef DSSS_HAVE_SSE2
+        // Два чипа (I, Q, I, Q) на регистр, два регистра за итерацию
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        for (; c + 4 <= length; c += 4) {
+            __m128 m0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pm + 2 * c)));
+            __m128 m1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pm + 2 * c + 4)));
+            acc0 = _mm_add_ps(acc0, _mm_xor_ps(_mm_loadu_ps(x + 2 * c), m0));
+            acc1 = _mm_add_ps(acc1, _mm_xor_ps(_mm_loadu_ps(x + 2 * c + 4), m1));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+        sum_i = lanes[0] + lanes[2];
+        sum_q = lanes[1] + lanes[3];
+#endif
+        for (; c < length; ++c) {
+            sum_i += flip(x[2 * c], masks[c]);
+            sum_q += flip(x[2 * c + 1], masks[c]);
+        }
+        symbols[s] = cf32(sum_i * scale, sum_q * scale);
+    }
+    return count;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+#include "dsss/codes.h"
+#include "sub_funcs.h"
+
+// Прием DSSS на частоте чипов (один отсчет на чип после синхронизации по чипам).
+// Знаки кода хранятся как маски знакового бита float: умножение на +-1 - это XOR,
+// а комплексные отсчеты обрабатываются прямо в чередовании I, Q.
+//
+// Поиск: банк корреляторов по всем фазам кода сразу. Внешний цикл - по чипам кода,
+// внутренний - по DSSS_PHASE_BLOCK соседним фазам, которые накапливаются в векторных
+// регистрах (SSE2: два комплексных отсчета на регистр). Корреляции периодов складываются
+// некогерентно (|.|^2), поэтому данные на символах поиску не мешают.
+
+constexpr size_t DSSS_PHASE_BLOCK = 8;
+
+struct DsssAcquisition {
+    size_t phase = 0;        // сдвиг начала кода относительно начала блока, чипов
+    float peak_ratio = 0;    // пик к среднему по остальным фазам
+};
+
+class DsssDespreader {
+public:
+    explicit DsssDespreader(const SpreadingCode& code);
+
+    size_t code_length() const { return length; }
+
+    // Отсчетов, нужных для поиска по periods периодам
+    size_t acquisition_samples(size_t periods) const { return (periods + 1) * length + DSSS_PHASE_BLOCK; }
+
+    // Корреляция по всем фазам; metric - сумма |корреляции|^2 по periods периодам (если не nullptr)
+    bool acquire(const cf32* in, size_t samples_count, size_t periods, DsssAcquisition& result,
+                 std::vector<float>* metric = nullptr) const;
+
+    // Сжатие: символ = среднее по периоду кода, начиная с in; возвращает число символов
+    size_t despread(const cf32* in, size_t samples_count, cf32* symbols) const;
+
+private:
+    size_t length;
+    std::vector<uint32_t> masks;        // маска знака на чип
+    std::vector<uint32_t> pair_masks;   // то же, продублировано для I и Q
+};
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "dsss/despreader.h"
+#include "modulation/mapper.h"
+#include "prbs/prbs.h"
+#include "simulation/ber_sim.h"
+
+// barker7/11/13, m<n>, gold<n> для n из gold_pair()
+static bool make_code(const std::string& name, size_t index, SpreadingCode& code) {
+    try {
+        if (name.rfind("barker", 0) == 0) code = barker_code(strtoul(name.c_str() + 6, nullptr, 10));
+        else if (name.rfind("gold", 0) == 0) code = gold_code(atoi(name.c_str() + 4), index);
+        else if (name.rfind("m", 0) == 0) code = m_sequence_code(atoi(name.c_str() + 1));
+        else return false;
+    } catch (const std::invalid_argument& error) {
+        printf("%s\n", error.what());
+        return false;
+    }
+    return true;
+}
+
+// Максимум модуля периодической взаимной корреляции двух кодов одной длины
+static int max_cross_correlation(const SpreadingCode& a, const SpreadingCode& b) {
+    int worst = 0;
+    for (size_t shift = 0; shift < a.length; ++shift) {
+        int sum = 0;
+        for (size_t i = 0; i < a.length; ++i) sum += a.sign(i) * b.sign((i + shift) % a.length);
+        worst = std::max(worst, std::abs(sum));
+    }
+    return worst;
+}
+
+// Использование:
+//   dsss.out [code=barker11] [index=2] [symbols=20000] [snr=-5] [jsr=-100] [jammer=0.05] [periods=4]
+// code  - barker7|barker11|barker13|m<n>|gold<n> (n = 5, 6, 7, 9, 10, 11), index - номер кода Голда
+// snr   - отношение сигнал/шум на чип, дБ; jsr - мощность гармонической помехи относительно сигнала, дБ
+// jammer - частота помехи в долях чиповой скорости
+int main(int argc, char** argv) {
+    std::string code_name = "barker11";
+    size_t index = 2;
+    size_t symbols_count = 20000;
+    size_t periods = 4;
+    double snr_db = -5.0;
+    double jsr_db = -100.0;
+    double jammer_freq = 0.05;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "code") code_name = value;
+        else if (key == "index") index = strtoul(value, nullptr, 10);
+        else if (key == "symbols") symbols_count = strtoul(value, nullptr, 10);
+        else if (key == "periods") periods = strtoul(value, nullptr, 10);
+        else if (key == "snr") snr_db = atof(value);
+        else if (key == "jsr") jsr_db = atof(value);
+        else if (key == "jammer") jammer_freq = atof(value);
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    SpreadingCode code;
+    if (!make_code(code_name, index, code)) {
+        printf("Неверный код: %s\n", code_name.c_str());
+        return -1;
+    }
+    if (symbols_count < periods + 2 || periods == 0) {
+        printf("symbols > periods + 1, periods > 0\n");
+        return -1;
+    }
+    const size_t length = code.length;
+    printf("Код %s: %zu чипов, выигрыш обработки %.1f дБ\n", code.name.c_str(), length, 10 * std::log10(length));
+
+    if (code_name.rfind("gold", 0) == 0) {
+        int degree = atoi(code_name.c_str() + 4);
+        SpreadingCode neighbour = gold_code(degree, index + 1 < length + 2 ? index + 1 : 2);
+        int bound = (1 << ((degree + 2) / 2)) + 1;
+        printf("Взаимная корреляция с %s: %d (граница Голда %d)\n", neighbour.name.c_str(),
+               max_cross_correlation(code, neighbour), bound);
+    }
+
+    // Передача: BPSK, символ на период кода, перед пакетом случайное число чипов шума
+    std::vector<uint8_t> bits(symbols_count);
+    PrbsGenerator(PrbsType::PRBS23).fill_bits(bits.data(), bits.size());
+    std::vector<cf32> symbols(symbols_count);
+    bpsk_map(bits.data(), bits.size(), symbols.data());
+
+    std::mt19937 gen(1);
+    const size_t offset = std::uniform_int_distribution<size_t>(0, length - 1)(gen);
+    std::vector<cf32> rx(offset + symbols_count * length + DSSS_PHASE_BLOCK);
+    dsss_spread(symbols.data(), symbols_count, code, rx.data() + offset);
+
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(std::pow(10, -snr_db / 10) / 2)));
+    const float jammer_amplitude = static_cast<float>(std::pow(10, jsr_db / 20));
+    for (size_t n = 0; n < rx.size(); ++n) {
+        rx[n] += cf32(noise(gen), noise(gen)) + std::polar(jammer_amplitude, static_cast<float>(2 * PI * jammer_freq * n));
+    }
+
+    // Поиск фазы кода: периоды с данными, некогерентное накопление
+    DsssDespreader despreader(code);
+    DsssAcquisition acquisition;
+    if (!despreader.acquire(rx.data(), rx.size(), periods, acquisition)) {
+        printf("Мало отсчетов для поиска\n");
+        return -1;
+    }
+    printf("Поиск: фаза %zu (истинная %zu), пик/среднее %.1f\n", acquisition.phase, offset, acquisition.peak_ratio);
+
+    std::vector<cf32> despread(symbols_count);
+    size_t produced = despreader.despread(rx.data() + acquisition.phase, symbols_count * length, despread.data());
+    std::vector<uint8_t> decided(produced);
+    bpsk_demap(despread.data(), produced, decided.data());
+    size_t errors = 0;
+    for (size_t n = 0; n < produced; ++n) errors += decided[n] != bits[n];
+
+    // Eb/N0 после сжатия: энергия символа - length чипов
+    double ebn0_db = snr_db + 10 * std::log10(length);
+    printf("BER %.3e на %zu битах, теория BPSK при Eb/N0 %.1f дБ: %.3e\n", static_cast<double>(errors) / produced,
+           produced, ebn0_db, theoretical_ber(ebn0_db));
+
+    // Скорость: сжатие и банк корреляторов (length фаз на каждый чип)
+    const size_t bench_chips = 50000000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < bench_chips; done += symbols_count * length) {
+        despreader.despread(rx.data(), symbols_count * length, despread.data());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Сжатие: %.1f Мчип/с\n", bench_chips / seconds / 1e6);
+
+    const size_t bench_periods = std::min(symbols_count - 1, std::max<size_t>(1, 2000000 / (length * length)));
+    start = std::chrono::steady_clock::now();
+    despreader.acquire(rx.data(), rx.size(), bench_periods, acquisition);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Поиск: %.1f Мчип/с по всем %zu фазам (%.0f Мкорр/с)\n", bench_periods * length / seconds / 1e6, length,
+           bench_periods * length * length / seconds / 1e6);
+    return 0;
+}
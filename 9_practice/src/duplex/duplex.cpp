@@ -0,0 +1,162 @@
+#include <chrono>
+#include <cstdio>
+
+#include "duplex/duplex.h"
+
+static long long monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void DeviceClock::update(long long device_ns) {
+    // Две атомарные записи не согласованы между собой: погрешность - один буфер,
+    // что намного меньше запаса tx_lead_ns
+    anchor_local = monotonic_ns();
+    anchor_device = device_ns;
+    valid = true;
+}
+
+bool DeviceClock::now(long long& device_ns) const {
+    if (!valid) return false;
+    device_ns = anchor_device + (monotonic_ns() - anchor_local);
+    return true;
+}
+
+DuplexEngine::DuplexEngine(RxStream& rx, TxStream& tx, double sample_rate, const DuplexConfig& config,
+                           RxHandler rx_handler, TxSource tx_source)
+    : rx(rx), tx(tx), sample_rate(sample_rate), config(config), rx_handler(std::move(rx_handler)),
+      tx_source(std::move(tx_source)), rx_buffer(2 * rx.mtu()), tx_buffer(2 * tx.mtu()),
+      rx_jitter(rx.mtu() * 1e9 / sample_rate), tx_jitter(tx.mtu() * 1e9 / sample_rate) {
+    if (config.lock_memory) {
+        lock_buffer(rx_buffer.data(), rx_buffer.size() * sizeof(int16_t));
+        lock_buffer(tx_buffer.data(), tx_buffer.size() * sizeof(int16_t));
+    }
+}
+
+DuplexEngine::~DuplexEngine() {
+    stop();
+    if (config.lock_memory) {
+        unlock_buffer(rx_buffer.data(), rx_buffer.size() * sizeof(int16_t));
+        unlock_buffer(tx_buffer.data(), tx_buffer.size() * sizeof(int16_t));
+    }
+}
+
+void DuplexEngine::start() {
+    if (active) return;
+    active = true;
+    rx_thread = std::thread(&DuplexEngine::rx_loop, this);
+    tx_thread = std::thread(&DuplexEngine::tx_loop, this);
+}
+
+void DuplexEngine::stop() {
+    active = false;
+    if (rx_thread.joinable()) rx_thread.join();
+    if (tx_thread.joinable()) tx_thread.join();
+}
+
+DuplexStats DuplexEngine::stats() const {
+    DuplexStats result;
+    result.rx_samples = rx_samples;
+    result.tx_samples = tx_samples;
+    result.overflows = overflows;
+    result.underflows = underflows;
+    result.rx_jitter = rx_jitter.stats();
+    result.tx_jitter = tx_jitter.stats();
+    return result;
+}
+
+void DuplexEngine::rx_loop() {
+    apply_realtime(config.rx, "sdr-rx");
+
+    // С прямым доступом обработчик получает память драйвера, иначе - свой (mlock) буфер
+    const bool direct = rx.direct_buffers() > 0;
+    uint64_t counted = 0;
+    while (active) {
+        RxView view;
+        long result;
+        if (direct) {
+            result = rx.acquire(view, config.timeout_us);
+        } else {
+            result = rx.read(rx_buffer.data(), rx.mtu(), &view.time_ns, &view.flags, config.timeout_us);
+            view.iq = rx_buffer.data();
+        }
+        rx_jitter.mark();
+        long long time_ns = view.time_ns;
+        int flags = view.flags;
+        if (result < 0) {
+            printf("Ошибка приема: %ld\n", result);
+            break;
+        }
+        // Переполнение приходит с результатом 0: учитываем и продолжаем прием
+        if (flags & STREAM_OVERFLOW) overflows++;
+        if (result == 0) continue;
+
+        // Без аппаратных меток часы ведутся по числу принятых отсчетов
+        if (!(flags & STREAM_HAS_TIME)) time_ns = static_cast<long long>(counted * 1e9 / sample_rate);
+        device_clock.update(time_ns);
+        counted += result;
+
+        rx_handler(view.iq, static_cast<size_t>(result), time_ns);
+        if (direct) rx.release(view);
+        rx_samples += result;
+    }
+    active = false;
+}
+
+void DuplexEngine::tx_loop() {
+    apply_realtime(config.tx, "sdr-tx");
+
+    // Ждем первую метку приема, чтобы поставить передачу на общую шкалу времени
+    long long now_ns = 0;
+    while (active && !device_clock.now(now_ns)) std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    long long next_ns = now_ns + config.tx_lead_ns;
+    int flags = STREAM_HAS_TIME;
+    const bool direct = tx.direct_buffers() > 0;
+    // Без прямого доступа write может взять часть буфера (или ничего по таймауту):
+    // остаток досылается с того же места, источник заново не вызывается
+    size_t sent = 0, pending = 0;
+
+    while (active) {
+        long result;
+        if (direct) {
+            // Источник пишет сразу в буфер драйвера; release отдает буфер целиком
+            TxView view;
+            result = tx.acquire(view, config.timeout_us);
+            if (result > 0) {
+                tx_source(view.iq, view.samples, next_ns);
+                result = tx.release(view, view.samples, next_ns, flags, config.timeout_us);
+            }
+        } else {
+            if (sent == pending) {
+                tx_source(tx_buffer.data(), tx.mtu(), next_ns);
+                sent = 0;
+                pending = tx.mtu();
+            }
+            result = tx.write(tx_buffer.data() + 2 * sent, pending - sent, next_ns, flags, config.timeout_us);
+            if (result > 0) sent += static_cast<size_t>(result);
+        }
+        tx_jitter.mark();
+        if (result < 0) {
+            printf("Ошибка передачи: %ld\n", result);
+            break;
+        }
+        // Ничего не ушло - метка и флаг остаются для следующей попытки
+        if (result > 0) {
+            flags = 0;
+            next_ns += static_cast<long long>(result * 1e9 / sample_rate);
+            tx_samples += result;
+        }
+
+        // После опустошения или отставания от часов - новая метка с запасом
+        long long event_ns = 0;
+        bool underflow = tx.poll_underflow(&event_ns, 0);
+        if (device_clock.now(now_ns) && next_ns < now_ns) underflow = true;
+        if (underflow) {
+            underflows++;
+            next_ns = now_ns + config.tx_lead_ns;
+            flags = STREAM_HAS_TIME;
+        }
+    }
+    active = false;
+}
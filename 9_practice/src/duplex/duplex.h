@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "duplex/realtime.h"
+#include "sdr/device.h"
+
+// Полный дуплекс: прием и передача в отдельных потоках вместо одного цикла
+// readStream/writeStream, поэтому задержка одного направления не сдвигает другое.
+// Общие часы - время устройства: поток приема обновляет привязку по меткам RX,
+// поток передачи ставит первый буфер на "сейчас + tx_lead_ns" и дальше идет встык.
+
+struct DuplexConfig {
+    RealtimeConfig rx;
+    RealtimeConfig tx;
+    bool lock_memory = false;       // mlock своих буферов (при копирующем пути)
+    long long tx_lead_ns = 4000000; // запас времени передачи относительно приема (4 мс, как в практиках)
+    long timeout_us = 100000;
+};
+
+// Время устройства по последней метке приема и монотонным часам
+class DeviceClock {
+public:
+    void update(long long device_ns);
+    // false, пока не пришла ни одна метка
+    bool now(long long& device_ns) const;
+
+private:
+    std::atomic<long long> anchor_device{0};
+    std::atomic<long long> anchor_local{0};
+    std::atomic<bool> valid{false};
+};
+
+struct DuplexStats {
+    uint64_t rx_samples = 0;
+    uint64_t tx_samples = 0;
+    uint64_t overflows = 0;
+    uint64_t underflows = 0;
+    JitterStats rx_jitter;
+    JitterStats tx_jitter;
+};
+
+class DuplexEngine {
+public:
+    // Принятый блок; вызывается в потоке приема
+    using RxHandler = std::function<void(const int16_t* iq, size_t samples_count, long long time_ns)>;
+    // Заполнить блок передачи; вызывается в потоке передачи
+    using TxSource = std::function<void(int16_t* iq, size_t samples_count, long long time_ns)>;
+
+    DuplexEngine(RxStream& rx, TxStream& tx, double sample_rate, const DuplexConfig& config,
+                 RxHandler rx_handler, TxSource tx_source);
+    ~DuplexEngine();
+
+    DuplexEngine(const DuplexEngine&) = delete;
+    DuplexEngine& operator=(const DuplexEngine&) = delete;
+
+    void start();
+    void stop();
+
+    DuplexStats stats() const;
+    const DeviceClock& clock() const { return device_clock; }
+
+private:
+    void rx_loop();
+    void tx_loop();
+
+    RxStream& rx;
+    TxStream& tx;
+    double sample_rate;
+    DuplexConfig config;
+    RxHandler rx_handler;
+    TxSource tx_source;
+
+    std::vector<int16_t> rx_buffer;
+    std::vector<int16_t> tx_buffer;
+
+    DeviceClock device_clock;
+    JitterMeter rx_jitter;
+    JitterMeter tx_jitter;
+
+    std::thread rx_thread;
+    std::thread tx_thread;
+    std::atomic<bool> active{false};
+
+    std::atomic<uint64_t> rx_samples{0};
+    std::atomic<uint64_t> tx_samples{0};
+    std::atomic<uint64_t> overflows{0};
+    std::atomic<uint64_t> underflows{0};
+};
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "duplex/duplex.h"
+#include "nco/nco.h"
+
+static void print_jitter(const char* name, const JitterStats& s) {
+    printf("  %s: %llu итераций, период %.1f мкс, среднее %.1f ± %.1f мкс, [%.1f, %.1f], опозданий %llu\n", name,
+           (unsigned long long)s.iterations, s.expected_us, s.mean_us, s.stddev_us, s.min_us, s.max_us,
+           (unsigned long long)s.late);
+}
+
+// Использование: duplex.out backend=... uri=... [seconds=10] [rx_cpu=2] [tx_cpu=3]
+//                           [priority=80] [mlock=1] [lead_us=4000] [tone=100000]
+// Backend file не ограничивает скорость чтения, поэтому джиттер и опустошения
+// осмысленны только на радио; с SCHED_FIFO на общем ядре он займет процессор целиком.
+int main(int argc, char** argv) {
+    DeviceConfig device_config;
+    DuplexConfig config;
+    double seconds = 10.0;
+    double tone = 100000.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "seconds") seconds = atof(value);
+        else if (key == "rx_cpu") config.rx.cpu = atoi(value);
+        else if (key == "tx_cpu") config.tx.cpu = atoi(value);
+        else if (key == "priority") config.rx.priority = config.tx.priority = atoi(value);
+        else if (key == "mlock") config.lock_memory = atoi(value) != 0;
+        else if (key == "lead_us") config.tx_lead_ns = static_cast<long long>(atof(value) * 1000);
+        else if (key == "tone") tone = atof(value);
+        else if (!parse_device_arg(arg, device_config)) {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    std::unique_ptr<Device> device = make_device(device_config);
+    if (!device) return -1;
+    std::unique_ptr<RxStream> rx = device->open_rx();
+    std::unique_ptr<TxStream> tx = device->open_tx();
+    if (!rx || !tx) {
+        printf("Не удалось открыть потоки\n");
+        return -1;
+    }
+
+    // Прием: средняя мощность; передача: тон через NCO
+    std::atomic<double> rx_power{0.0};
+    Nco nco(device_config.sample_rate, tone);
+    std::vector<cf32> tone_block(tx->mtu(), cf32(0.5f, 0.0f));
+
+    DuplexEngine engine(
+        *rx, *tx, device_config.sample_rate, config,
+        [&](const int16_t* iq, size_t n, long long) {
+            double sum = 0;
+            for (size_t k = 0; k < 2 * n; ++k) sum += double(iq[k]) * iq[k];
+            rx_power = sum / n / (CS16_FULL_SCALE * CS16_FULL_SCALE);
+        },
+        [&](int16_t* iq, size_t n, long long) {
+            // В прямом режиме буфер драйвера может быть больше mtu()
+            if (tone_block.size() < n) tone_block.resize(n);
+            std::fill(tone_block.begin(), tone_block.begin() + n, cf32(0.5f, 0.0f));
+            nco.mix(tone_block.data(), tone_block.data(), n);
+            cf32_to_cs16(tone_block.data(), iq, n);
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    engine.start();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        DuplexStats s = engine.stats();
+        printf("RX %llu, TX %llu отсчетов, мощность RX %.1f дБFS, переполнений %llu, опустошений %llu\n",
+               (unsigned long long)s.rx_samples, (unsigned long long)s.tx_samples,
+               10 * std::log10(rx_power + 1e-20), (unsigned long long)s.overflows,
+               (unsigned long long)s.underflows);
+    }
+    engine.stop();
+
+    DuplexStats s = engine.stats();
+    printf("Джиттер итераций:\n");
+    print_jitter("RX", s.rx_jitter);
+    print_jitter("TX", s.tx_jitter);
+    return 0;
+}
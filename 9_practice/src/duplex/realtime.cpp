@@ -0,0 +1,103 @@
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "duplex/realtime.h"
+
+bool apply_realtime(const RealtimeConfig& config, const char* thread_name) {
+    bool ok = true;
+    pthread_t self = pthread_self();
+
+    if (thread_name) pthread_setname_np(self, thread_name);
+
+    if (config.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        int error = pthread_setaffinity_np(self, sizeof(set), &set);
+        if (error) {
+            printf("%s: не удалось привязать к ядру %d: %s\n", thread_name, config.cpu, strerror(error));
+            ok = false;
+        }
+    }
+
+    if (config.priority > 0) {
+        sched_param param = {};
+        param.sched_priority = config.priority;
+        int error = pthread_setschedparam(self, SCHED_FIFO, &param);
+        if (error) {
+            printf("%s: SCHED_FIFO %d недоступен: %s\n", thread_name, config.priority, strerror(error));
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool lock_buffer(const void* data, size_t size) {
+    if (mlock(data, size) != 0) {
+        printf("mlock %zu байт: %s\n", size, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void unlock_buffer(const void* data, size_t size) {
+    munlock(data, size);
+}
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+JitterMeter::JitterMeter(double expected_period_ns) : expected_ns(expected_period_ns) {}
+
+void JitterMeter::set_expected(double period_ns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    expected_ns = period_ns;
+}
+
+void JitterMeter::mark() {
+    int64_t now = monotonic_ns();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (last_ns != 0) {
+        double interval = static_cast<double>(now - last_ns);
+        if (count == 0 || interval < minimum) minimum = interval;
+        if (count == 0 || interval > maximum) maximum = interval;
+        sum += interval;
+        sum_squares += interval * interval;
+        if (expected_ns > 0 && interval > 2 * expected_ns) late++;
+        count++;
+    }
+    last_ns = now;
+}
+
+JitterStats JitterMeter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    JitterStats result;
+    result.iterations = count;
+    result.expected_us = expected_ns / 1e3;
+    if (count == 0) return result;
+    double mean = sum / count;
+    result.mean_us = mean / 1e3;
+    result.stddev_us = std::sqrt(std::max(0.0, sum_squares / count - mean * mean)) / 1e3;
+    result.min_us = minimum / 1e3;
+    result.max_us = maximum / 1e3;
+    result.late = late;
+    return result;
+}
+
+void JitterMeter::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    last_ns = 0;
+    count = 0;
+    sum = sum_squares = minimum = maximum = 0;
+    late = 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Настройки потока реального времени; по умолчанию ничего не меняется
+struct RealtimeConfig {
+    int cpu = -1;          // ядро для привязки, -1 - без привязки
+    int priority = 0;      // приоритет SCHED_FIFO (1..99), 0 - обычный планировщик
+};
+
+// Применяется к вызывающему потоку. Ошибки (нет прав на SCHED_FIFO и т.п.)
+// печатаются, поток продолжает работать с прежними настройками.
+bool apply_realtime(const RealtimeConfig& config, const char* thread_name);
+
+// Закрепление буфера в памяти, чтобы обращение к нему не вызывало подкачку
+bool lock_buffer(const void* data, size_t size);
+void unlock_buffer(const void* data, size_t size);
+
+// Интервалы между итерациями цикла относительно ожидаемого периода.
+// Статистику можно читать из другого потока во время работы.
+struct JitterStats {
+    uint64_t iterations = 0;
+    double expected_us = 0;
+    double mean_us = 0;
+    double stddev_us = 0;
+    double min_us = 0;
+    double max_us = 0;
+    uint64_t late = 0;     // интервалов длиннее двух периодов
+};
+
+class JitterMeter {
+public:
+    explicit JitterMeter(double expected_period_ns = 0);
+
+    void set_expected(double period_ns);
+    // Отметка начала итерации; первая отметка только запоминает время
+    void mark();
+    JitterStats stats() const;
+    void reset();
+
+private:
+    mutable std::mutex mutex;
+    double expected_ns;
+    int64_t last_ns = 0;
+    uint64_t count = 0;
+    double sum = 0;
+    double sum_squares = 0;
+    double minimum = 0;
+    double maximum = 0;
+    uint64_t late = 0;
+};
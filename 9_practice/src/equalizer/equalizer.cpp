@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "equalizer/equalizer.h"
+#include "modulation/mapper.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define EQ_HAVE_SSE2 1
+#endif
+
+// Сглаживание MSE и дисперсии модуля: ~200 символов
+constexpr float EQ_MSE_ALPHA = 0.005f;
+
+AdaptiveEqualizer::AdaptiveEqualizer(const EqualizerConfig& config)
+    : config(config),
+      padded_taps((std::max<size_t>(config.taps, 1) + EQ_LANES - 1) / EQ_LANES * EQ_LANES),
+      taps_i(padded_taps),
+      taps_q(padded_taps),
+      tap_mask(padded_taps) {
+    if (this->config.taps == 0) this->config.taps = 1;
+    if (this->config.samples_per_symbol == 0) this->config.samples_per_symbol = 1;
+    // Окно текущего символа и окно символа на EQ_UPDATE_DELAY раньше (для запаздывающего обновления)
+    history = padded_taps + EQ_UPDATE_DELAY * this->config.samples_per_symbol - 1;
+
+    // Все биты единицы для занятых отводов, ноль - для добавленных до кратности EQ_LANES
+    uint32_t ones = 0xFFFFFFFFu;
+    for (size_t j = padded_taps - this->config.taps; j < padded_taps; ++j) memcpy(&tap_mask[j], &ones, sizeof(ones));
+    reset();
+}
+
+void AdaptiveEqualizer::reset() {
+    std::fill(taps_i.begin(), taps_i.end(), 0.0f);
+    std::fill(taps_q.begin(), taps_q.end(), 0.0f);
+    taps_i[padded_taps - 1 - config.taps / 2] = 1.0f;
+    line_i.assign(history, 0.0f);
+    line_q.assign(history, 0.0f);
+    phase = 0;
+    std::fill(pending_error, pending_error + EQ_UPDATE_DELAY, cf32(0.0f, 0.0f));
+    current_mode = EqualizerMode::CMA;
+    error_power = 1.0f;
+    dispersion = 1.0f;
+}
+
+std::vector<cf32> AdaptiveEqualizer::taps() const {
+    std::vector<cf32> result(config.taps);
+    for (size_t k = 0; k < config.taps; ++k) result[k] = cf32(taps_i[padded_taps - 1 - k], taps_q[padded_taps - 1 - k]);
+    return result;
+}
+
+// Свертка, обновление и решение - функции файла, а не члены класса: в библиотеке с -fPIC
+// внешние функции могут быть подменены при загрузке, и компилятор не встраивает их в цикл.
+
+// Свертка и запаздывающее обновление за один проход по отводам:
+//   y = sum w[j] x[j] по окну текущего символа (отводы до обновления),
+//   w[j] -= e * conj(p[j]) по окну символа, чья ошибка e (уже со шагом) применяется,
+//   только для занятых отводов. Каждый отвод читается и записывается один раз.
+// Masked = false - число отводов кратно EQ_LANES, маска не нужна (16 отводов по умолчанию).
+template <bool Masked>
+static cf32 filter_update(float* wi, float* wq, const float* xi, const float* xq, const float* pi,
+                          const float* pq, const float* mask, size_t padded_taps, cf32 error) {
+    const float ei = error.real(), eq = error.imag();
+#ifdef EQ_HAVE_SSE2
+    const __m128 e_i = _mm_set1_ps(ei), e_q = _mm_set1_ps(eq);
+    __m128 acc_i = _mm_setzero_ps(), acc_q = _mm_setzero_ps();
+    for (size_t j = 0; j < padded_taps; j += EQ_LANES) {
+        __m128 w_i = _mm_loadu_ps(wi + j), w_q = _mm_loadu_ps(wq + j);
+        __m128 x_i = _mm_loadu_ps(xi + j), x_q = _mm_loadu_ps(xq + j);
+        acc_i = _mm_add_ps(acc_i, _mm_sub_ps(_mm_mul_ps(w_i, x_i), _mm_mul_ps(w_q, x_q)));
+        acc_q = _mm_add_ps(acc_q, _mm_add_ps(_mm_mul_ps(w_i, x_q), _mm_mul_ps(w_q, x_i)));
+
+        __m128 p_i = _mm_loadu_ps(pi + j), p_q = _mm_loadu_ps(pq + j);
+        __m128 d_i = _mm_add_ps(_mm_mul_ps(e_i, p_i), _mm_mul_ps(e_q, p_q));
+        __m128 d_q = _mm_sub_ps(_mm_mul_ps(e_q, p_i), _mm_mul_ps(e_i, p_q));
+        if (Masked) {
+            __m128 m = _mm_loadu_ps(mask + j);
+            d_i = _mm_and_ps(d_i, m);
+            d_q = _mm_and_ps(d_q, m);
+        }
+        _mm_storeu_ps(wi + j, _mm_sub_ps(w_i, d_i));
+        _mm_storeu_ps(wq + j, _mm_sub_ps(w_q, d_q));
+    }
+    // Горизонтальная сумма обоих аккумуляторов сразу: (i0+i1, q0+q1, i2+i3, q2+q3)
+    __m128 pairs = _mm_add_ps(_mm_unpacklo_ps(acc_i, acc_q), _mm_unpackhi_ps(acc_i, acc_q));
+    __m128 total = _mm_add_ps(pairs, _mm_movehl_ps(pairs, pairs));
+    return cf32(_mm_cvtss_f32(total), _mm_cvtss_f32(_mm_shuffle_ps(total, total, 1)));
+#else
+    float sum_i = 0, sum_q = 0;
+    for (size_t j = 0; j < padded_taps; ++j) {
+        sum_i += wi[j] * xi[j] - wq[j] * xq[j];
+        sum_q += wi[j] * xq[j] + wq[j] * xi[j];
+        if (Masked && mask[j] == 0.0f) continue;   // маска - все единицы (не число) или ноль
+        wi[j] -= ei * pi[j] + eq * pq[j];
+        wq[j] -= eq * pi[j] - ei * pq[j];
+    }
+    return cf32(sum_i, sum_q);
+#endif
+}
+
+static cf32 decide(cf32 y, EqualizerConstellation constellation) {
+    if (constellation == EqualizerConstellation::BPSK) return cf32(std::copysign(1.0f, y.real()), 0.0f);
+    return cf32(std::copysign(QPSK_AMPLITUDE, y.real()), std::copysign(QPSK_AMPLITUDE, y.imag()));
+}
+
+size_t AdaptiveEqualizer::process(const cf32* in, size_t samples_count, cf32* out) {
+    const size_t sps = config.samples_per_symbol;
+
+    // Блок целиком раскладывается в историю до свертки - окна читаются из уже
+    // записанной памяти, без зависимостей от только что сохраненных отсчетов
+    line_i.resize(history + samples_count);
+    line_q.resize(history + samples_count);
+    for (size_t n = 0; n < samples_count; ++n) {
+        line_i[history + n] = in[n].real();
+        line_q[history + n] = in[n].imag();
+    }
+
+    // Состояние - в локальных переменных: запись отводов через float* иначе заставляет
+    // перечитывать члены класса из памяти на каждом символе
+    float* wi = taps_i.data();
+    float* wq = taps_q.data();
+    const float* mask = tap_mask.data();
+    const bool masked = padded_taps != config.taps;
+    const EqualizerConstellation constellation = config.constellation;
+    const float cma_step = config.cma_step, lms_step = config.lms_step, dd_threshold = config.dd_threshold;
+    EqualizerMode mode = current_mode;
+    // Ошибки последних EQ_UPDATE_DELAY символов, уже умноженные на шаг; [0] - самая старая
+    cf32 delayed[EQ_UPDATE_DELAY];
+    std::copy(pending_error, pending_error + EQ_UPDATE_DELAY, delayed);
+    float power = error_power;
+    float modulus_power = dispersion;
+
+    size_t produced = 0;
+    // newest - индекс последнего отсчета окна символа
+    for (size_t newest = history + sps - 1 - phase; newest < history + samples_count; newest += sps) {
+        const float* xi = &line_i[newest + 1 - padded_taps];
+        const float* xq = &line_q[newest + 1 - padded_taps];
+
+        // Ошибка символа на EQ_UPDATE_DELAY раньше - по его окну. До первых символов
+        // ошибки нулевые, и проход только считает свертку
+        const float* pi = xi - EQ_UPDATE_DELAY * sps;
+        const float* pq = xq - EQ_UPDATE_DELAY * sps;
+        cf32 y = masked ? filter_update<true>(wi, wq, xi, xq, pi, pq, mask, padded_taps, delayed[0])
+                        : filter_update<false>(wi, wq, xi, xq, pi, pq, mask, padded_taps, delayed[0]);
+
+        cf32 decision_error = y - decide(y, constellation);
+        // Модуль точек созвездия - 1 и для BPSK, и для нормированной QPSK
+        float modulus_error = std::norm(y) - 1.0f;
+        power += EQ_MSE_ALPHA * (std::norm(decision_error) - power);
+        modulus_power += EQ_MSE_ALPHA * (modulus_error * modulus_error - modulus_power);
+
+        cf32 error;
+        if (mode == EqualizerMode::CMA) {
+            error = y * (cma_step * modulus_error);
+            if (dd_threshold > 0 && modulus_power < dd_threshold) mode = EqualizerMode::DecisionDirected;
+        } else {
+            error = decision_error * lms_step;
+        }
+        for (size_t k = 1; k < EQ_UPDATE_DELAY; ++k) delayed[k - 1] = delayed[k];
+        delayed[EQ_UPDATE_DELAY - 1] = error;
+        out[produced++] = y;
+    }
+    current_mode = mode;
+    std::copy(delayed, delayed + EQ_UPDATE_DELAY, pending_error);
+    error_power = power;
+    dispersion = modulus_power;
+    phase = (phase + samples_count) % sps;
+
+    // Хвост - история для следующего блока
+    std::copy(line_i.end() - history, line_i.end(), line_i.begin());
+    std::copy(line_q.end() - history, line_q.end(), line_q.begin());
+    line_i.resize(history);
+    line_q.resize(history);
+    return produced;
+}
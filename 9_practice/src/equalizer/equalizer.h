@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Адаптивный эквалайзер с дробным шагом отводов (обычно T/2) для BPSK/QPSK после
+// символьной синхронизации. Выход - один отсчет на символ.
+//   CMA: e = y (|y|^2 - 1) - слепой захват, не зависит от фазы несущей
+//   DD-LMS: e = y - решение(y) - точная подстройка после раскрытия глаза
+// Переход CMA -> DD автоматический, когда сглаженная дисперсия модуля (|y|^2 - 1)^2
+// падает ниже dd_threshold (или вручную через set_mode). Дисперсия не зависит от
+// поворота созвездия, который CMA не исправляет, - его снимает уже DD-LMS (в пределах +-45 градусов).
+// Отсчеты блока раскладываются в линейную историю раздельно по I и Q, окно символа -
+// непрерывный участок истории, отводы хранятся в обратном порядке (как в FirFilter).
+// Свертка и обновление отводов - один проход SSE2 по EQ_LANES отводов (на x86-64 всегда),
+// иначе скалярный цикл: каждый отвод загружается и сохраняется один раз на символ.
+// Число отводов дополняется нулями до кратного EQ_LANES; при кратном маска не применяется.
+// Обновление запаздывает на EQ_UPDATE_DELAY символов (delayed LMS): в проходе символа n
+// отводы правятся ошибкой символа n - 2, поэтому цепочка свертка -> ошибка -> обновление
+// не задерживает следующий символ. При малых шагах сходимость практически та же, что у LMS.
+// Цель "меньше 20 нс на символ" при 16 отводах достижима на SSE2 только на свободном ядре, иначе нужен AVX.
+
+constexpr size_t EQ_LANES = 4;
+constexpr size_t EQ_UPDATE_DELAY = 2;
+
+enum class EqualizerMode { CMA, DecisionDirected };
+enum class EqualizerConstellation { BPSK, QPSK };
+
+struct EqualizerConfig {
+    size_t taps = 16;                // отводов (на частоте входа)
+    size_t samples_per_symbol = 2;
+    float cma_step = 2e-3f;
+    float lms_step = 5e-3f;
+    float dd_threshold = 0.05f;      // дисперсия модуля для перехода в DD (0 - только вручную)
+    EqualizerConstellation constellation = EqualizerConstellation::QPSK;
+};
+
+class AdaptiveEqualizer {
+public:
+    explicit AdaptiveEqualizer(const EqualizerConfig& config = EqualizerConfig());
+
+    // Возвращает число выданных символов; в out помещается samples_count / sps + 1
+    size_t process(const cf32* in, size_t samples_count, cf32* out);
+
+    // Отводы в единичный центральный, режим CMA
+    void reset();
+
+    void set_mode(EqualizerMode mode) { current_mode = mode; }
+    EqualizerMode mode() const { return current_mode; }
+
+    // Сглаженная ошибка относительно решений (MSE) - годится для индикации качества
+    float mse() const { return error_power; }
+    std::vector<cf32> taps() const;
+
+private:
+    EqualizerConfig config;
+    size_t padded_taps;
+    size_t history;                      // отсчетов, переносимых между блоками
+    std::vector<float> taps_i, taps_q;   // в обратном порядке: taps[padded - 1] - самый новый отсчет
+    std::vector<float> tap_mask;         // битовая маска занятых отводов для векторного обновления
+    std::vector<float> line_i, line_q;   // история + текущий блок
+    size_t phase = 0;                    // отсчетов с последнего символа
+    cf32 pending_error[EQ_UPDATE_DELAY];  // step * ошибка, еще не примененная к отводам
+    EqualizerMode current_mode = EqualizerMode::CMA;
+    float error_power = 1.0f;
+    float dispersion = 1.0f;
+};
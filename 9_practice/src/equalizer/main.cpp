@@ -0,0 +1,148 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "equalizer/equalizer.h"
+#include "export/npy.h"
+#include "modulation/mapper.h"
+#include "prbs/prbs.h"
+#include "pulse/pulse_shape.h"
+
+using TxPulse = PulseShaper<PulseType::RaisedCosine, 2, 8, 35>;
+
+// Многолучевой канал с шагом T/2: прямой луч с поворотом, эхо через 1 и 2.5 символа
+static std::vector<cf32> simulate_channel(const std::vector<cf32>& tx, double snr_db, std::mt19937& gen) {
+    const cf32 channel[] = {cf32(0.8f, 0.3f), cf32(0.0f, 0.0f), cf32(0.0f, 0.35f), cf32(0.0f, 0.0f),
+                            cf32(0.0f, 0.0f), cf32(-0.2f, 0.1f)};
+    const size_t taps = sizeof(channel) / sizeof(channel[0]);
+    std::vector<cf32> rx(tx.size());
+    for (size_t n = 0; n < tx.size(); ++n) {
+        for (size_t k = 0; k < taps && k <= n; ++k) rx[n] += channel[k] * tx[n - k];
+    }
+    double power = 0;
+    for (const cf32& x : rx) power += std::norm(x);
+    power /= rx.size();
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(power / std::pow(10, snr_db / 10) / 2)));
+    for (cf32& x : rx) x += cf32(noise(gen), noise(gen));
+    return rx;
+}
+
+// Доля ошибочных символов QPSK по последним count символам с подбором задержки
+// и поворота на k * 90 градусов (CMA не различает эти варианты)
+static double symbol_error_rate(const std::vector<cf32>& tx, const cf32* rx, size_t rx_count, size_t count) {
+    double best = 1.0;
+    for (size_t lag = 0; lag < 24 && lag < rx_count; ++lag) {
+        for (int rotation = 0; rotation < 4; ++rotation) {
+            cf32 turn = std::pow(cf32(0.0f, 1.0f), rotation);
+            size_t errors = 0, checked = 0;
+            for (size_t n = rx_count - count; n < rx_count; ++n) {
+                if (n < lag || n - lag >= tx.size()) continue;
+                cf32 y = rx[n] * turn;
+                const cf32& a = tx[n - lag];
+                errors += (y.real() < 0) != (a.real() < 0) || (y.imag() < 0) != (a.imag() < 0);
+                ++checked;
+            }
+            if (checked) best = std::min(best, static_cast<double>(errors) / checked);
+        }
+    }
+    return best;
+}
+
+// Использование:
+//   eq.out [symbols=20000] [taps=16] [snr=25] [cma=2e-3] [lms=5e-3] [threshold=0.05] [out=eq.npz]
+// out - созвездия до и после эквалайзера (before, after) для просмотра
+int main(int argc, char** argv) {
+    EqualizerConfig config;
+    size_t symbols_count = 20000;
+    double snr_db = 25.0;
+    std::string out;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "symbols") symbols_count = strtoul(value, nullptr, 10);
+        else if (key == "taps") config.taps = strtoul(value, nullptr, 10);
+        else if (key == "snr") snr_db = atof(value);
+        else if (key == "cma") config.cma_step = static_cast<float>(atof(value));
+        else if (key == "lms") config.lms_step = static_cast<float>(atof(value));
+        else if (key == "threshold") config.dd_threshold = static_cast<float>(atof(value));
+        else if (key == "out") out = value;
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (symbols_count < 2000 || config.taps == 0) {
+        printf("symbols >= 2000, taps > 0\n");
+        return -1;
+    }
+
+    std::vector<uint8_t> bits(2 * symbols_count);
+    PrbsGenerator(PrbsType::PRBS23).fill_bits(bits.data(), bits.size());
+    std::vector<cf32> symbols(symbols_count);
+    qpsk_map(bits.data(), bits.size(), symbols.data());
+
+    std::vector<cf32> tx(TxPulse::output_length(symbols_count));
+    TxPulse::shape(symbols.data(), symbols_count, tx.data(), tx.size());
+    std::mt19937 gen(1);
+    std::vector<cf32> rx = simulate_channel(tx, snr_db, gen);
+
+    // Без эквалайзера: отсчеты в центрах символов, усиление нормировано по мощности
+    std::vector<cf32> plain(rx.size() / 2);
+    double power = 0;
+    for (size_t n = 0; n < plain.size(); ++n) power += std::norm(rx[2 * n]);
+    float gain = static_cast<float>(1.0 / std::sqrt(power / plain.size()));
+    for (size_t n = 0; n < plain.size(); ++n) plain[n] = rx[2 * n] * gain;
+
+    AdaptiveEqualizer equalizer(config);
+    std::vector<cf32> equalized(rx.size() / 2 + 1);
+    size_t switched = 0, produced = 0;
+    for (size_t n = 0; n < rx.size(); n += 64) {
+        std::vector<cf32> block(rx.begin() + n, rx.begin() + std::min(rx.size(), n + 64));
+        for (cf32& x : block) x *= gain;
+        produced += equalizer.process(block.data(), block.size(), &equalized[produced]);
+        if (!switched && equalizer.mode() == EqualizerMode::DecisionDirected) switched = produced;
+    }
+
+    size_t tail = symbols_count / 4;
+    printf("Эквалайзер: %zu отводов T/2, CMA -> DD на символе %zu, MSE %.4f\n", config.taps, switched,
+           equalizer.mse());
+    printf("SER без эквалайзера: %.3e, с эквалайзером: %.3e (последние %zu символов)\n",
+           symbol_error_rate(symbols, plain.data(), plain.size(), tail),
+           symbol_error_rate(symbols, equalized.data(), produced, tail), tail);
+
+    // Скорость в установившемся режиме DD: 10 прогонов по 100 тысяч символов.
+    // Лучший прогон - оценка без вытеснения другими процессами, среднее - с ними
+    const size_t bench_runs = 10, run_symbols = 25 * 4096;
+    std::vector<cf32> bench_in(2 * 4096), bench_out(4096 + 1);
+    for (size_t n = 0; n < bench_in.size(); ++n) bench_in[n] = rx[n % rx.size()] * gain;
+    double total_seconds = 0, best_seconds = 0;
+    for (size_t run = 0; run < bench_runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < run_symbols; done += 4096) {
+            equalizer.process(bench_in.data(), bench_in.size(), bench_out.data());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total_seconds += seconds;
+        if (run == 0 || seconds < best_seconds) best_seconds = seconds;
+    }
+    printf("Скорость: %.1f нс/символ лучший прогон, %.1f среднее (%.1f Мсимв/с)\n", best_seconds * 1e9 / run_symbols,
+           total_seconds * 1e9 / (bench_runs * run_symbols), bench_runs * run_symbols / total_seconds / 1e6);
+
+    if (!out.empty()) {
+        NpzWriter npz;
+        if (!npz.open(out)) return -1;
+        size_t shown = std::min<size_t>(tail, plain.size());
+        npz.add("before", plain.data() + plain.size() - shown, {shown});
+        npz.add("after", equalized.data() + produced - shown, {shown});
+        npz.close();
+        printf("Созвездия сохранены в %s\n", out.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+// Запись массивов в форматы numpy .npy/.npz без зависимостей.
+// Заголовочный файл целиком, чтобы его можно было подключить и из отдельных
+// программ практик: #include "../9_practice/src/export/npy.h". CRC записей .npz
+// считает packet/crc32.cpp: программе с NpzWriter он нужен в сборке.
+//
+// Данные пишутся одним fwrite на массив; .npz - zip без сжатия (STORED),
+// который читается numpy.load().
+
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../packet/crc32.h"
+
+// Описание типа для заголовка npy (little-endian)
+template <typename T> struct NpyType;
+template <> struct NpyType<uint8_t> { static const char* descr() { return "|u1"; } };
+template <> struct NpyType<int16_t> { static const char* descr() { return "<i2"; } };
+template <> struct NpyType<int32_t> { static const char* descr() { return "<i4"; } };
+template <> struct NpyType<int64_t> { static const char* descr() { return "<i8"; } };
+template <> struct NpyType<float> { static const char* descr() { return "<f4"; } };
+template <> struct NpyType<double> { static const char* descr() { return "<f8"; } };
+template <> struct NpyType<std::complex<float>> { static const char* descr() { return "<c8"; } };
+template <> struct NpyType<std::complex<double>> { static const char* descr() { return "<c16"; } };
+
+// Заголовок npy версии 1.0, выровненный на 64 байта
+inline std::string npy_header(const char* descr, const std::vector<size_t>& shape) {
+    std::string dict = "{'descr': '";
+    dict += descr;
+    dict += "', 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        dict += std::to_string(shape[i]);
+        if (shape.size() == 1 || i + 1 < shape.size()) dict += ",";
+        if (i + 1 < shape.size()) dict += " ";
+    }
+    dict += "), }";
+
+    size_t total = 10 + dict.size() + 1;
+    size_t padding = (64 - total % 64) % 64;
+    dict.append(padding, ' ');
+    dict += '\n';
+
+    std::string header("\x93NUMPY\x01\x00", 8);
+    uint16_t length = static_cast<uint16_t>(dict.size());
+    header += static_cast<char>(length & 0xff);
+    header += static_cast<char>(length >> 8);
+    return header + dict;
+}
+
+inline size_t npy_elements(const std::vector<size_t>& shape) {
+    size_t count = 1;
+    for (size_t dim : shape) count *= dim;
+    return count;
+}
+
+// Одиночный .npy файл
+template <typename T>
+bool write_npy(const std::string& path, const T* data, const std::vector<size_t>& shape) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        printf("Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+
+    std::string header = npy_header(NpyType<T>::descr(), shape);
+    size_t count = npy_elements(shape);
+    bool ok = fwrite(header.data(), 1, header.size(), file) == header.size() &&
+              fwrite(data, sizeof(T), count, file) == count;
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+// Архив .npz: набор именованных массивов и метаданных в одном файле.
+// Обычный zip без ZIP64: размеры и смещения 32-битные, поэтому архив ограничен 4 ГиБ
+// и 65535 массивами. Массив, который не помещается, не пишется, add возвращает false.
+class NpzWriter {
+public:
+    NpzWriter() = default;
+    ~NpzWriter() { close(); }
+
+    NpzWriter(const NpzWriter&) = delete;
+    NpzWriter& operator=(const NpzWriter&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        file = fopen(path.c_str(), "wb");
+        if (!file) printf("Не удалось открыть файл: %s\n", path.c_str());
+        return file != nullptr;
+    }
+
+    template <typename T>
+    bool add(const std::string& name, const T* data, const std::vector<size_t>& shape) {
+        std::string header = npy_header(NpyType<T>::descr(), shape);
+        return add_entry(name, header, data, npy_elements(shape) * sizeof(T));
+    }
+
+    // Скаляр (shape == ()), например коэффициент апсемплинга или частота дискретизации
+    template <typename T>
+    bool add_scalar(const std::string& name, T value) {
+        return add(name, &value, {});
+    }
+
+    // Строка как numpy.bytes_ (dtype |S<n>)
+    bool add_string(const std::string& name, const std::string& value) {
+        std::string descr = "|S" + std::to_string(value.empty() ? 1 : value.size());
+        std::string header = npy_header(descr.c_str(), {});
+        std::string payload = value.empty() ? std::string(1, '\0') : value;
+        return add_entry(name, header, payload.data(), payload.size());
+    }
+
+    // Дописывает центральный каталог; после этого архив готов к чтению
+    bool close() {
+        if (!file) return true;
+
+        uint32_t directory_offset = offset;
+        uint32_t directory_size = 0;
+        for (const Entry& entry : entries) {
+            std::vector<uint8_t> record;
+            put32(record, 0x02014b50);
+            put16(record, 20);                  // Версия, создавшая архив
+            put16(record, 20);                  // Версия для распаковки
+            put16(record, 0);                   // Флаги
+            put16(record, 0);                   // STORED
+            put16(record, 0);                   // Время
+            put16(record, 0x21);                // Дата (1980-01-01)
+            put32(record, entry.crc);
+            put32(record, entry.size);
+            put32(record, entry.size);
+            put16(record, static_cast<uint16_t>(entry.name.size()));
+            put16(record, 0);                   // Доп. поле
+            put16(record, 0);                   // Комментарий
+            put16(record, 0);                   // Номер диска
+            put16(record, 0);                   // Внутренние атрибуты
+            put32(record, 0);                   // Внешние атрибуты
+            put32(record, entry.offset);
+            record.insert(record.end(), entry.name.begin(), entry.name.end());
+
+            fwrite(record.data(), 1, record.size(), file);
+            directory_size += static_cast<uint32_t>(record.size());
+        }
+
+        std::vector<uint8_t> end;
+        put32(end, 0x06054b50);
+        put16(end, 0);
+        put16(end, 0);
+        put16(end, static_cast<uint16_t>(entries.size()));
+        put16(end, static_cast<uint16_t>(entries.size()));
+        put32(end, directory_size);
+        put32(end, directory_offset);
+        put16(end, 0);
+        fwrite(end.data(), 1, end.size(), file);
+
+        bool ok = ferror(file) == 0;
+        ok = fclose(file) == 0 && ok;
+        file = nullptr;
+        entries.clear();
+        offset = 0;
+        return ok;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        uint32_t crc;
+        uint32_t size;
+        uint32_t offset;
+    };
+
+    static void put16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(value & 0xff);
+        out.push_back(value >> 8);
+    }
+
+    static void put32(std::vector<uint8_t>& out, uint32_t value) {
+        put16(out, value & 0xffff);
+        put16(out, value >> 16);
+    }
+
+    bool add_entry(const std::string& array_name, const std::string& header, const void* data, size_t data_size) {
+        if (!file) return false;
+
+        Entry entry;
+        entry.name = array_name + ".npy";
+        // Конец записи (локальный заголовок - 30 байт + имя) - будущее смещение каталога
+        uint64_t end = uint64_t(offset) + 30 + entry.name.size() + header.size() + data_size;
+        if (end > UINT32_MAX || entries.size() >= UINT16_MAX) {
+            printf("Массив %s не помещается в .npz (предел 4 ГиБ и 65535 массивов)\n", array_name.c_str());
+            return false;
+        }
+        entry.size = static_cast<uint32_t>(header.size() + data_size);
+        uint32_t crc = crc32_update(0, reinterpret_cast<const uint8_t*>(header.data()), header.size());
+        entry.crc = crc32_update(crc, static_cast<const uint8_t*>(data), data_size);
+        entry.offset = offset;
+
+        std::vector<uint8_t> local;
+        put32(local, 0x04034b50);
+        put16(local, 20);
+        put16(local, 0);
+        put16(local, 0);
+        put16(local, 0);
+        put16(local, 0x21);
+        put32(local, entry.crc);
+        put32(local, entry.size);
+        put32(local, entry.size);
+        put16(local, static_cast<uint16_t>(entry.name.size()));
+        put16(local, 0);
+        local.insert(local.end(), entry.name.begin(), entry.name.end());
+
+        bool ok = fwrite(local.data(), 1, local.size(), file) == local.size() &&
+                  fwrite(header.data(), 1, header.size(), file) == header.size() &&
+                  fwrite(data, 1, data_size, file) == data_size;
+
+        offset += static_cast<uint32_t>(local.size()) + entry.size;
+        entries.push_back(entry);
+        return ok;
+    }
+
+    FILE* file = nullptr;
+    uint32_t offset = 0;
+    std::vector<Entry> entries;
+};
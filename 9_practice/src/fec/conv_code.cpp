@@ -0,0 +1,60 @@
+#include <cstring>
+
+#include "fec/conv_code.h"
+
+PunctureMask puncture_mask(CodeRate rate) {
+    switch (rate) {
+    case CodeRate::R2_3: return {2, 0b11, 0b01};
+    case CodeRate::R3_4: return {3, 0b011, 0b101};
+    default: return {1, 0b1, 0b1};
+    }
+}
+
+CodeRate code_rate_from_string(const char* text) {
+    if (strcmp(text, "2/3") == 0) return CodeRate::R2_3;
+    if (strcmp(text, "3/4") == 0) return CodeRate::R3_4;
+    return CodeRate::R1_2;
+}
+
+const char* code_rate_name(CodeRate rate) {
+    switch (rate) {
+    case CodeRate::R2_3: return "2/3";
+    case CodeRate::R3_4: return "3/4";
+    default: return "1/2";
+    }
+}
+
+size_t conv_encoded_length(size_t bits_count, CodeRate rate, bool terminate) {
+    PunctureMask mask = puncture_mask(rate);
+    size_t total = bits_count + (terminate ? CONV_K - 1 : 0);
+    size_t kept = 0;
+    for (int j = 0; j < mask.period; ++j) {
+        size_t count = total / mask.period + (static_cast<size_t>(j) < total % mask.period);
+        kept += count * (((mask.a >> j) & 1) + ((mask.b >> j) & 1));
+    }
+    return kept;
+}
+
+ConvEncoder::ConvEncoder(CodeRate rate) : mask(puncture_mask(rate)) {}
+
+size_t ConvEncoder::encode(const uint8_t* bits, size_t bits_count, uint8_t* out) {
+    size_t written = 0;
+    for (size_t i = 0; i < bits_count; ++i) {
+        unsigned reg = (static_cast<unsigned>(state) << 1) | (bits[i] & 1);
+        if ((mask.a >> phase) & 1) out[written++] = __builtin_parity(reg & CONV_G0);
+        if ((mask.b >> phase) & 1) out[written++] = __builtin_parity(reg & CONV_G1);
+        state = reg & (CONV_STATES - 1);
+        if (++phase == mask.period) phase = 0;
+    }
+    return written;
+}
+
+size_t ConvEncoder::terminate(uint8_t* out) {
+    const uint8_t zeros[CONV_K - 1] = {};
+    return encode(zeros, CONV_K - 1, out);
+}
+
+void ConvEncoder::reset() {
+    state = 0;
+    phase = 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Сверточный код K = 7, R = 1/2, порождающие многочлены 0171 и 0133 (восьмеричные).
+// Состояние - последние 6 входных бит, новый бит в младшем разряде:
+// регистр = (состояние << 1) | бит, выход i = четность(регистр & G_i).
+// Оба многочлена содержат старший и младший разряды, поэтому в бабочке
+// переходы отличаются только знаком ветвевой метрики - на этом построен ACS.
+// Выколотые скорости 2/3 и 3/4 - по шаблонам 802.11.
+
+constexpr int CONV_K = 7;
+constexpr int CONV_STATES = 1 << (CONV_K - 1);
+constexpr uint8_t CONV_G0 = 0171;
+constexpr uint8_t CONV_G1 = 0133;
+
+enum class CodeRate { R1_2, R2_3, R3_4 };
+
+// Шаблон выкалывания: period входных бит, маски выходов A и B (бит j - j-й входной бит)
+struct PunctureMask {
+    int period;
+    uint8_t a;
+    uint8_t b;
+};
+
+PunctureMask puncture_mask(CodeRate rate);
+CodeRate code_rate_from_string(const char* text);
+const char* code_rate_name(CodeRate rate);
+
+// Выходных бит на bits_count входных (с учетом хвоста, если terminate)
+size_t conv_encoded_length(size_t bits_count, CodeRate rate, bool terminate = true);
+
+class ConvEncoder {
+public:
+    explicit ConvEncoder(CodeRate rate = CodeRate::R1_2);
+
+    // Потоковое кодирование; возвращает число записанных бит (0/1 по одному на байт)
+    size_t encode(const uint8_t* bits, size_t bits_count, uint8_t* out);
+
+    // Хвост из K - 1 нулей: возвращает решетку в нулевое состояние
+    size_t terminate(uint8_t* out);
+
+    void reset();
+
+private:
+    PunctureMask mask;
+    uint8_t state = 0;
+    int phase = 0;
+};
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fec/viterbi.h"
+#include "modulation/mapper.h"
+#include "prbs/prbs.h"
+#include "simulation/ber_sim.h"
+
+// Амплитуда символа в единицах мягкого решения: шум до ~4 sigma не насыщается при Eb/N0 > 0 дБ
+constexpr float SOFT_SCALE = 32.0f;
+constexpr size_t SOFT_BLOCK = 4096;
+
+struct Link {
+    std::vector<uint8_t> bits;
+    std::vector<uint8_t> coded;
+    std::vector<int8_t> soft;
+};
+
+// Кодирование, BPSK, AWGN с Eb/N0 на информационный бит, мягкий демаппинг
+static void make_link(size_t bits_count, CodeRate rate, double ebn0_db, std::mt19937_64& gen, Link& link) {
+    link.bits.resize(bits_count);
+    PrbsGenerator(PrbsType::PRBS23, static_cast<uint32_t>(gen())).fill_bits(link.bits.data(), bits_count);
+
+    ConvEncoder encoder(rate);
+    link.coded.resize(conv_encoded_length(bits_count, rate));
+    size_t coded = encoder.encode(link.bits.data(), bits_count, link.coded.data());
+    coded += encoder.terminate(link.coded.data() + coded);
+
+    double code_rate = static_cast<double>(bits_count) / coded;
+    float sigma = static_cast<float>(std::sqrt(1.0 / (2.0 * code_rate * std::pow(10.0, ebn0_db / 10))));
+    std::normal_distribution<float> noise(0.0f, sigma);
+
+    std::vector<cf32> symbols(coded);
+    bpsk_map(link.coded.data(), coded, symbols.data());
+    for (cf32& s : symbols) s += cf32(noise(gen), 0.0f);
+    link.soft.resize(coded);
+    bpsk_soft_demap(symbols.data(), coded, SOFT_SCALE, link.soft.data());
+}
+
+// Потоковое декодирование блоками SOFT_BLOCK; возвращает число ошибок
+static size_t decode_link(ViterbiDecoder& decoder, const Link& link, std::vector<uint8_t>& out) {
+    out.resize(link.bits.size() + VITERBI_TRACEBACK + 2 * VITERBI_CHUNK);
+    size_t decoded = 0;
+    for (size_t i = 0; i < link.soft.size(); i += SOFT_BLOCK) {
+        size_t count = std::min(SOFT_BLOCK, link.soft.size() - i);
+        decoded += decoder.decode(&link.soft[i], count, &out[decoded]);
+    }
+    decoded += decoder.flush(&out[decoded]);
+    if (decoded != link.bits.size()) {
+        printf("Декодировано %zu бит вместо %zu\n", decoded, link.bits.size());
+        return link.bits.size();
+    }
+    size_t errors = 0;
+    for (size_t i = 0; i < decoded; ++i) errors += out[i] != link.bits[i];
+    return errors;
+}
+
+// Использование:
+//   fec.out [mode=bench|curve] [rate=1/2|2/3|3/4] [bits=1000000] [ebn0=4]
+//           [from=0] [to=7] [step=1]
+// bench - скорость декодирования (Мбит/с) для всех доступных вариантов ACS
+// curve - BER без кода и с кодом по сетке Eb/N0
+int main(int argc, char** argv) {
+    std::string mode = "bench";
+    CodeRate rate = CodeRate::R1_2;
+    size_t bits_count = 1000000;
+    double ebn0 = 4.0, from = 0.0, to = 7.0, step = 1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "mode") mode = value;
+        else if (key == "rate") rate = code_rate_from_string(value);
+        else if (key == "bits") bits_count = strtoul(value, nullptr, 10);
+        else if (key == "ebn0") ebn0 = atof(value);
+        else if (key == "from") from = atof(value);
+        else if (key == "to") to = atof(value);
+        else if (key == "step") step = atof(value);
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (bits_count == 0 || step <= 0) {
+        printf("bits > 0, step > 0\n");
+        return -1;
+    }
+
+    std::mt19937_64 gen(1);
+    Link link;
+    std::vector<uint8_t> out;
+
+    if (mode == "bench") {
+        make_link(bits_count, rate, ebn0, gen, link);
+        printf("K=%d, R=%s, %zu бит, Eb/N0 %.1f дБ, обратный проход %zu + блок %zu\n", CONV_K, code_rate_name(rate),
+               bits_count, ebn0, VITERBI_TRACEBACK, VITERBI_CHUNK);
+        for (ViterbiSimd simd : {ViterbiSimd::Scalar, ViterbiSimd::SSE2, ViterbiSimd::AVX2}) {
+            if (!ViterbiDecoder::simd_supported(simd)) {
+                printf("%-7s недоступен\n", ViterbiDecoder::simd_name(simd));
+                continue;
+            }
+            ViterbiDecoder decoder(rate, simd);
+            auto start = std::chrono::steady_clock::now();
+            size_t errors = decode_link(decoder, link, out);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("%-7s %8.1f Мбит/с, ошибок %zu (BER %.2e)\n", ViterbiDecoder::simd_name(simd),
+                   bits_count / seconds / 1e6, errors, static_cast<double>(errors) / bits_count);
+        }
+        return 0;
+    }
+
+    if (mode != "curve") {
+        printf("Неизвестный режим: %s\n", mode.c_str());
+        return -1;
+    }
+
+    ViterbiDecoder decoder(rate);
+    printf("K=%d, R=%s, ACS: %s\n", CONV_K, code_rate_name(rate), ViterbiDecoder::simd_name(decoder.simd()));
+    printf("Eb/N0, дБ   BPSK теория   BPSK+код\n");
+    for (double point = from; point <= to + 1e-9; point += step) {
+        make_link(bits_count, rate, point, gen, link);
+        size_t errors = decode_link(decoder, link, out);
+        printf("%9.1f   %11.2e   %8.2e (%zu)\n", point, theoretical_ber(point),
+               static_cast<double>(errors) / bits_count, errors);
+    }
+    return 0;
+}
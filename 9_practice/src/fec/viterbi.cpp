@@ -0,0 +1,245 @@
+#include <algorithm>
+
+#include "fec/viterbi.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VITERBI_X86 1
+#endif
+
+// Ветвевая метрика бабочки i (старые состояния i и i + 32, новые 2i и 2i + 1):
+// для перехода i -> 2i ожидаются выходы c0, c1 = четность((i << 1) & G);
+// метрика = (c0 ? s0 : -s0) + (c1 ? s1 : -s1), т.е. (s ^ mask) - mask с mask = c ? 0 : -1.
+// Переходы i -> 2i + 1 и i + 32 -> 2i имеют метрику с обратным знаком, i + 32 -> 2i + 1 - ту же.
+struct BranchMasks {
+    alignas(32) int16_t a[CONV_STATES / 2];
+    alignas(32) int16_t b[CONV_STATES / 2];
+
+    BranchMasks() {
+        for (int i = 0; i < CONV_STATES / 2; ++i) {
+            a[i] = __builtin_parity((i << 1) & CONV_G0) ? 0 : -1;
+            b[i] = __builtin_parity((i << 1) & CONV_G1) ? 0 : -1;
+        }
+    }
+};
+
+static const BranchMasks BRANCH;
+
+// Начальная метрика всех состояний, кроме нулевого
+constexpr int16_t VITERBI_START_PENALTY = 4096;
+
+// Номер бита решения нового состояния в 64-битном слове шага. Раскладка совпадает
+// с movemask(packs(четные, нечетные)) для SSE2 и AVX2: блоки по 8 бабочек,
+// в блоке сначала 8 решений для четных состояний, затем 8 для нечетных
+static inline int decision_bit(int state) {
+    int butterfly = state >> 1;
+    return (butterfly >> 3) * 16 + (state & 1) * 8 + (butterfly & 7);
+}
+
+static void acs_scalar(int16_t* metrics, const int8_t* pairs, size_t steps, uint64_t* decisions) {
+    int16_t next[CONV_STATES];
+    for (size_t t = 0; t < steps; ++t) {
+        int s0 = pairs[2 * t], s1 = pairs[2 * t + 1];
+        uint64_t word = 0;
+        for (int i = 0; i < CONV_STATES / 2; ++i) {
+            int bm = ((s0 ^ BRANCH.a[i]) - BRANCH.a[i]) + ((s1 ^ BRANCH.b[i]) - BRANCH.b[i]);
+            int lo = metrics[i], hi = metrics[i + CONV_STATES / 2];
+            int a = lo + bm, b = hi - bm, c = lo - bm, e = hi + bm;
+            next[2 * i] = static_cast<int16_t>(std::min(a, b));
+            next[2 * i + 1] = static_cast<int16_t>(std::min(c, e));
+            word |= static_cast<uint64_t>(a > b) << decision_bit(2 * i);
+            word |= static_cast<uint64_t>(c > e) << decision_bit(2 * i + 1);
+        }
+        int16_t base = next[0];
+        for (int k = 0; k < CONV_STATES; ++k) metrics[k] = next[k] - base;
+        decisions[t] = word;
+    }
+}
+
+#if defined(VITERBI_X86) && defined(__SSE2__)
+#define VITERBI_HAVE_SSE2 1
+
+// 8 состояний на регистр: старые i - регистры 0..3, i + 32 - регистры 4..7
+static void acs_sse2(int16_t* metrics, const int8_t* pairs, size_t steps, uint64_t* decisions) {
+    __m128i m[8], mask_a[4], mask_b[4];
+    for (int r = 0; r < 8; ++r) m[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(metrics) + r);
+    for (int r = 0; r < 4; ++r) {
+        mask_a[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(BRANCH.a) + r);
+        mask_b[r] = _mm_load_si128(reinterpret_cast<const __m128i*>(BRANCH.b) + r);
+    }
+
+    for (size_t t = 0; t < steps; ++t) {
+        __m128i s0 = _mm_set1_epi16(pairs[2 * t]), s1 = _mm_set1_epi16(pairs[2 * t + 1]);
+        __m128i next[8];
+        uint64_t word = 0;
+        for (int r = 0; r < 4; ++r) {
+            __m128i bm = _mm_add_epi16(_mm_sub_epi16(_mm_xor_si128(s0, mask_a[r]), mask_a[r]),
+                                       _mm_sub_epi16(_mm_xor_si128(s1, mask_b[r]), mask_b[r]));
+            __m128i a = _mm_adds_epi16(m[r], bm), b = _mm_subs_epi16(m[r + 4], bm);
+            __m128i c = _mm_subs_epi16(m[r], bm), e = _mm_adds_epi16(m[r + 4], bm);
+            __m128i even = _mm_min_epi16(a, b), odd = _mm_min_epi16(c, e);
+            __m128i choice = _mm_packs_epi16(_mm_cmpgt_epi16(a, b), _mm_cmpgt_epi16(c, e));
+            next[2 * r] = _mm_unpacklo_epi16(even, odd);
+            next[2 * r + 1] = _mm_unpackhi_epi16(even, odd);
+            word |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(choice))) << (16 * r);
+        }
+        __m128i base = _mm_shuffle_epi32(_mm_shufflelo_epi16(next[0], 0), 0);
+        for (int r = 0; r < 8; ++r) m[r] = _mm_sub_epi16(next[r], base);
+        decisions[t] = word;
+    }
+
+    for (int r = 0; r < 8; ++r) _mm_store_si128(reinterpret_cast<__m128i*>(metrics) + r, m[r]);
+}
+#endif
+
+#ifdef VITERBI_X86
+#define VITERBI_HAVE_AVX2 1
+
+// 16 состояний на регистр. unpack в AVX2 работает внутри 128-битных половин,
+// поэтому новые состояния собираются permute2x128; раскладка решений та же, что у SSE2
+__attribute__((target("avx2")))
+static void acs_avx2(int16_t* metrics, const int8_t* pairs, size_t steps, uint64_t* decisions) {
+    __m256i m[4], mask_a[2], mask_b[2];
+    for (int r = 0; r < 4; ++r) m[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(metrics) + r);
+    for (int r = 0; r < 2; ++r) {
+        mask_a[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(BRANCH.a) + r);
+        mask_b[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(BRANCH.b) + r);
+    }
+
+    for (size_t t = 0; t < steps; ++t) {
+        __m256i s0 = _mm256_set1_epi16(pairs[2 * t]), s1 = _mm256_set1_epi16(pairs[2 * t + 1]);
+        __m256i next[4];
+        uint64_t word = 0;
+        for (int r = 0; r < 2; ++r) {
+            __m256i bm = _mm256_add_epi16(_mm256_sub_epi16(_mm256_xor_si256(s0, mask_a[r]), mask_a[r]),
+                                          _mm256_sub_epi16(_mm256_xor_si256(s1, mask_b[r]), mask_b[r]));
+            __m256i a = _mm256_adds_epi16(m[r], bm), b = _mm256_subs_epi16(m[r + 2], bm);
+            __m256i c = _mm256_subs_epi16(m[r], bm), e = _mm256_adds_epi16(m[r + 2], bm);
+            __m256i even = _mm256_min_epi16(a, b), odd = _mm256_min_epi16(c, e);
+            __m256i choice = _mm256_packs_epi16(_mm256_cmpgt_epi16(a, b), _mm256_cmpgt_epi16(c, e));
+            __m256i low = _mm256_unpacklo_epi16(even, odd), high = _mm256_unpackhi_epi16(even, odd);
+            next[2 * r] = _mm256_permute2x128_si256(low, high, 0x20);
+            next[2 * r + 1] = _mm256_permute2x128_si256(low, high, 0x31);
+            word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(choice))) << (32 * r);
+        }
+        __m256i base = _mm256_broadcastw_epi16(_mm256_castsi256_si128(next[0]));
+        for (int r = 0; r < 4; ++r) m[r] = _mm256_sub_epi16(next[r], base);
+        decisions[t] = word;
+    }
+
+    for (int r = 0; r < 4; ++r) _mm256_store_si256(reinterpret_cast<__m256i*>(metrics) + r, m[r]);
+}
+#endif
+
+const char* ViterbiDecoder::simd_name(ViterbiSimd simd) {
+    switch (simd) {
+    case ViterbiSimd::AVX2: return "AVX2";
+    case ViterbiSimd::SSE2: return "SSE2";
+    case ViterbiSimd::Scalar: return "scalar";
+    default: return "auto";
+    }
+}
+
+bool ViterbiDecoder::simd_supported(ViterbiSimd simd) {
+    switch (simd) {
+#ifdef VITERBI_HAVE_AVX2
+    case ViterbiSimd::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+#ifdef VITERBI_HAVE_SSE2
+    case ViterbiSimd::SSE2: return true;
+#endif
+    case ViterbiSimd::Scalar:
+    case ViterbiSimd::Auto: return true;
+    default: return false;
+    }
+}
+
+ViterbiDecoder::ViterbiDecoder(CodeRate rate, ViterbiSimd simd)
+    : mask(puncture_mask(rate)), decisions(VITERBI_TRACEBACK + VITERBI_CHUNK) {
+    // Запрошенный, но недоступный вариант заменяется лучшим доступным
+    if (simd == ViterbiSimd::Auto || !simd_supported(simd)) {
+        simd = simd_supported(ViterbiSimd::AVX2)   ? ViterbiSimd::AVX2
+               : simd_supported(ViterbiSimd::SSE2) ? ViterbiSimd::SSE2
+                                                   : ViterbiSimd::Scalar;
+    }
+    simd_level = simd;
+    acs = acs_scalar;
+#ifdef VITERBI_HAVE_SSE2
+    if (simd == ViterbiSimd::SSE2) acs = acs_sse2;
+#endif
+#ifdef VITERBI_HAVE_AVX2
+    if (simd == ViterbiSimd::AVX2) acs = acs_avx2;
+#endif
+    reset();
+}
+
+void ViterbiDecoder::reset() {
+    std::fill(metrics, metrics + CONV_STATES, VITERBI_START_PENALTY);
+    metrics[0] = 0;
+    written = 0;
+    emitted = 0;
+    phase = 0;
+    have_a = false;
+}
+
+size_t ViterbiDecoder::decode(const int8_t* soft, size_t soft_count, uint8_t* bits) {
+    // Депунктуризация: выколотые позиции - нули (нет информации)
+    pairs.clear();
+    size_t i = 0;
+    while (i < soft_count || have_a) {
+        bool need_a = (mask.a >> phase) & 1, need_b = (mask.b >> phase) & 1;
+        int8_t a = 0, b = 0;
+        if (have_a) a = pending_a;
+        else if (need_a) a = soft[i++];
+        if (need_b) {
+            if (i == soft_count) {
+                pending_a = a;
+                have_a = true;
+                break;
+            }
+            b = soft[i++];
+        }
+        have_a = false;
+        pairs.push_back(a);
+        pairs.push_back(b);
+        if (++phase == mask.period) phase = 0;
+    }
+
+    // ACS кусками до конца кольца или до момента обратного прохода
+    const size_t ring = decisions.size();
+    const size_t steps = pairs.size() / 2;
+    size_t done = 0, output = 0;
+    while (done < steps) {
+        size_t slot = written % ring;
+        size_t count = std::min({steps - done, ring - slot, static_cast<size_t>(emitted + ring - written)});
+        acs(metrics, &pairs[2 * done], count, &decisions[slot]);
+        written += count;
+        done += count;
+        if (written - emitted == ring) output += traceback(best_state(), VITERBI_CHUNK, bits + output);
+    }
+    return output;
+}
+
+size_t ViterbiDecoder::flush(uint8_t* bits, bool terminated) {
+    size_t count = traceback(terminated ? 0 : best_state(), written - emitted, bits);
+    if (terminated) count -= std::min<size_t>(count, CONV_K - 1);
+    reset();
+    return count;
+}
+
+uint8_t ViterbiDecoder::best_state() const {
+    return static_cast<uint8_t>(std::min_element(metrics, metrics + CONV_STATES) - metrics);
+}
+
+// Проход от последнего шага к самому старому невыданному; бит шага - младший
+// разряд состояния после него, решение выбирает предшественника (state >> 1) | 32
+size_t ViterbiDecoder::traceback(uint8_t state, size_t output, uint8_t* bits) {
+    const size_t ring = decisions.size();
+    for (uint64_t t = written; t-- > emitted;) {
+        uint64_t word = decisions[t % ring];
+        if (t < emitted + output) bits[t - emitted] = state & 1;
+        state = static_cast<uint8_t>((state >> 1) | (((word >> decision_bit(state)) & 1) << (CONV_K - 2)));
+    }
+    emitted += output;
+    return output;
+}
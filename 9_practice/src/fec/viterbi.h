@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fec/conv_code.h"
+
+// Декодер Витерби с мягкими решениями для кода из conv_code.h.
+// Вход - int8 на каждый переданный бит (бит 0 -> +, 0 - стертый/выколотый бит),
+// например из bpsk_soft_demap. Метрики путей 64 состояний - int16 с перенормировкой
+// на каждом шаге. ACS выполняется в векторных регистрах: AVX2 (16 состояний на регистр,
+// выбирается во время работы, если процессор его поддерживает), SSE2 (8) или скалярно.
+// Решения шага - 64 бита в одинаковой для всех вариантов раскладке.
+//
+// Потоковый обратный проход: когда накоплено traceback + chunk шагов, путь
+// прослеживается от лучшего состояния, первые traceback шагов отбрасываются
+// (путь сходится), следующие chunk бит выдаются. Задержка выхода - traceback..traceback+chunk бит.
+
+enum class ViterbiSimd { Auto, Scalar, SSE2, AVX2 };
+
+constexpr size_t VITERBI_TRACEBACK = 96;   // ~14 K: потери от незавершенного пути пренебрежимы
+constexpr size_t VITERBI_CHUNK = 256;
+
+class ViterbiDecoder {
+public:
+    explicit ViterbiDecoder(CodeRate rate = CodeRate::R1_2, ViterbiSimd simd = ViterbiSimd::Auto);
+
+    // Возвращает число выданных бит; в bits должно помещаться soft_count * R + VITERBI_CHUNK
+    size_t decode(const int8_t* soft, size_t soft_count, uint8_t* bits);
+
+    // Выдать все оставшиеся биты. terminated - передатчик вызвал ConvEncoder::terminate(),
+    // тогда путь начинается из нулевого состояния, а K - 1 хвостовых бит отбрасываются
+    size_t flush(uint8_t* bits, bool terminated = true);
+
+    void reset();
+
+    ViterbiSimd simd() const { return simd_level; }
+    static const char* simd_name(ViterbiSimd simd);
+    static bool simd_supported(ViterbiSimd simd);
+
+private:
+    using AcsFunction = void (*)(int16_t* metrics, const int8_t* pairs, size_t steps, uint64_t* decisions);
+
+    void run(size_t steps);
+    size_t traceback(uint8_t state, size_t output, uint8_t* bits);
+    uint8_t best_state() const;
+
+    PunctureMask mask;
+    ViterbiSimd simd_level;
+    AcsFunction acs;
+
+    alignas(32) int16_t metrics[CONV_STATES];
+    std::vector<uint64_t> decisions;   // кольцо на VITERBI_TRACEBACK + VITERBI_CHUNK шагов
+    std::vector<int8_t> pairs;         // депунктурированные пары мягких бит
+    uint64_t written = 0;              // шагов решетки всего
+    uint64_t emitted = 0;              // из них уже выдано бит
+    int phase = 0;                     // позиция в шаблоне выкалывания
+    bool have_a = false;               // A шага уже получен, B придет в следующем вызове
+    int8_t pending_a = 0;
+};
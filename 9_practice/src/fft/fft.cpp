@@ -0,0 +1,82 @@
+#include "fft/fft.h"
+
+#include <cmath>
+#include <stdexcept>
+
+bool is_power_of_two(size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+FftPlan::FftPlan(size_t size, bool inverse) : fft_size(size) {
+    if (!is_power_of_two(size)) {
+        throw std::invalid_argument("Размер БПФ должен быть степенью двойки");
+    }
+
+    size_t log2n = 0;
+    while ((size_t(1) << log2n) < size) ++log2n;
+
+    bit_reverse.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < log2n; ++b) {
+            reversed |= ((i >> b) & 1) << (log2n - 1 - b);
+        }
+        bit_reverse[i] = reversed;
+    }
+
+    double sign = inverse ? 1.0 : -1.0;
+    twiddles.reserve(size);
+    for (size_t half = 1; half < size; half *= 2) {
+        for (size_t k = 0; k < half; ++k) {
+            double angle = sign * PI * k / half;
+            twiddles.push_back(cf32(std::cos(angle), std::sin(angle)));
+        }
+    }
+}
+
+void FftPlan::butterflies(cf32* data) const {
+    float* values = reinterpret_cast<float*>(data);
+    const float* w = reinterpret_cast<const float*>(twiddles.data());
+
+    for (size_t half = 1; half < fft_size; half *= 2) {
+        const float* stage = w + 2 * (half - 1);
+
+        for (size_t start = 0; start < fft_size; start += 2 * half) {
+            float* a = values + 2 * start;
+            float* b = a + 2 * half;
+
+            for (size_t k = 0; k < half; ++k) {
+                float w_re = stage[2 * k];
+                float w_im = stage[2 * k + 1];
+                float t_re = b[2 * k] * w_re - b[2 * k + 1] * w_im;
+                float t_im = b[2 * k] * w_im + b[2 * k + 1] * w_re;
+
+                b[2 * k] = a[2 * k] - t_re;
+                b[2 * k + 1] = a[2 * k + 1] - t_im;
+                a[2 * k] += t_re;
+                a[2 * k + 1] += t_im;
+            }
+        }
+    }
+}
+
+void FftPlan::execute(const cf32* in, cf32* out) const {
+    if (in == out) {
+        execute(out);
+        return;
+    }
+
+    for (size_t i = 0; i < fft_size; ++i) {
+        out[bit_reverse[i]] = in[i];
+    }
+    butterflies(out);
+}
+
+void FftPlan::execute(cf32* data) const {
+    // Бит-реверс на месте: каждую пару меняем один раз
+    for (size_t i = 0; i < fft_size; ++i) {
+        size_t j = bit_reverse[i];
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    butterflies(data);
+}
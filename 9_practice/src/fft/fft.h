@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "sub_funcs.h"
+
+// План БПФ по основанию 2: таблицы поворотных множителей и бит-реверса
+// считаются один раз в конструкторе, execute() только выполняет бабочки.
+class FftPlan {
+public:
+    // size должен быть степенью двойки; inverse - знак экспоненты +j (без нормировки 1/N)
+    explicit FftPlan(size_t size, bool inverse = false);
+
+    size_t size() const { return fft_size; }
+
+    // Преобразование на месте
+    void execute(cf32* data) const;
+
+    // Преобразование из in в out (in не меняется)
+    void execute(const cf32* in, cf32* out) const;
+
+private:
+    void butterflies(cf32* data) const;
+
+    size_t fft_size;
+    std::vector<uint32_t> bit_reverse;
+    // Поворотные множители всех этапов подряд: этап с полуразмером h занимает h элементов
+    std::vector<cf32> twiddles;
+};
+
+bool is_power_of_two(size_t value);
@@ -0,0 +1,69 @@
+#include "filter/fir.h"
+
+#include <cmath>
+
+double window_value(Window window, size_t index, size_t length) {
+    if (length < 2) return 1.0;
+    double x = 2.0 * PI * index / (length - 1);
+
+    switch (window) {
+    case Window::Hamming:
+        return 0.54 - 0.46 * std::cos(x);
+    case Window::Blackman:
+        return 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+    case Window::Rectangular:
+    default:
+        return 1.0;
+    }
+}
+
+std::vector<float> design_lowpass(size_t taps_count, double cutoff, Window window) {
+    std::vector<double> taps(taps_count);
+    double center = (taps_count - 1) / 2.0;
+    double sum = 0;
+
+    for (size_t i = 0; i < taps_count; ++i) {
+        double t = i - center;
+        double sinc = t == 0 ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * t) / (PI * t);
+        taps[i] = sinc * window_value(window, i, taps_count);
+        sum += taps[i];
+    }
+
+    std::vector<float> result(taps_count);
+    for (size_t i = 0; i < taps_count; ++i) {
+        result[i] = static_cast<float>(taps[i] / sum);
+    }
+    return result;
+}
+
+FirFilter::FirFilter(const std::vector<float>& taps)
+    : reversed_taps(taps.rbegin(), taps.rend()),
+      history(taps.empty() ? 0 : taps.size() - 1, cf32(0.0f, 0.0f)) {}
+
+void FirFilter::reset() {
+    std::fill(history.begin(), history.end(), cf32(0.0f, 0.0f));
+}
+
+void FirFilter::process(const cf32* in, cf32* out, size_t samples_count) {
+    size_t taps = reversed_taps.size();
+    if (taps == 0) return;
+
+    size_t keep = taps - 1;
+    history.insert(history.end(), in, in + samples_count);
+
+    const float* h = reversed_taps.data();
+    const float* x = reinterpret_cast<const float*>(history.data());
+
+    for (size_t n = 0; n < samples_count; ++n) {
+        const float* window = x + 2 * n;
+        float acc_re = 0.0f;
+        float acc_im = 0.0f;
+        for (size_t k = 0; k < taps; ++k) {
+            acc_re += h[k] * window[2 * k];
+            acc_im += h[k] * window[2 * k + 1];
+        }
+        out[n] = cf32(acc_re, acc_im);
+    }
+
+    history.erase(history.begin(), history.end() - keep);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Окна для проектирования КИХ-фильтров
+enum class Window {
+    Rectangular,
+    Hamming,
+    Blackman,
+};
+
+// Значение окна в точке index из length
+double window_value(Window window, size_t index, size_t length);
+
+// ФНЧ методом оконного синуса. cutoff - частота среза в долях частоты
+// дискретизации (0..0.5). Коэффициенты нормированы на единичное усиление на нуле.
+std::vector<float> design_lowpass(size_t taps_count, double cutoff, Window window = Window::Blackman);
+
+// Потоковый КИХ-фильтр с вещественными коэффициентами для комплексного сигнала.
+// Хвост предыдущего блока хранится внутри, поэтому блоки можно подавать подряд.
+class FirFilter {
+public:
+    explicit FirFilter(const std::vector<float>& taps);
+
+    size_t taps_count() const { return reversed_taps.size(); }
+
+    // in и out могут совпадать
+    void process(const cf32* in, cf32* out, size_t samples_count);
+    void reset();
+
+private:
+    std::vector<float> reversed_taps;
+    std::vector<cf32> history;
+};
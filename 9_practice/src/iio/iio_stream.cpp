@@ -0,0 +1,284 @@
+#include "iio/iio_stream.h"
+
+#include <cstdio>
+
+#ifdef HAVE_LIBIIO
+#include <iio.h>
+#endif
+
+// ---------- FileBackend ----------
+
+FileBackend::FileBackend(const std::string& path, StreamDirection direction, bool loop)
+    : path(path), direction(direction), loop(loop) {}
+
+FileBackend::~FileBackend() {
+    close();
+}
+
+bool FileBackend::open(size_t buffer_samples, bool) {
+    close();
+
+    file = path == "-" ? (direction == StreamDirection::RX ? stdin : stdout)
+                       : fopen(path.c_str(), direction == StreamDirection::RX ? "rb" : "wb");
+    if (!file) {
+        printf("Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+
+    storage.reset(new int16_t[buffer_samples * 2]());
+    samples = buffer_samples;
+    return true;
+}
+
+void FileBackend::close() {
+    if (file && file != stdin && file != stdout) fclose(file);
+    file = nullptr;
+}
+
+long FileBackend::refill() {
+    if (!file) return -1;
+
+    size_t read_samples = fread(storage.get(), 2 * sizeof(int16_t), samples, file);
+    if (read_samples < samples && loop && file != stdin) {
+        // Запись закончилась: начинаем сначала, как будто эфир продолжается
+        rewind(file);
+        read_samples += fread(storage.get() + 2 * read_samples, 2 * sizeof(int16_t), samples - read_samples, file);
+    }
+    return static_cast<long>(read_samples);
+}
+
+long FileBackend::push(size_t samples_count) {
+    if (!file) return -1;
+    size_t written = fwrite(storage.get(), 2 * sizeof(int16_t), samples_count, file);
+    return static_cast<long>(written);
+}
+
+// ---------- IioBackend ----------
+
+#ifdef HAVE_LIBIIO
+
+// Буферов ядра на поток (значение libiio по умолчанию)
+constexpr unsigned int IIO_KERNEL_BUFFERS = 4;
+
+// Pluto через libiio: буфер ядра создается один раз, данные пишутся прямо в него
+class IioBackend : public StreamBackend {
+public:
+    IioBackend(const std::string& uri, StreamDirection direction, double sample_rate, double frequency,
+               double gain_db)
+        : uri(uri), direction(direction), sample_rate(sample_rate), frequency(frequency), gain_db(gain_db) {}
+
+    ~IioBackend() override { close(); }
+
+    bool open(size_t buffer_samples, bool cyclic) override {
+        close();
+
+        context = iio_create_context_from_uri(uri.c_str());
+        if (!context) {
+            printf("Не удалось подключиться к Pluto SDR по адресу: %s\n", uri.c_str());
+            return false;
+        }
+
+        bool is_tx = direction == StreamDirection::TX;
+        device = iio_context_find_device(context, is_tx ? "cf-ad9361-dds-core-lpc" : "cf-ad9361-lpc");
+        struct iio_device* phy = iio_context_find_device(context, "ad9361-phy");
+        if (!device || !phy) {
+            printf("Не удалось найти устройства AD9361\n");
+            close();
+            return false;
+        }
+
+        // Частота дискретизации и гетеродин (altvoltage0 - RX LO, altvoltage1 - TX LO)
+        struct iio_channel* phy_channel = iio_device_find_channel(phy, "voltage0", is_tx);
+        iio_channel_attr_write_longlong(phy_channel, "sampling_frequency", (long long)sample_rate);
+        if (!is_tx) iio_channel_attr_write(phy_channel, "gain_control_mode", "manual");
+        iio_channel_attr_write_double(phy_channel, "hardwaregain", gain_db);
+        iio_channel_attr_write_longlong(iio_device_find_channel(phy, is_tx ? "altvoltage1" : "altvoltage0", true),
+                                        "frequency", (long long)frequency);
+
+        struct iio_channel* channel_i = iio_device_find_channel(device, "voltage0", is_tx);
+        struct iio_channel* channel_q = iio_device_find_channel(device, "voltage1", is_tx);
+        if (!channel_i || !channel_q) {
+            printf("Не удалось найти каналы I/Q\n");
+            close();
+            return false;
+        }
+        iio_channel_enable(channel_i);
+        iio_channel_enable(channel_q);
+
+        // Число буферов ядра задаем явно: от него зависит, сколько старых отсчетов
+        // лежит в очереди после перестройки гетеродина
+        iio_device_set_kernel_buffers_count(device, IIO_KERNEL_BUFFERS);
+        buffer_handle = iio_device_create_buffer(device, buffer_samples, cyclic);
+        if (!buffer_handle) {
+            printf("Не удалось создать буфер libiio\n");
+            close();
+            return false;
+        }
+
+        samples = buffer_samples;
+        return true;
+    }
+
+    void close() override {
+        if (buffer_handle) iio_buffer_destroy(buffer_handle);
+        if (context) iio_context_destroy(context);
+        buffer_handle = nullptr;
+        context = nullptr;
+        device = nullptr;
+    }
+
+    int16_t* buffer() override {
+        return buffer_handle ? static_cast<int16_t*>(iio_buffer_start(buffer_handle)) : nullptr;
+    }
+
+    size_t buffer_samples() const override { return samples; }
+
+    size_t queued_buffers() const override { return IIO_KERNEL_BUFFERS; }
+
+    long refill() override {
+        ssize_t bytes = iio_buffer_refill(buffer_handle);
+        return bytes < 0 ? static_cast<long>(bytes) : static_cast<long>(bytes / (2 * sizeof(int16_t)));
+    }
+
+    long push(size_t samples_count) override {
+        ssize_t bytes = samples_count < samples ? iio_buffer_push_partial(buffer_handle, samples_count)
+                                                : iio_buffer_push(buffer_handle);
+        return bytes < 0 ? static_cast<long>(bytes) : static_cast<long>(bytes / (2 * sizeof(int16_t)));
+    }
+
+    bool set_frequency(double new_frequency) override {
+        struct iio_device* phy = context ? iio_context_find_device(context, "ad9361-phy") : nullptr;
+        const char* lo_name = direction == StreamDirection::TX ? "altvoltage1" : "altvoltage0";
+        struct iio_channel* lo = phy ? iio_device_find_channel(phy, lo_name, true) : nullptr;
+        if (!lo || iio_channel_attr_write_longlong(lo, "frequency", (long long)new_frequency) < 0) return false;
+        frequency = new_frequency;
+        return true;
+    }
+
+private:
+    std::string uri;
+    StreamDirection direction;
+    double sample_rate;
+    double frequency;
+    double gain_db;
+    struct iio_context* context = nullptr;
+    struct iio_device* device = nullptr;
+    struct iio_buffer* buffer_handle = nullptr;
+    size_t samples = 0;
+};
+
+#endif
+
+std::unique_ptr<StreamBackend> make_stream_backend(const std::string& uri, StreamDirection direction,
+                                                   double sample_rate, double frequency, double gain_db) {
+    if (uri.compare(0, 5, "file:") == 0) {
+        // RX из файла крутится по кругу, чтобы поток не заканчивался
+        return std::unique_ptr<StreamBackend>(new FileBackend(uri.substr(5), direction, true));
+    }
+    if (uri == "-") {
+        return std::unique_ptr<StreamBackend>(new FileBackend("-", direction));
+    }
+
+#ifdef HAVE_LIBIIO
+    return std::unique_ptr<StreamBackend>(new IioBackend(uri, direction, sample_rate, frequency, gain_db));
+#else
+    (void)sample_rate;
+    (void)frequency;
+    (void)gain_db;
+    printf("Сборка без libiio: доступны только file:/path и -\n");
+    return nullptr;
+#endif
+}
+
+// ---------- IioStream ----------
+
+IioStream::IioStream(std::unique_ptr<StreamBackend> backend, StreamDirection direction)
+    : backend(std::move(backend)), direction(direction) {}
+
+IioStream::~IioStream() {
+    stop();
+    if (backend) backend->close();
+}
+
+bool IioStream::open(size_t buffer_samples) {
+    if (!backend) return false;
+    samples_per_buffer = buffer_samples;
+    opened = backend->open(buffer_samples, false);
+    return opened;
+}
+
+bool IioStream::tx_commit(size_t samples_count) {
+    long sent = backend->push(samples_count);
+    if (sent < 0) {
+        statistics.errors++;
+        return false;
+    }
+    statistics.buffers++;
+    statistics.samples += sent;
+    return true;
+}
+
+const int16_t* IioStream::rx_next(size_t* samples_count) {
+    long received = backend->refill();
+    if (received <= 0) {
+        if (received < 0) statistics.errors++;
+        *samples_count = 0;
+        return nullptr;
+    }
+    statistics.buffers++;
+    statistics.samples += received;
+    *samples_count = static_cast<size_t>(received);
+    return backend->buffer();
+}
+
+bool IioStream::transmit_cyclic(const int16_t* iq, size_t samples_count) {
+    if (!backend || direction != StreamDirection::TX) return false;
+    stop();
+
+    // Циклический буфер имеет размер ровно одной волны
+    backend->close();
+    opened = backend->open(samples_count, true);
+    if (!opened) return false;
+
+    std::copy(iq, iq + samples_count * 2, backend->buffer());
+    return tx_commit(samples_count);
+}
+
+bool IioStream::start_rx(RxHandler handler) {
+    if (!opened || direction != StreamDirection::RX || active) return false;
+    // Прошлый поток мог завершиться сам (конец данных, ошибка), но еще не присоединен
+    if (worker.joinable()) worker.join();
+    active = true;
+
+    worker = std::thread([this, handler] {
+        while (active) {
+            size_t count = 0;
+            const int16_t* iq = rx_next(&count);
+            if (!iq) break;
+            handler(iq, count);
+        }
+        active = false;
+    });
+    return true;
+}
+
+bool IioStream::start_tx(TxProducer producer) {
+    if (!opened || direction != StreamDirection::TX || active) return false;
+    if (worker.joinable()) worker.join();
+    active = true;
+
+    worker = std::thread([this, producer] {
+        while (active) {
+            // Указатель берется заново: после push libiio может отдать другой блок
+            size_t count = producer(backend->buffer(), samples_per_buffer);
+            if (count == 0 || !tx_commit(count)) break;
+        }
+        active = false;
+    });
+    return true;
+}
+
+void IioStream::stop() {
+    active = false;
+    if (worker.joinable()) worker.join();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "sub_funcs.h"
+
+enum class StreamDirection {
+    RX,
+    TX,
+};
+
+// Источник/приемник буферов CS16. Буфер выделяется один раз при open()
+// и живет до close(): производитель пишет прямо в buffer(), без memcpy.
+class StreamBackend {
+public:
+    virtual ~StreamBackend() = default;
+
+    virtual bool open(size_t buffer_samples, bool cyclic) = 0;
+    virtual void close() = 0;
+
+    // Текущий буфер (для libiio - память iio_buffer_start, меняется после push/refill)
+    virtual int16_t* buffer() = 0;
+    virtual size_t buffer_samples() const = 0;
+
+    // RX: заполнить буфер, вернуть число отсчетов (< 0 - ошибка, 0 - конец данных)
+    virtual long refill() = 0;
+
+    // TX: отправить первые samples_count отсчетов буфера
+    virtual long push(size_t samples_count) = 0;
+
+    // RX: сколько буферов принимается заранее, до refill (у libiio - буферы ядра)
+    virtual size_t queued_buffers() const { return 1; }
+
+    // Перестройка гетеродина открытого потока; false - не поддерживается или ошибка
+    virtual bool set_frequency(double frequency) {
+        (void)frequency;
+        return false;
+    }
+};
+
+// Подмена железа: RX читает CS16 из файла или канала, TX пишет в него.
+// Позволяет гонять конвейер без Pluto (uri вида "file:/path").
+class FileBackend : public StreamBackend {
+public:
+    FileBackend(const std::string& path, StreamDirection direction, bool loop = false);
+    ~FileBackend() override;
+
+    bool open(size_t buffer_samples, bool cyclic) override;
+    void close() override;
+    int16_t* buffer() override { return storage.get(); }
+    size_t buffer_samples() const override { return samples; }
+    long refill() override;
+    long push(size_t samples_count) override;
+
+private:
+    std::string path;
+    StreamDirection direction;
+    bool loop;
+    FILE* file = nullptr;
+    std::unique_ptr<int16_t[]> storage;
+    size_t samples = 0;
+};
+
+// Создает backend по uri: "file:/path" - FileBackend, иначе libiio ("ip:...", "usb:...").
+// gain_db - hardwaregain AD9361 (для RX включает ручную регулировку)
+std::unique_ptr<StreamBackend> make_stream_backend(const std::string& uri, StreamDirection direction,
+                                                   double sample_rate, double frequency, double gain_db);
+
+struct IioStreamStats {
+    std::atomic<uint64_t> buffers{0};
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+// Долгоживущий поток RX/TX поверх StreamBackend.
+// Буферы не пересоздаются между передачами; в потоковом режиме refill/push
+// выполняет отдельный поток, а обработчик работает прямо с памятью буфера.
+class IioStream {
+public:
+    // RX: данные буфера действительны только внутри вызова
+    using RxHandler = std::function<void(const int16_t* iq, size_t samples_count)>;
+    // TX: заполнить iq (не больше capacity отсчетов), вернуть сколько заполнено; 0 - стоп
+    using TxProducer = std::function<size_t(int16_t* iq, size_t capacity)>;
+
+    IioStream(std::unique_ptr<StreamBackend> backend, StreamDirection direction);
+    ~IioStream();
+
+    IioStream(const IioStream&) = delete;
+    IioStream& operator=(const IioStream&) = delete;
+
+    bool open(size_t buffer_samples);
+
+    // Однократные операции без отдельного потока
+    int16_t* tx_buffer() { return backend->buffer(); }
+    bool tx_commit(size_t samples_count);
+    const int16_t* rx_next(size_t* samples_count);
+
+    // Циклическая передача: волна загружается один раз, дальше ее повторяет DMA
+    bool transmit_cyclic(const int16_t* iq, size_t samples_count);
+
+    // Потоковый режим
+    bool start_rx(RxHandler handler);
+    bool start_tx(TxProducer producer);
+    void stop();
+    bool running() const { return active; }
+
+    const IioStreamStats& stats() const { return statistics; }
+
+private:
+    std::unique_ptr<StreamBackend> backend;
+    StreamDirection direction;
+    size_t samples_per_buffer = 0;
+    bool opened = false;
+
+    std::thread worker;
+    std::atomic<bool> active{false};
+    IioStreamStats statistics;
+};
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iio/iio_stream.h"
+#include "nco/nco.h"
+
+constexpr double SAMPLING_RATE = 1000000;
+constexpr double CARRIER_FREQUENCY = 800000000;
+constexpr double RX_GAIN = 10.0;
+constexpr double TX_GAIN = -30.0;
+constexpr size_t BUFFER_SIZE = 1920 * 16;
+
+// Использование:
+//   iio_stream.out rx <uri> [seconds]      - непрерывный прием, счетчик отсчетов
+//   iio_stream.out tx <uri> [seconds]      - непрерывная передача тона
+//   iio_stream.out cyclic <uri> [seconds]  - тон загружается один раз и повторяется
+// uri: "ip:192.168.2.1", "usb:", "file:/tmp/capture.pcm" или "-" (stdin/stdout)
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Использование: %s <rx|tx|cyclic> <uri> [seconds]\n", argv[0]);
+        return -1;
+    }
+
+    std::string mode = argv[1];
+    std::string uri = argv[2];
+    double seconds = argc > 3 ? atof(argv[3]) : 1.0;
+    StreamDirection direction = mode == "rx" ? StreamDirection::RX : StreamDirection::TX;
+
+    double gain = direction == StreamDirection::RX ? RX_GAIN : TX_GAIN;
+    IioStream stream(make_stream_backend(uri, direction, SAMPLING_RATE, CARRIER_FREQUENCY, gain), direction);
+
+    // Тон 100 кГц: NCO пишет прямо в буфер потока
+    Nco tone(SAMPLING_RATE, 100000);
+    std::vector<cf32> ones(BUFFER_SIZE, cf32(0.5f, 0.0f));
+    std::vector<cf32> work(BUFFER_SIZE);
+
+    if (mode == "cyclic") {
+        // Период тона укладывается в буфер целиком: 100 кГц * 1000 отсчетов / 1 МГц = 100 периодов
+        const size_t period_samples = 1000;
+        std::vector<int16_t> waveform(period_samples * 2);
+        tone.mix(ones.data(), work.data(), period_samples);
+        cf32_to_cs16(work.data(), waveform.data(), period_samples);
+
+        if (!stream.transmit_cyclic(waveform.data(), period_samples)) return -1;
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        printf("Циклическая передача завершена\n");
+        return 0;
+    }
+
+    if (!stream.open(BUFFER_SIZE)) return -1;
+
+    auto start = std::chrono::steady_clock::now();
+    bool started = direction == StreamDirection::RX
+        ? stream.start_rx([](const int16_t*, size_t) {})
+        : stream.start_tx([&](int16_t* iq, size_t capacity) {
+              tone.mix(ones.data(), work.data(), capacity);
+              cf32_to_cs16(work.data(), iq, capacity);
+              return capacity;
+          });
+    if (!started) return -1;
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stream.stop();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const IioStreamStats& stats = stream.stats();
+    printf("Буферов: %llu, отсчетов: %llu, ошибок: %llu, скорость %.1f Мотсч/с\n",
+           (unsigned long long)stats.buffers, (unsigned long long)stats.samples,
+           (unsigned long long)stats.errors, stats.samples / elapsed / 1e6);
+    return 0;
+}
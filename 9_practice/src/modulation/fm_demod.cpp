@@ -0,0 +1,19 @@
+#include "modulation/fm_demod.h"
+
+#include <cmath>
+
+void FmDemodulator::process(const cf32* in, float* out, size_t samples_count) {
+    float prev_re = previous.real();
+    float prev_im = previous.imag();
+
+    for (size_t i = 0; i < samples_count; ++i) {
+        float re = in[i].real();
+        float im = in[i].imag();
+        // arg(x[n] * conj(x[n-1]))
+        out[i] = std::atan2(im * prev_re - re * prev_im, re * prev_re + im * prev_im);
+        prev_re = re;
+        prev_im = im;
+    }
+
+    if (samples_count) previous = in[samples_count - 1];
+}
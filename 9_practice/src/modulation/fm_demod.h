@@ -0,0 +1,14 @@
+#pragma once
+
+#include "sub_funcs.h"
+
+// Частотный демодулятор (квадратурный дискриминатор), как блок WBFM Receive
+// из 1 практики: выход - приращение фазы между соседними отсчетами, рад/отсчет.
+class FmDemodulator {
+public:
+    void process(const cf32* in, float* out, size_t samples_count);
+    void reset() { previous = cf32(1.0f, 0.0f); }
+
+private:
+    cf32 previous = cf32(1.0f, 0.0f);
+};
@@ -0,0 +1,62 @@
+#include <cmath>
+
+#include "modulation/mapper.h"
+
+void bpsk_map(const uint8_t* bits, size_t bits_count, cf32* symbols) {
+    float* out = reinterpret_cast<float*>(symbols);
+
+    for (size_t i = 0; i < bits_count; ++i) {
+        out[2 * i] = 1.0f - 2.0f * (bits[i] & 1);
+        out[2 * i + 1] = 0.0f;
+    }
+}
+
+void qpsk_map(const uint8_t* bits, size_t bits_count, cf32* symbols) {
+    float* out = reinterpret_cast<float*>(symbols);
+
+    // Пара бит ложится ровно на пару float (I, Q)
+    for (size_t i = 0; i + 1 < bits_count; i += 2) {
+        out[i] = QPSK_AMPLITUDE * (1.0f - 2.0f * (bits[i] & 1));
+        out[i + 1] = QPSK_AMPLITUDE * (1.0f - 2.0f * (bits[i + 1] & 1));
+    }
+}
+
+void bpsk_demap(const cf32* symbols, size_t symbols_count, uint8_t* bits) {
+    const float* in = reinterpret_cast<const float*>(symbols);
+
+    for (size_t i = 0; i < symbols_count; ++i) {
+        bits[i] = in[2 * i] < 0.0f;
+    }
+}
+
+void qpsk_demap(const cf32* symbols, size_t symbols_count, uint8_t* bits) {
+    const float* in = reinterpret_cast<const float*>(symbols);
+
+    for (size_t i = 0; i < symbols_count * 2; ++i) {
+        bits[i] = in[i] < 0.0f;
+    }
+}
+
+static int8_t soft_value(float x) {
+    if (x > 127.0f) return 127;
+    if (x < -127.0f) return -127;
+    return static_cast<int8_t>(std::lrint(x));
+}
+
+void bpsk_soft_demap(const cf32* symbols, size_t symbols_count, float scale, int8_t* soft) {
+    const float* in = reinterpret_cast<const float*>(symbols);
+
+    for (size_t i = 0; i < symbols_count; ++i) {
+        soft[i] = soft_value(in[2 * i] * scale);
+    }
+}
+
+void qpsk_soft_demap(const cf32* symbols, size_t symbols_count, float scale, int8_t* soft) {
+    const float* in = reinterpret_cast<const float*>(symbols);
+
+    // Компоненты QPSK меньше в 1/QPSK_AMPLITUDE раз - приводим к шкале BPSK
+    scale /= QPSK_AMPLITUDE;
+    for (size_t i = 0; i < symbols_count * 2; ++i) {
+        soft[i] = soft_value(in[i] * scale);
+    }
+}
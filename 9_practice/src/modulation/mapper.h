@@ -0,0 +1,24 @@
+#pragma once
+
+#include "sub_funcs.h"
+
+// Отображение бит в символы по правилам 8 практики: бит 0 -> +1, бит 1 -> -1.
+// Биты - по одному на байт (0/1), как после convert_string_to_bits.
+// QPSK нормирована на единичную энергию символа: каждая компонента +-1/sqrt(2).
+
+constexpr float QPSK_AMPLITUDE = 0.70710678f;
+
+// bits_count символов
+void bpsk_map(const uint8_t* bits, size_t bits_count, cf32* symbols);
+
+// bits_count / 2 символов, первый бит пары - I, второй - Q
+void qpsk_map(const uint8_t* bits, size_t bits_count, cf32* symbols);
+
+// Жесткие решения: symbols_count бит для BPSK, 2 * symbols_count для QPSK
+void bpsk_demap(const cf32* symbols, size_t symbols_count, uint8_t* bits);
+void qpsk_demap(const cf32* symbols, size_t symbols_count, uint8_t* bits);
+
+// Мягкие решения для декодера Витерби: int8, знак как у символа (бит 0 -> +),
+// модуль - уверенность; scale переводит амплитуду в единицы int8 с насыщением до +-127
+void bpsk_soft_demap(const cf32* symbols, size_t symbols_count, float scale, int8_t* soft);
+void qpsk_soft_demap(const cf32* symbols, size_t symbols_count, float scale, int8_t* soft);
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "nco/nco.h"
+
+constexpr double SAMPLING_RATE = 1000000;
+constexpr size_t BLOCK_SIZE = 1920;
+
+// Тон на заданной частоте для проверки переноса
+std::vector<cf32> make_tone(double frequency_hz, size_t samples_count) {
+    std::vector<cf32> tone(samples_count);
+    for (size_t i = 0; i < samples_count; ++i) {
+        double phase = 2.0 * PI * frequency_hz * i / SAMPLING_RATE;
+        tone[i] = cf32(std::cos(phase), std::sin(phase));
+    }
+    return tone;
+}
+
+int main() {
+    // Переносим тон +200 кГц в ноль: после смесителя должен остаться постоянный фазор
+    std::vector<cf32> tone = make_tone(200000, BLOCK_SIZE * 1000);
+    std::vector<cf32> shifted(tone.size());
+
+    Nco nco(SAMPLING_RATE, -200000);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < tone.size(); offset += BLOCK_SIZE) {
+        nco.mix(tone.data() + offset, shifted.data() + offset, BLOCK_SIZE);
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    double max_error = 0;
+    for (const cf32& s : shifted) {
+        max_error = std::fmax(max_error, std::abs(s - cf32(1.0f, 0.0f)));
+    }
+
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    printf("Сдвиг частоты: %.2f нс/отсчет, максимальная ошибка %.2e\n", ns / tone.size(), max_error);
+
+    // Прыжки по каналам без перестройки гетеродина: фаза на границах непрерывна
+    const double channels[] = {-300000, -100000, 100000, 300000};
+    const size_t hop_length = 1237;
+    std::vector<cf32> ones(hop_length, cf32(1.0f, 0.0f));
+    std::vector<cf32> out(hop_length);
+
+    for (double channel : channels) {
+        double phase_before = nco.phase();
+        nco.set_frequency(channel);
+        nco.mix(ones.data(), out.data(), out.size());
+        printf("Канал %+.0f Гц: фаза до перестройки %.4f, первый отсчет %.4f\n",
+               channel, phase_before, std::arg(out[0]));
+    }
+
+    return 0;
+}
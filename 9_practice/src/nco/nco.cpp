@@ -0,0 +1,111 @@
+#include "nco/nco.h"
+
+#include <cmath>
+
+Nco::Nco(double sample_rate, double frequency_hz)
+    : sample_rate(sample_rate), frequency_hz(frequency_hz) {
+    rebuild_lanes(0.0);
+}
+
+void Nco::set_frequency(double new_frequency_hz) {
+    frequency_hz = new_frequency_hz;
+    rebuild_lanes(phase());
+}
+
+void Nco::set_phase(double phase_rad) {
+    rebuild_lanes(phase_rad);
+}
+
+double Nco::phase() const {
+    return std::atan2(lane_im[0], lane_re[0]);
+}
+
+void Nco::rebuild_lanes(double phase_rad) {
+    // Приращение фазы за отсчет, считаем в double, чтобы не копить ошибку частоты
+    double delta = 2.0 * PI * frequency_hz / sample_rate;
+
+    for (size_t k = 0; k < NCO_LANES; ++k) {
+        lane_re[k] = static_cast<float>(std::cos(phase_rad + delta * k));
+        lane_im[k] = static_cast<float>(std::sin(phase_rad + delta * k));
+    }
+
+    step_re = static_cast<float>(std::cos(delta * NCO_LANES));
+    step_im = static_cast<float>(std::sin(delta * NCO_LANES));
+    blocks_since_renorm = 0;
+}
+
+void Nco::renormalize() {
+    // Первый порядок Ньютона для 1/|p|: амплитуда уходит от 1 очень медленно
+    for (size_t k = 0; k < NCO_LANES; ++k) {
+        float power = lane_re[k] * lane_re[k] + lane_im[k] * lane_im[k];
+        float gain = 1.5f - 0.5f * power;
+        lane_re[k] *= gain;
+        lane_im[k] *= gain;
+    }
+    blocks_since_renorm = 0;
+}
+
+void Nco::mix(const cf32* in, cf32* out, size_t samples_count) {
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+
+    size_t i = 0;
+    for (; i + NCO_LANES <= samples_count; i += NCO_LANES) {
+        const float* x = src + 2 * i;
+        float* y = dst + 2 * i;
+
+        for (size_t k = 0; k < NCO_LANES; ++k) {
+            float x_re = x[2 * k];
+            float x_im = x[2 * k + 1];
+            y[2 * k] = x_re * lane_re[k] - x_im * lane_im[k];
+            y[2 * k + 1] = x_re * lane_im[k] + x_im * lane_re[k];
+        }
+
+        for (size_t k = 0; k < NCO_LANES; ++k) {
+            float re = lane_re[k] * step_re - lane_im[k] * step_im;
+            float im = lane_re[k] * step_im + lane_im[k] * step_re;
+            lane_re[k] = re;
+            lane_im[k] = im;
+        }
+
+        if (++blocks_since_renorm == NCO_RENORM_INTERVAL) {
+            renormalize();
+        }
+    }
+
+    // Хвост короче блока: обрабатываем поштучно и сдвигаем дорожки на остаток
+    size_t tail = samples_count - i;
+    if (tail == 0) return;
+
+    for (size_t k = 0; k < tail; ++k) {
+        float x_re = src[2 * (i + k)];
+        float x_im = src[2 * (i + k) + 1];
+        dst[2 * (i + k)] = x_re * lane_re[k] - x_im * lane_im[k];
+        dst[2 * (i + k) + 1] = x_re * lane_im[k] + x_im * lane_re[k];
+    }
+
+    // Следующий отсчет имеет фазу дорожки tail: перестраиваем дорожки от нее
+    rebuild_lanes(std::atan2(lane_im[tail], lane_re[tail]));
+}
+
+void Nco::mix_cs16(int16_t* iq, size_t samples_count) {
+    // Обрабатываем кусками, чтобы промежуточный буфер жил в кэше
+    constexpr size_t CHUNK = 1024;
+    cf32 work[CHUNK];
+
+    for (size_t offset = 0; offset < samples_count; offset += CHUNK) {
+        size_t count = samples_count - offset < CHUNK ? samples_count - offset : CHUNK;
+        int16_t* chunk = iq + 2 * offset;
+
+        for (size_t i = 0; i < count; ++i) {
+            work[i] = cf32(chunk[2 * i], chunk[2 * i + 1]);
+        }
+
+        mix(work, work, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            chunk[2 * i] = saturate_int16(work[i].real());
+            chunk[2 * i + 1] = saturate_int16(work[i].imag());
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "sub_funcs.h"
+
+// Цифровой гетеродин (NCO) для сдвига частоты внутри полосы дискретизации.
+// Вместо пересчета cos/sin на каждый отсчет используется рекуррентный поворот:
+// NCO_LANES фазоров, каждый из которых за блок поворачивается на NCO_LANES шагов.
+// Такой цикл без зависимостей между дорожками векторизуется компилятором.
+constexpr size_t NCO_LANES = 8;
+
+// Раз в столько блоков фазоры нормируются обратно на единичную окружность
+constexpr size_t NCO_RENORM_INTERVAL = 512;
+
+class Nco {
+public:
+    Nco(double sample_rate, double frequency_hz = 0.0);
+
+    // Смена частоты без разрыва фазы: текущий фазор сохраняется
+    void set_frequency(double frequency_hz);
+    double frequency() const { return frequency_hz; }
+
+    void set_phase(double phase_rad);
+    double phase() const;
+
+    // out[i] = in[i] * exp(j * phase[i]); in и out могут совпадать
+    void mix(const cf32* in, cf32* out, size_t samples_count);
+
+    // Сдвиг частоты прямо в CS16 буфере (RX после readStream, TX перед writeStream)
+    void mix_cs16(int16_t* iq, size_t samples_count);
+
+private:
+    void rebuild_lanes(double phase_rad);
+    void renormalize();
+
+    double sample_rate;
+    double frequency_hz;
+
+    // Фазоры дорожек, хранятся раздельно для векторизации
+    alignas(32) float lane_re[NCO_LANES];
+    alignas(32) float lane_im[NCO_LANES];
+
+    // Поворот на NCO_LANES отсчетов
+    float step_re;
+    float step_im;
+
+    size_t blocks_since_renorm = 0;
+};
@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ofdm/ofdm.h"
+#include "prbs/prbs.h"
+
+// Канал: задержка кадра, эхо -6 дБ через 3 отсчета (короче префикса), расстройка, шум
+static void simulate_channel(const std::vector<cf32>& tx, size_t delay, double cfo, double snr_db, std::mt19937& gen,
+                             std::vector<cf32>& rx) {
+    rx.assign(tx.size() + delay + 64, cf32());
+    for (size_t n = 0; n < tx.size(); ++n) {
+        rx[delay + n] += tx[n];
+        rx[delay + n + 3] += tx[n] * cf32(0.0f, 0.5f);
+    }
+    double signal_power = OFDM_RMS * OFDM_RMS * 1.25;
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(signal_power / std::pow(10, snr_db / 10) / 2)));
+    for (size_t n = 0; n < rx.size(); ++n) {
+        double phase = 2 * PI * cfo * n;
+        rx[n] = rx[n] * cf32(static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))) +
+                cf32(noise(gen), noise(gen));
+    }
+}
+
+// Использование:
+//   ofdm.out [fft=64] [cp=16] [carriers=52] [pilots=13] [mod=qpsk|bpsk] [symbols=100] [frames=100]
+//            [snr=20] [cfo=0.3] [out=ofdm_frame.pcm]
+// cfo - расстройка в долях разноса поднесущих (|cfo| < 1 ловится преамбулой)
+// out - один кадр в CS16 для передачи, например, через beacon.out
+int main(int argc, char** argv) {
+    OfdmConfig config;
+    size_t symbols = 100;
+    size_t frames = 100;
+    double snr_db = 20.0;
+    double cfo = 0.3;
+    std::string out;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "fft") config.fft_size = strtoul(value, nullptr, 10);
+        else if (key == "cp") config.cp_length = strtoul(value, nullptr, 10);
+        else if (key == "carriers") config.active_carriers = strtoul(value, nullptr, 10);
+        else if (key == "pilots") config.pilot_spacing = strtoul(value, nullptr, 10);
+        else if (key == "mod") config.modulation = std::string(value) == "bpsk" ? OfdmModulation::BPSK : OfdmModulation::QPSK;
+        else if (key == "symbols") symbols = strtoul(value, nullptr, 10);
+        else if (key == "frames") frames = strtoul(value, nullptr, 10);
+        else if (key == "snr") snr_db = atof(value);
+        else if (key == "cfo") cfo = atof(value);
+        else if (key == "out") out = value;
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (!is_power_of_two(config.fft_size) || config.cp_length >= config.fft_size || symbols == 0) {
+        printf("fft - степень двойки, cp < fft, symbols > 0\n");
+        return -1;
+    }
+
+    OfdmModulator modulator(config);
+    OfdmDemodulator demodulator(config);
+    const OfdmLayout& layout = modulator.layout();
+    size_t bits_per_frame = layout.bits_per_symbol() * symbols;
+    size_t frame_samples = layout.frame_samples(symbols);
+
+    printf("OFDM: БПФ %zu, префикс %zu, данные %zu + пилоты %zu поднесущих, %zu бит/символ\n", config.fft_size,
+           config.cp_length, layout.data_bins.size(), layout.pilot_bins.size(), layout.bits_per_symbol());
+    printf("Кадр: %zu символов, %zu отсчетов, %.3f бит/отсчет (одна несущая 10 отсч./символ: %.3f)\n", symbols,
+           frame_samples, static_cast<double>(bits_per_frame) / frame_samples,
+           config.modulation == OfdmModulation::QPSK ? 0.2 : 0.1);
+
+    std::vector<uint8_t> tx_bits(bits_per_frame), rx_bits(bits_per_frame);
+    std::vector<cf32> tx(frame_samples), rx;
+    PrbsGenerator prbs(PrbsType::PRBS23);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<size_t> delay_dist(10, 500);
+
+    size_t errors = 0, lost = 0;
+    double evm = 0, cfo_error = 0;
+    double modulate_s = 0, demodulate_s = 0;
+
+    for (size_t f = 0; f < frames; ++f) {
+        prbs.fill_bits(tx_bits.data(), tx_bits.size());
+
+        auto t0 = std::chrono::steady_clock::now();
+        modulator.modulate(tx_bits.data(), symbols, tx.data());
+        auto t1 = std::chrono::steady_clock::now();
+
+        simulate_channel(tx, delay_dist(gen), cfo / config.fft_size, snr_db, gen, rx);
+
+        auto t2 = std::chrono::steady_clock::now();
+        OfdmSync sync;
+        OfdmQuality quality;
+        bool ok = demodulator.synchronize(rx.data(), rx.size(), sync) &&
+                  demodulator.demodulate(rx.data(), rx.size(), sync, symbols, rx_bits.data(), &quality);
+        auto t3 = std::chrono::steady_clock::now();
+
+        modulate_s += std::chrono::duration<double>(t1 - t0).count();
+        demodulate_s += std::chrono::duration<double>(t3 - t2).count();
+        if (!ok) {
+            ++lost;
+            continue;
+        }
+        for (size_t i = 0; i < bits_per_frame; ++i) errors += tx_bits[i] != rx_bits[i];
+        evm += quality.evm_percent;
+        cfo_error += std::fabs(sync.cfo * config.fft_size - cfo);
+    }
+
+    size_t received = frames - lost;
+    printf("Кадров: %zu, потеряно: %zu\n", frames, lost);
+    if (received) {
+        printf("BER: %.3e (%zu ошибок), EVM: %.2f %%, ошибка CFO: %.4f поднесущей\n",
+               static_cast<double>(errors) / (received * bits_per_frame), errors, evm / received,
+               cfo_error / received);
+    }
+    double total = static_cast<double>(frames * frame_samples);
+    printf("Модулятор: %.1f Мотсч/с, демодулятор (с синхронизацией): %.1f Мотсч/с\n", total / modulate_s / 1e6,
+           total / demodulate_s / 1e6);
+
+    if (!out.empty()) {
+        std::vector<int16_t> cs16(2 * frame_samples);
+        // OFDM_RMS = 0.25 -> пики в пределах полной шкалы с запасом ~12 дБ
+        cf32_to_cs16(tx.data(), cs16.data(), frame_samples);
+        FILE* file = fopen(out.c_str(), "wb");
+        if (!file) {
+            printf("Не удалось открыть %s\n", out.c_str());
+            return -1;
+        }
+        fwrite(cs16.data(), sizeof(int16_t), cs16.size(), file);
+        fclose(file);
+        printf("Кадр записан в %s\n", out.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+
+#include "modulation/mapper.h"
+#include "nco/nco.h"
+#include "ofdm/ofdm.h"
+#include "prbs/prbs.h"
+
+// Псевдослучайные QPSK-значения для преамбулы и обучающего символа
+static std::vector<cf32> training_values(size_t count, uint32_t seed) {
+    std::vector<uint8_t> bits(2 * count);
+    PrbsGenerator generator(PrbsType::PRBS15, seed);
+    generator.fill_bits(bits.data(), bits.size());
+    std::vector<cf32> values(count);
+    qpsk_map(bits.data(), bits.size(), values.data());
+    return values;
+}
+
+// Частотная сетка -> временной символ с префиксом
+static void synthesize(const FftPlan& plan, std::vector<cf32>& bins, size_t cp, float scale, cf32* out) {
+    plan.execute(bins.data());
+    for (cf32& x : bins) x *= scale;
+    std::copy(bins.end() - cp, bins.end(), out);
+    std::copy(bins.begin(), bins.end(), out + cp);
+}
+
+OfdmLayout::OfdmLayout(const OfdmConfig& config) : config(config) {
+    size_t n = config.fft_size;
+    size_t half = std::min(config.active_carriers / 2, n / 2 - 1);
+
+    // Логические поднесущие -half..-1, 1..half -> бины БПФ
+    for (size_t i = 0; i < 2 * half; ++i) {
+        long k = i < half ? static_cast<long>(i) - static_cast<long>(half) : static_cast<long>(i - half + 1);
+        size_t bin = static_cast<size_t>((k + static_cast<long>(n)) % static_cast<long>(n));
+        active_bins.push_back(bin);
+        bool pilot = config.pilot_spacing && i % config.pilot_spacing == config.pilot_spacing / 2;
+        (pilot ? pilot_bins : data_bins).push_back(bin);
+    }
+
+    scale = OFDM_RMS / std::sqrt(static_cast<float>(active_bins.size()));
+    FftPlan inverse(n, true);
+    std::vector<cf32> bins(n);
+
+    // Преамбула: только четные бины с удвоенной мощностью -> период n/2 во времени
+    std::vector<cf32> values = training_values(active_bins.size(), 0x1234);
+    std::fill(bins.begin(), bins.end(), cf32());
+    for (size_t i = 0; i < active_bins.size(); ++i) {
+        if (active_bins[i] % 2 == 0) bins[active_bins[i]] = values[i] * std::sqrt(2.0f);
+    }
+    preamble.resize(symbol_samples());
+    synthesize(inverse, bins, config.cp_length, scale, preamble.data());
+
+    training_freq = training_values(active_bins.size(), 0x4321);
+    std::fill(bins.begin(), bins.end(), cf32());
+    for (size_t i = 0; i < active_bins.size(); ++i) bins[active_bins[i]] = training_freq[i];
+    training.resize(symbol_samples());
+    synthesize(inverse, bins, config.cp_length, scale, training.data());
+}
+
+size_t OfdmLayout::bits_per_symbol() const {
+    return data_bins.size() * (config.modulation == OfdmModulation::QPSK ? 2 : 1);
+}
+
+OfdmModulator::OfdmModulator(const OfdmConfig& config) : grid_layout(config), inverse(config.fft_size, true) {}
+
+void OfdmModulator::modulate(const uint8_t* bits, size_t symbols_count, cf32* out) {
+    const OfdmLayout& l = grid_layout;
+    const size_t n = l.config.fft_size;
+    const size_t cells = l.data_bins.size();
+
+    std::copy(l.preamble.begin(), l.preamble.end(), out);
+    std::copy(l.training.begin(), l.training.end(), out + l.symbol_samples());
+    out += 2 * l.symbol_samples();
+
+    // Все биты кадра - одним вызовом маппера
+    data_cells.resize(symbols_count * cells);
+    if (l.config.modulation == OfdmModulation::QPSK) qpsk_map(bits, 2 * data_cells.size(), data_cells.data());
+    else bpsk_map(bits, data_cells.size(), data_cells.data());
+
+    grid.resize(n);
+    for (size_t s = 0; s < symbols_count; ++s) {
+        std::fill(grid.begin(), grid.end(), cf32());
+        const cf32* row = &data_cells[s * cells];
+        for (size_t c = 0; c < cells; ++c) grid[l.data_bins[c]] = row[c];
+        for (size_t bin : l.pilot_bins) grid[bin] = cf32(1.0f, 0.0f);
+        synthesize(inverse, grid, l.config.cp_length, l.scale, out + s * l.symbol_samples());
+    }
+}
+
+OfdmDemodulator::OfdmDemodulator(const OfdmConfig& config) : grid_layout(config), forward(config.fft_size) {}
+
+bool OfdmDemodulator::synchronize(const cf32* in, size_t samples_count, OfdmSync& sync, float threshold) {
+    const size_t half = grid_layout.config.fft_size / 2;
+    const size_t cp = grid_layout.config.cp_length;
+    if (samples_count < 2 * half + 1) return false;
+
+    // P(d) = sum r*[d+m] r[d+m+L], R(d) = sum (|r[d+m]|^2 + |r[d+m+L]|^2) / 2, m = 0..L-1;
+    // энергия по обеим половинам держит метрику в 0..1 и на шуме; сдвиг окна - O(1)
+    std::complex<double> p = 0;
+    double r = 0;
+    for (size_t m = 0; m < half; ++m) {
+        p += std::complex<double>(std::conj(in[m]) * in[m + half]);
+        r += 0.5 * (std::norm(in[m]) + std::norm(in[m + half]));
+    }
+
+    const size_t last = samples_count - 2 * half;
+    metric.resize(last + 1);
+    correlation.resize(last + 1);
+    // Преамбула дает плато длиной около префикса, шум на коротких БПФ - одиночные выбросы
+    // выше порога. Кадр засчитывается, только если метрика держится над порогом min_run отсчетов
+    const size_t min_run = std::max<size_t>(cp, 1);
+    size_t first_hit = last + 1;
+    size_t run_start = 0, run = 0;
+    for (size_t d = 0; d <= last; ++d) {
+        metric[d] = r > 0 ? static_cast<float>(std::norm(p) / (r * r)) : 0.0f;
+        correlation[d] = p;
+        if (first_hit > last) {
+            if (metric[d] > threshold) {
+                if (run++ == 0) run_start = d;
+                if (run >= min_run) first_hit = run_start;
+            } else {
+                run = 0;
+            }
+        }
+        // Преамбула найдена - дальше символа с префиксом считать незачем
+        if (first_hit <= last && d > first_hit + 2 * half + cp) break;
+        if (d == last) break;
+        p += std::complex<double>(std::conj(in[d + half]) * in[d + 2 * half]) -
+             std::complex<double>(std::conj(in[d]) * in[d + half]);
+        r += 0.5 * (std::norm(in[d + 2 * half]) - std::norm(in[d]));
+    }
+
+    if (first_hit > last) {
+        sync.metric = *std::max_element(metric.begin(), metric.end());
+        return false;
+    }
+
+    size_t end = std::min(last, first_hit + 2 * half + cp);
+    size_t best = std::max_element(metric.begin() + first_hit, metric.begin() + end + 1) - metric.begin();
+    sync.metric = metric[best];
+
+    // Плато длиной в префикс: [начало префикса, начало окна БПФ]. Берем середину
+    // плато по уровню 0.9 и сдвигаемся на четверть префикса вперед - окно БПФ
+    // начинается чуть раньше символа, с запасом под задержанные лучи
+    size_t left = best, right = best;
+    while (left > first_hit && metric[left - 1] >= 0.9f * metric[best]) --left;
+    while (right < end && metric[right + 1] >= 0.9f * metric[best]) ++right;
+    size_t middle = (left + right) / 2;
+    sync.frame_start = middle + cp / 4;
+
+    // CFO по сумме корреляций вдоль плато: фаза за L отсчетов
+    std::complex<double> sum = 0;
+    for (size_t d = left; d <= right; ++d) sum += correlation[d];
+    sync.cfo = std::arg(sum) / (2 * PI * half);
+    return true;
+}
+
+bool OfdmDemodulator::demodulate(const cf32* in, size_t samples_count, const OfdmSync& sync, size_t symbols_count,
+                                 uint8_t* bits, OfdmQuality* quality) {
+    const OfdmLayout& l = grid_layout;
+    const size_t n = l.config.fft_size;
+    const size_t step = l.symbol_samples();
+    const size_t cells = l.data_bins.size();
+
+    // frame_start - окно БПФ преамбулы; обучающий символ - через step, данные - дальше
+    size_t needed = sync.frame_start + (symbols_count + 2) * step - l.config.cp_length;
+    if (needed > samples_count) return false;
+
+    // Компенсация CFO сразу для всего кадра
+    std::vector<cf32> frame(in + sync.frame_start, in + needed);
+    Nco nco(1.0, -sync.cfo);
+    nco.mix(frame.data(), frame.data(), frame.size());
+
+    // Обучающий символ -> H на каждом бине -> коэффициенты эквалайзера 1/H
+    grid.resize(n * (symbols_count + 1));
+    forward.execute(&frame[step], grid.data());
+    equalizer.assign(n, cf32());
+    for (size_t i = 0; i < l.active_bins.size(); ++i) {
+        cf32 h = grid[l.active_bins[i]] / l.training_freq[i];
+        if (std::norm(h) > 0) equalizer[l.active_bins[i]] = 1.0f / h;
+    }
+
+    // БПФ всех символов данных, затем эквализация одним проходом по сетке
+    for (size_t s = 0; s < symbols_count; ++s) {
+        forward.execute(&frame[(s + 2) * step], &grid[s * n]);
+    }
+    for (size_t s = 0; s < symbols_count; ++s) {
+        cf32* row = &grid[s * n];
+        for (size_t k = 0; k < n; ++k) row[k] *= equalizer[k];
+    }
+
+    // Общая фазовая ошибка каждого символа по пилотам (остаток CFO, фазовый шум)
+    data_cells.resize(symbols_count * cells);
+    double error_power = 0;
+    for (size_t s = 0; s < symbols_count; ++s) {
+        const cf32* row = &grid[s * n];
+        cf32 pilot_sum = 0;
+        for (size_t bin : l.pilot_bins) pilot_sum += row[bin];
+        cf32 derotate = std::abs(pilot_sum) > 0 ? std::conj(pilot_sum) / std::abs(pilot_sum) : cf32(1.0f, 0.0f);
+
+        cf32* out = &data_cells[s * cells];
+        for (size_t c = 0; c < cells; ++c) out[c] = row[l.data_bins[c]] * derotate;
+    }
+
+    if (l.config.modulation == OfdmModulation::QPSK) qpsk_demap(data_cells.data(), data_cells.size(), bits);
+    else bpsk_demap(data_cells.data(), data_cells.size(), bits);
+
+    if (quality) {
+        // EVM относительно решений: для QPSK точка +-1/sqrt(2), для BPSK +-1
+        for (const cf32& x : data_cells) {
+            cf32 ideal = l.config.modulation == OfdmModulation::QPSK
+                             ? cf32(std::copysign(QPSK_AMPLITUDE, x.real()), std::copysign(QPSK_AMPLITUDE, x.imag()))
+                             : cf32(std::copysign(1.0f, x.real()), 0.0f);
+            error_power += std::norm(x - ideal);
+        }
+        quality->evm_percent = data_cells.empty() ? 0.0 : 100.0 * std::sqrt(error_power / data_cells.size());
+    }
+    return true;
+}
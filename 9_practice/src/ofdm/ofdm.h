@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "fft/fft.h"
+#include "sub_funcs.h"
+
+// OFDM поверх мапперов BPSK/QPSK из modulation/mapper.h.
+// Кадр: преамбула Шмидля-Кокса (заняты только четные поднесущие, поэтому во времени
+// две одинаковые половины), обучающий символ со всеми поднесущими для оценки канала,
+// затем символы данных. У каждого символа циклический префикс.
+// Обработка пакетная: маппинг всех бит кадра одним вызовом, затем БПФ построчно
+// по сетке [символ][поднесущая] и эквализация одним проходом по всей сетке.
+
+enum class OfdmModulation { BPSK, QPSK };
+
+struct OfdmConfig {
+    size_t fft_size = 64;
+    size_t cp_length = 16;
+    size_t active_carriers = 52;    // занятые поднесущие без DC, поровну по обе стороны
+    size_t pilot_spacing = 13;      // каждая pilot_spacing-я занятая поднесущая - пилот
+    OfdmModulation modulation = OfdmModulation::QPSK;
+};
+
+// СКЗ сигнала во временной области: запас на пик-фактор OFDM
+constexpr float OFDM_RMS = 0.25f;
+
+// Раскладка поднесущих, общая для передатчика и приемника
+struct OfdmLayout {
+    explicit OfdmLayout(const OfdmConfig& config);
+
+    OfdmConfig config;
+    std::vector<size_t> data_bins;     // номера бинов БПФ с данными
+    std::vector<size_t> pilot_bins;
+    std::vector<size_t> active_bins;   // все занятые (для обучающего символа)
+    std::vector<cf32> preamble;        // временная область с префиксом
+    std::vector<cf32> training_freq;   // значения обучающего символа на active_bins
+    std::vector<cf32> training;        // временная область с префиксом
+    float scale;                       // нормировка ОБПФ до OFDM_RMS
+
+    size_t symbol_samples() const { return config.fft_size + config.cp_length; }
+    size_t bits_per_symbol() const;
+    size_t frame_samples(size_t symbols_count) const { return (symbols_count + 2) * symbol_samples(); }
+};
+
+class OfdmModulator {
+public:
+    explicit OfdmModulator(const OfdmConfig& config);
+
+    const OfdmLayout& layout() const { return grid_layout; }
+
+    // symbols_count символов данных по bits_per_symbol() бит; out - frame_samples() отсчетов
+    void modulate(const uint8_t* bits, size_t symbols_count, cf32* out);
+
+private:
+    OfdmLayout grid_layout;
+    FftPlan inverse;
+    std::vector<cf32> data_cells;
+    std::vector<cf32> grid;
+};
+
+struct OfdmSync {
+    size_t frame_start = 0;   // первый отсчет окна БПФ преамбулы (после префикса)
+    double cfo = 0.0;         // расстройка, циклов на отсчет
+    float metric = 0.0f;      // максимум метрики Шмидля-Кокса (0..1)
+};
+
+struct OfdmQuality {
+    double evm_percent = 0.0;
+};
+
+class OfdmDemodulator {
+public:
+    explicit OfdmDemodulator(const OfdmConfig& config);
+
+    // Поиск преамбулы: метрика |P(d)|^2 / R(d)^2 со скользящими суммами, O(1) на отсчет;
+    // кадр - первое плато над threshold длиной не меньше префикса
+    bool synchronize(const cf32* in, size_t samples_count, OfdmSync& sync, float threshold = 0.5f);
+
+    // Демодуляция symbols_count символов данных кадра, найденного synchronize()
+    bool demodulate(const cf32* in, size_t samples_count, const OfdmSync& sync, size_t symbols_count,
+                    uint8_t* bits, OfdmQuality* quality = nullptr);
+
+private:
+    OfdmLayout grid_layout;
+    FftPlan forward;
+    std::vector<float> metric;
+    std::vector<std::complex<double>> correlation;
+    std::vector<cf32> grid;
+    std::vector<cf32> equalizer;   // 1 / H на каждом бине
+    std::vector<cf32> data_cells;
+};
@@ -0,0 +1,42 @@
+#include <cstring>
+
+#include "packet/crc32.h"
+
+constexpr uint32_t CRC32_POLY = 0xEDB88320u;
+
+struct Crc32Tables {
+    uint32_t table[8][256];
+
+    Crc32Tables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (CRC32_POLY & (0u - (crc & 1)));
+            table[0][i] = crc;
+        }
+        // table[k][i] - CRC байта i, за которым следуют k нулевых байт
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+        }
+    }
+};
+
+static const Crc32Tables CRC32_TABLES;
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t length) {
+    const auto& t = CRC32_TABLES.table;
+    crc = ~crc;
+
+    // Порядок байт little-endian: младший байт слова - первый байт данных
+    while (length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length--) crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    return ~crc;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, отраженный многочлен 0xEDB88320, как в zlib).
+// Slicing-by-8: восемь таблиц по 256 слов, за итерацию обрабатывается 8 байт
+// восемью независимыми выборками вместо восьми последовательных сдвигов.
+
+// crc - значение предыдущего вызова для продолжения (0 для начала)
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t length);
+
+inline uint32_t crc32(const uint8_t* data, size_t length) { return crc32_update(0, data, length); }
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "packet/packet.h"
+
+// Самая длинная серия одинаковых бит - то, что мешает символьной синхронизации
+static size_t longest_run(const uint64_t* words, size_t bits_count) {
+    size_t best = 0, run = 0;
+    int last = -1;
+    for (size_t i = 0; i < bits_count; ++i) {
+        int bit = (words[i / 64] >> (i % 64)) & 1;
+        run = bit == last ? run + 1 : 1;
+        last = bit;
+        best = std::max(best, run);
+    }
+    return best;
+}
+
+// Использование:
+//   packet.out [packets=10000] [payload=256] [text="..."] [ber=1e-5] [gap=100] [block=64] [show=5]
+// payload - длина случайных данных (если не задан text), gap - до стольких случайных бит
+// между кадрами, block - слов на вызов process(), show - сколько пакетов распечатать
+int main(int argc, char** argv) {
+    PacketConfig config;
+    size_t packets = 10000;
+    size_t payload_length = 256;
+    std::string text;
+    double ber = 1e-5;
+    size_t gap = 100;
+    size_t block_words = 64;
+    size_t show = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "packets") packets = strtoul(value, nullptr, 10);
+        else if (key == "payload") payload_length = strtoul(value, nullptr, 10);
+        else if (key == "text") text = value;
+        else if (key == "ber") ber = atof(value);
+        else if (key == "gap") gap = strtoul(value, nullptr, 10);
+        else if (key == "block") block_words = strtoul(value, nullptr, 10);
+        else if (key == "show") show = strtoul(value, nullptr, 10);
+        else {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (!text.empty()) payload_length = text.size();
+    if (payload_length > config.max_payload || block_words == 0) {
+        printf("payload <= %zu, block > 0\n", config.max_payload);
+        return -1;
+    }
+
+    // Данные: текст или случайные байты; у всех пакетов одинаковые, кроме номера в заголовке
+    std::mt19937_64 gen(1);
+    std::vector<uint8_t> payload(payload_length);
+    if (!text.empty()) memcpy(payload.data(), text.data(), payload_length);
+    else for (uint8_t& b : payload) b = static_cast<uint8_t>(gen());
+
+    PacketFramer framer(config);
+    size_t max_bits = packets * (framer.frame_bits(payload_length) + gap);
+    std::vector<uint64_t> stream(max_bits / 64 + 2);
+    std::uniform_int_distribution<size_t> gap_dist(0, gap);
+
+    size_t position = 0;
+    double frame_seconds = 0;
+    for (size_t p = 0; p < packets; ++p) {
+        // Промежуток случайных бит - кадры начинаются с произвольного бита
+        for (size_t g = gap_dist(gen); g > 0; --g, ++position) {
+            stream[position / 64] = (stream[position / 64] & ((uint64_t(1) << (position % 64)) - 1)) |
+                                    (uint64_t(gen() & 1) << (position % 64));
+        }
+        auto start = std::chrono::steady_clock::now();
+        position = framer.write(payload.data(), payload_length, stream.data(), position);
+        frame_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Худший случай для символьной синхронизации - нулевые данные: без скремблера
+    // это одна серия длиной во весь пакет
+    std::vector<uint8_t> zeros(payload_length);
+    std::vector<uint64_t> zero_frame(framer.frame_bits(payload_length) / 64 + 2);
+    size_t zero_bits = PacketFramer(config).write(zeros.data(), payload_length, zero_frame.data(), 0);
+    printf("Кадров: %zu по %zu байт, поток %zu бит\n", packets, payload_length, position);
+    printf("Нулевые данные: серия одинаковых бит %zu без скремблера, %zu в кадре\n", payload_length * 8,
+           longest_run(zero_frame.data(), zero_bits));
+
+    // Канал: независимые ошибки с вероятностью ber (геометрические интервалы между ними)
+    size_t flipped = 0;
+    if (ber > 0) {
+        std::geometric_distribution<size_t> next_error(ber);
+        for (size_t i = next_error(gen); i < position; i += next_error(gen) + 1, ++flipped) {
+            stream[i / 64] ^= uint64_t(1) << (i % 64);
+        }
+    }
+
+    size_t shown = 0, corrupted = 0;
+    PacketDeframer deframer(config, [&](const PacketInfo& info, const uint8_t* data) {
+        if (info.length != payload_length || memcmp(data, payload.data(), payload_length) != 0) ++corrupted;
+        if (shown < show) {
+            printf("  пакет %5u: бит %10llu, %zu байт, ошибок в синхрослове %d\n", info.sequence,
+                   static_cast<unsigned long long>(info.bit_position), info.length, info.sync_errors);
+            ++shown;
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t w = 0; w * 64 < position; w += block_words) {
+        size_t bits = std::min(block_words * 64, position - w * 64);
+        deframer.process(&stream[w], bits);
+    }
+    double deframe_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const PacketStats& stats = deframer.stats();
+    printf("Ошибок в канале: %zu бит\n", flipped);
+    printf("Принято: %llu, ошибок CRC: %llu, ошибок заголовка: %llu, пропущено: %llu, испорчено после CRC: %zu\n",
+           static_cast<unsigned long long>(stats.packets), static_cast<unsigned long long>(stats.crc_errors),
+           static_cast<unsigned long long>(stats.header_errors), static_cast<unsigned long long>(stats.lost),
+           corrupted);
+    printf("Формирование: %.0f пакетов/с, разбор: %.0f пакетов/с (%.1f Мбит/с потока)\n", packets / frame_seconds,
+           packets / deframe_seconds, position / deframe_seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "packet/crc32.h"
+#include "packet/packet.h"
+
+// До 64 бит потока с позиции position; биты за концом потока не определены
+static uint64_t read_bits(const uint64_t* words, size_t bits_count, size_t position) {
+    size_t index = position / 64, shift = position % 64;
+    uint64_t value = words[index] >> shift;
+    if (shift && (index + 1) * 64 < bits_count) value |= words[index + 1] << (64 - shift);
+    return value;
+}
+
+// count <= 64 бит value (старшие - нули) в поток; младшие биты первого слова сохраняются
+static void write_bits(uint64_t* words, size_t position, uint64_t value, size_t count) {
+    size_t index = position / 64, shift = position % 64;
+    if (shift == 0) {
+        words[index] = value;
+        return;
+    }
+    words[index] = (words[index] & ((uint64_t(1) << shift) - 1)) | (value << shift);
+    if (shift + count > 64) words[index + 1] = value >> (64 - shift);
+}
+
+static uint64_t low_bits(uint64_t value, size_t count) {
+    return count >= 64 ? value : value & ((uint64_t(1) << count) - 1);
+}
+
+static void read_bytes(const uint64_t* words, size_t bits_count, size_t position, uint8_t* out, size_t length) {
+    for (size_t k = 0; k < length; k += 8) {
+        uint64_t value = read_bits(words, bits_count, position + 8 * k);
+        memcpy(out + k, &value, std::min<size_t>(8, length - k));
+    }
+}
+
+static size_t write_bytes(uint64_t* words, size_t position, const uint8_t* data, size_t length) {
+    for (size_t k = 0; k < length; k += 8) {
+        size_t count = std::min<size_t>(8, length - k);
+        uint64_t value = 0;
+        memcpy(&value, data + k, count);
+        write_bits(words, position + 8 * k, value, 8 * count);
+    }
+    return position + 8 * length;
+}
+
+// Аддитивный скремблер: XOR словами по 64 бита
+static void scramble(uint8_t* data, const uint8_t* whitening, size_t length) {
+    size_t k = 0;
+    for (; k + 8 <= length; k += 8) {
+        uint64_t a, b;
+        memcpy(&a, data + k, 8);
+        memcpy(&b, whitening + k, 8);
+        a ^= b;
+        memcpy(data + k, &a, 8);
+    }
+    for (; k < length; ++k) data[k] ^= whitening[k];
+}
+
+// Последовательность скремблера на самый длинный кадр, считается словами PRBS
+static std::vector<uint8_t> make_whitening(const PacketConfig& config) {
+    size_t length = PACKET_HEADER_BYTES + config.max_payload + PACKET_CRC_BYTES;
+    std::vector<uint64_t> words((length + 7) / 8);
+    PrbsGenerator(config.scrambler).fill(words.data(), words.size());
+    std::vector<uint8_t> bytes(length);
+    memcpy(bytes.data(), words.data(), length);
+    return bytes;
+}
+
+static size_t body_bits(size_t length) {
+    return PACKET_SYNC_BITS + 8 * (PACKET_HEADER_BYTES + length + PACKET_CRC_BYTES);
+}
+
+void pack_bits(const uint8_t* bits, size_t bits_count, uint64_t* words) {
+    for (size_t i = 0; i < bits_count; i += 64) {
+        uint64_t word = 0;
+        size_t n = std::min<size_t>(64, bits_count - i);
+        for (size_t b = 0; b < n; ++b) word |= uint64_t(bits[i + b] & 1) << b;
+        words[i / 64] = word;
+    }
+}
+
+void unpack_bits(const uint64_t* words, size_t bits_count, uint8_t* bits) {
+    for (size_t i = 0; i < bits_count; ++i) bits[i] = (words[i / 64] >> (i % 64)) & 1;
+}
+
+PacketFramer::PacketFramer(const PacketConfig& config) : config(config), whitening(make_whitening(config)) {}
+
+size_t PacketFramer::frame_bits(size_t length) const {
+    return 8 * config.preamble_bytes + body_bits(length);
+}
+
+size_t PacketFramer::write(const uint8_t* payload, size_t length, uint64_t* stream, size_t bit_position) {
+    if (length > config.max_payload) {
+        printf("Пакет %zu байт длиннее max_payload %zu\n", length, config.max_payload);
+        return bit_position;
+    }
+
+    // Заголовок и CRC - little-endian
+    size_t body = PACKET_HEADER_BYTES + length;
+    frame.resize(body + PACKET_CRC_BYTES);
+    frame[0] = length & 0xFF;
+    frame[1] = length >> 8;
+    frame[2] = sequence & 0xFF;
+    frame[3] = sequence >> 8;
+    memcpy(&frame[PACKET_HEADER_BYTES], payload, length);
+    uint32_t crc = crc32(frame.data(), body);
+    for (size_t k = 0; k < PACKET_CRC_BYTES; ++k) frame[body + k] = (crc >> (8 * k)) & 0xFF;
+    scramble(frame.data(), whitening.data(), frame.size());
+
+    size_t position = bit_position;
+    for (size_t k = 0; k < config.preamble_bytes; ++k, position += 8) write_bits(stream, position, 0x55, 8);
+    write_bits(stream, position, config.sync_word, PACKET_SYNC_BITS);
+    position += PACKET_SYNC_BITS;
+    position = write_bytes(stream, position, frame.data(), frame.size());
+    ++sequence;
+    return position;
+}
+
+PacketDeframer::PacketDeframer(const PacketConfig& config, Callback callback)
+    : config(config), callback(std::move(callback)), whitening(make_whitening(config)) {}
+
+void PacketDeframer::reset() {
+    current = PacketStats();
+    carry_bits = 0;
+    carry_base = 0;
+    stream_bits = 0;
+    have_sequence = false;
+}
+
+// Разбор начал кадра p в [start, limit). Возвращает позицию, с которой данных не хватило
+// (ее и дальше нужно перенести в следующий вызов), или первую позицию за limit
+size_t PacketDeframer::scan(const uint64_t* words, size_t bits_count, size_t start, size_t limit, uint64_t base) {
+    const size_t header_end = PACKET_SYNC_BITS + 8 * PACKET_HEADER_BYTES;
+    size_t p = start;
+    while (p < limit) {
+        if (p + header_end > bits_count) return p;
+
+        uint32_t window = static_cast<uint32_t>(read_bits(words, bits_count, p));
+        int sync_errors = __builtin_popcount(window ^ config.sync_word);
+        if (sync_errors > config.sync_errors) {
+            ++p;
+            continue;
+        }
+
+        uint8_t header[PACKET_HEADER_BYTES];
+        read_bytes(words, bits_count, p + PACKET_SYNC_BITS, header, PACKET_HEADER_BYTES);
+        scramble(header, whitening.data(), PACKET_HEADER_BYTES);
+        size_t length = header[0] | (header[1] << 8);
+        if (length > config.max_payload) {
+            ++current.header_errors;
+            ++p;
+            continue;
+        }
+        if (p + body_bits(length) > bits_count) return p;
+
+        size_t body = PACKET_HEADER_BYTES + length;
+        frame.resize(body + PACKET_CRC_BYTES);
+        read_bytes(words, bits_count, p + PACKET_SYNC_BITS, frame.data(), frame.size());
+        scramble(frame.data(), whitening.data(), frame.size());
+        uint32_t crc = 0;
+        for (size_t k = 0; k < PACKET_CRC_BYTES; ++k) crc |= uint32_t(frame[body + k]) << (8 * k);
+        if (crc != crc32(frame.data(), body)) {
+            ++current.crc_errors;
+            ++p;
+            continue;
+        }
+
+        PacketInfo info;
+        info.sequence = static_cast<uint16_t>(frame[2] | (frame[3] << 8));
+        info.length = length;
+        info.bit_position = base + p;
+        info.sync_errors = sync_errors;
+        if (have_sequence) current.lost += static_cast<uint16_t>(info.sequence - next_sequence);
+        have_sequence = true;
+        next_sequence = info.sequence + 1;
+        ++current.packets;
+        current.bytes += length;
+        callback(info, frame.data() + PACKET_HEADER_BYTES);
+        p += body_bits(length);
+    }
+    return p;
+}
+
+void PacketDeframer::keep_tail(const uint64_t* words, size_t from, size_t to, uint64_t base) {
+    std::vector<uint64_t> tail((to - from + 63) / 64 + 1);
+    for (size_t k = from; k < to; k += 64) {
+        size_t count = std::min<size_t>(64, to - k);
+        write_bits(tail.data(), k - from, low_bits(read_bits(words, to, k), count), count);
+    }
+    carry.swap(tail);
+    carry_bits = to - from;
+    carry_base = base + from;
+}
+
+void PacketDeframer::process(const uint64_t* words, size_t bits_count) {
+    size_t start = 0;
+
+    // Кадры, начавшиеся в хвосте прошлого блока: хвост + начало нового блока длиной
+    // в самый длинный кадр. Основная часть блока разбирается прямо в words
+    if (carry_bits) {
+        size_t take = std::min(bits_count, body_bits(config.max_payload));
+        size_t joined = carry_bits + take;
+        carry.resize((joined + 63) / 64 + 1);
+        for (size_t k = 0; k < take; k += 64) {
+            size_t count = std::min<size_t>(64, take - k);
+            write_bits(carry.data(), carry_bits + k, low_bits(read_bits(words, bits_count, k), count), count);
+        }
+
+        size_t stop = scan(carry.data(), joined, 0, carry_bits, carry_base);
+        if (stop < carry_bits) {
+            // Кадр не поместился и в объединение - значит, новый блок короче кадра
+            keep_tail(std::vector<uint64_t>(carry).data(), stop, joined, carry_base);
+            stream_bits += bits_count;
+            return;
+        }
+        start = stop - carry_bits;
+    }
+
+    size_t stop = scan(words, bits_count, start, bits_count, stream_bits);
+    if (stop < bits_count) keep_tail(words, stop, bits_count, stream_bits);
+    else carry_bits = 0;
+    stream_bits += bits_count;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "prbs/prbs.h"
+
+// Пакетный уровень над упакованным битовым потоком (64 бита в слове, первый бит -
+// младший, как у PrbsGenerator). Байт k пакета занимает биты 8k..8k+7, поэтому
+// на little-endian машине байты и слова потока совпадают без перестановок.
+//
+// Кадр: преамбула 0x55 (чередование 0/1 для синхронизации по символам),
+// синхрослово 32 бита, затем скремблированные заголовок (длина 16 бит,
+// номер пакета 16 бит), данные и CRC-32 от заголовка и данных.
+// Скремблер аддитивный: XOR с PRBS, которая перезапускается в каждом пакете,
+// поэтому последовательность считается один раз и накладывается словами.
+
+constexpr size_t PACKET_SYNC_BITS = 32;
+constexpr size_t PACKET_HEADER_BYTES = 4;
+constexpr size_t PACKET_CRC_BYTES = 4;
+
+struct PacketConfig {
+    uint32_t sync_word = 0x1ACFFC1Du;   // маркер CCSDS
+    size_t preamble_bytes = 4;
+    size_t max_payload = 2048;
+    int sync_errors = 2;                 // допустимо ошибочных бит в синхрослове
+    PrbsType scrambler = PrbsType::PRBS15;
+};
+
+struct PacketInfo {
+    uint16_t sequence = 0;
+    size_t length = 0;
+    uint64_t bit_position = 0;   // начало синхрослова от начала потока
+    int sync_errors = 0;
+};
+
+struct PacketStats {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t crc_errors = 0;
+    uint64_t header_errors = 0;   // длина больше max_payload
+    uint64_t lost = 0;            // пропуски по номерам пакетов
+};
+
+// Упаковка/распаковка бит по одному на байт (мапперы, PRBS::fill_bits)
+void pack_bits(const uint8_t* bits, size_t bits_count, uint64_t* words);
+void unpack_bits(const uint64_t* words, size_t bits_count, uint8_t* bits);
+
+class PacketFramer {
+public:
+    explicit PacketFramer(const PacketConfig& config);
+
+    // Длина кадра в битах с преамбулой
+    size_t frame_bits(size_t length) const;
+
+    // Кадр пишется в stream с бита bit_position (младшие биты слова до него сохраняются,
+    // старшие перезаписываются). Возвращает позицию за кадром или bit_position при ошибке
+    size_t write(const uint8_t* payload, size_t length, uint64_t* stream, size_t bit_position);
+
+private:
+    PacketConfig config;
+    std::vector<uint8_t> whitening;
+    std::vector<uint8_t> frame;
+    uint16_t sequence = 0;
+};
+
+class PacketDeframer {
+public:
+    using Callback = std::function<void(const PacketInfo& info, const uint8_t* payload)>;
+
+    PacketDeframer(const PacketConfig& config, Callback callback);
+
+    // Потоковый разбор: поиск синхрослова с любого бита прямо в words, без распаковки.
+    // Хвост, где кадр мог начаться, но не поместился, переносится в следующий вызов
+    void process(const uint64_t* words, size_t bits_count);
+
+    const PacketStats& stats() const { return current; }
+    void reset();
+
+private:
+    size_t scan(const uint64_t* words, size_t bits_count, size_t start, size_t limit, uint64_t base);
+    void keep_tail(const uint64_t* words, size_t from, size_t to, uint64_t base);
+
+    PacketConfig config;
+    Callback callback;
+    PacketStats current;
+    std::vector<uint8_t> whitening;
+    std::vector<uint8_t> frame;
+    std::vector<uint64_t> carry;   // перенесенный хвост + начало нового блока
+    size_t carry_bits = 0;
+    uint64_t carry_base = 0;       // позиция хвоста в потоке
+    uint64_t stream_bits = 0;      // принято бит всего
+    bool have_sequence = false;
+    uint16_t next_sequence = 0;
+};
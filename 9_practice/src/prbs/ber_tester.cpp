@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cmath>
+
+#include "prbs/ber_tester.h"
+
+void ber_interval(uint64_t errors, uint64_t bits, double z, double& low, double& high) {
+    if (bits == 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+    double n = static_cast<double>(bits);
+    double p = errors / n;
+    double z2 = z * z;
+    double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double spread = z * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    low = std::max(0.0, center - spread);
+    high = std::min(1.0, center + spread);
+}
+
+double ber_upper_bound_no_errors(uint64_t bits, double confidence) {
+    if (bits == 0) return 1.0;
+    return -std::log(1.0 - confidence) / bits;
+}
+
+BerTester::BerTester(PrbsType type) : taps(prbs_taps(type)) {
+    reset();
+}
+
+void BerTester::reset() {
+    history_count = 0;
+    matches = 0;
+    window_errors = 0;
+    window_words = 0;
+    partial = 0;
+    partial_bits = 0;
+    current = BerStats();
+}
+
+void BerTester::search(uint64_t word) {
+    current.search_words++;
+
+    if (history_count == PRBS_HISTORY_WORDS) {
+        matches = prbs_next_word(history, taps) == word ? matches + 1 : 0;
+    }
+
+    // Сдвигаем историю принятых слов
+    if (history_count < PRBS_HISTORY_WORDS) {
+        history[history_count++] = word;
+    } else {
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = word;
+    }
+
+    if (matches >= BER_SYNC_WORDS) {
+        current.locked = true;
+        window_errors = 0;
+        window_words = 0;
+    }
+}
+
+void BerTester::process(const uint64_t* words, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!current.locked) {
+            search(words[i]);
+            continue;
+        }
+
+        // Опорный генератор идет по собственной истории, ошибки приема в него не попадают
+        uint64_t expected = prbs_next_word(history, taps);
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = expected;
+
+        uint64_t errors = __builtin_popcountll(words[i] ^ expected);
+        current.errors += errors;
+        current.bits += 64;
+
+        window_errors += errors;
+        if (++window_words == BER_LOSS_WORDS) {
+            if (window_errors > BER_LOSS_RATIO * 64 * BER_LOSS_WORDS) {
+                // Ошибки окна считаем следствием срыва, а не канала
+                current.errors -= window_errors;
+                current.bits -= 64 * BER_LOSS_WORDS;
+                current.locked = false;
+                current.sync_losses++;
+                history_count = 0;
+                matches = 0;
+            }
+            window_errors = 0;
+            window_words = 0;
+        }
+    }
+}
+
+void BerTester::process_bits(const uint8_t* bits, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        partial |= uint64_t(bits[i] & 1) << partial_bits;
+        if (++partial_bits == 64) {
+            process(&partial, 1);
+            partial = 0;
+            partial_bits = 0;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "prbs/prbs.h"
+
+// Приемный счетчик ошибок для PRBS.
+// Синхронизация: по трем принятым словам предсказывается следующее; после
+// BER_SYNC_WORDS совпадений подряд история принятых слов становится состоянием
+// опорного генератора, и дальше ошибки считаются popcount(принято ^ опора).
+// Фаза и битовый сдвиг потока находятся автоматически - рекурсия от них не зависит.
+// Если в окне BER_LOSS_WORDS слов ошибок больше BER_LOSS_RATIO, синхронизация
+// считается потерянной (проскальзывание бит) и поиск начинается заново.
+
+constexpr int BER_SYNC_WORDS = 4;
+constexpr int BER_LOSS_WORDS = 64;
+constexpr double BER_LOSS_RATIO = 0.2;
+
+struct BerStats {
+    uint64_t bits = 0;          // проверено бит в синхронизме
+    uint64_t errors = 0;
+    uint64_t sync_losses = 0;
+    uint64_t search_words = 0;  // слов, ушедших на поиск синхронизации
+    bool locked = false;
+};
+
+// Доверительный интервал Уилсона для BER (z = 1.96 -> 95 %)
+void ber_interval(uint64_t errors, uint64_t bits, double z, double& low, double& high);
+
+// Верхняя граница BER при нуле ошибок с доверием confidence: -ln(1 - confidence) / bits
+double ber_upper_bound_no_errors(uint64_t bits, double confidence);
+
+class BerTester {
+public:
+    explicit BerTester(PrbsType type);
+
+    // Принятые слова в той же упаковке, что у PrbsGenerator
+    void process(const uint64_t* words, size_t count);
+
+    // Распакованные биты (0/1 по одному на байт), например после демаппера
+    void process_bits(const uint8_t* bits, size_t count);
+
+    const BerStats& stats() const { return current; }
+    double ber() const { return current.bits ? double(current.errors) / current.bits : 0.0; }
+    void reset();
+
+private:
+    void search(uint64_t word);
+
+    PrbsTaps taps;
+    uint64_t history[PRBS_HISTORY_WORDS];
+    int history_count;
+    int matches;
+
+    uint64_t window_errors;
+    int window_words;
+
+    // Биты process_bits, еще не собранные в слово
+    uint64_t partial;
+    int partial_bits;
+
+    BerStats current;
+};
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "prbs/ber_tester.h"
+
+constexpr size_t BLOCK_WORDS = 16384;
+
+// Внесение ошибок с заданной вероятностью: расстояния между ошибками
+// распределены геометрически, поэтому на бит приходится O(BER) работы
+class ErrorInjector {
+public:
+    ErrorInjector(double ber, uint64_t seed) : gen(seed), ber(ber) { next = skip(); }
+
+    void apply(uint64_t* words, size_t count) {
+        if (ber <= 0) return;
+        uint64_t total = uint64_t(count) * 64;
+        while (next < total) {
+            words[next / 64] ^= uint64_t(1) << (next % 64);
+            next += 1 + skip();
+        }
+        next -= total;
+    }
+
+private:
+    uint64_t skip() {
+        if (ber <= 0) return UINT64_MAX;
+        return static_cast<uint64_t>(std::floor(std::log(1.0 - uniform(gen)) / std::log(1.0 - ber)));
+    }
+
+    std::mt19937_64 gen;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+    double ber;
+    uint64_t next;
+};
+
+// Сдвиг потока на offset бит (0..63) - имитация произвольной фазы приема
+static void shift_stream(uint64_t* words, size_t count, int offset, uint64_t& carry) {
+    if (offset == 0) return;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t word = words[i];
+        words[i] = (carry >> offset) | (word << (64 - offset));
+        carry = word;
+    }
+}
+
+// Использование: prbs.out [order=31] [ber=1e-6] [seconds=5] [offset=13]
+int main(int argc, char** argv) {
+    int order = 31;
+    double ber = 1e-6;
+    double seconds = 5.0;
+    int offset = 13;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "order") order = atoi(value);
+        else if (key == "ber") ber = atof(value);
+        else if (key == "seconds") seconds = atof(value);
+        else if (key == "offset") offset = atoi(value) % 64;
+        else {
+            printf("Неизвестный параметр: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    PrbsType type = prbs_type_from_order(order);
+    std::vector<uint64_t> block(BLOCK_WORDS);
+
+    // Скорость генератора
+    PrbsGenerator bench(type);
+    size_t bench_blocks = 4096;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < bench_blocks; ++b) {
+        bench.fill(block.data(), block.size());
+        checksum ^= block[b % BLOCK_WORDS];
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("PRBS-%d: генерация %.1f Гбит/с (контроль %016llx)\n", order,
+           bench_blocks * BLOCK_WORDS * 64 / elapsed / 1e9, (unsigned long long)checksum);
+
+    // Прогон: генератор -> ошибки -> сдвиг фазы -> счетчик
+    PrbsGenerator generator(type);
+    ErrorInjector injector(ber, 1);
+    BerTester tester(type);
+    uint64_t carry = 0;
+
+    start = std::chrono::steady_clock::now();
+    double next_report = 1.0;
+    double processing = 0;
+    while (true) {
+        generator.fill(block.data(), block.size());
+        injector.apply(block.data(), block.size());
+        shift_stream(block.data(), block.size(), offset, carry);
+
+        auto t0 = std::chrono::steady_clock::now();
+        tester.process(block.data(), block.size());
+        processing += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= next_report || elapsed >= seconds) {
+            const BerStats& s = tester.stats();
+            double low, high;
+            ber_interval(s.errors, s.bits, 1.96, low, high);
+            printf("[%5.1f с] %s бит %.3e, ошибок %llu, BER %.3e, 95%%: [%.3e, %.3e]",
+                   elapsed, s.locked ? "синхр." : "поиск ", double(s.bits),
+                   (unsigned long long)s.errors, tester.ber(), low, high);
+            if (s.errors == 0) printf(", BER < %.3e", ber_upper_bound_no_errors(s.bits, 0.95));
+            printf("\n");
+            next_report += 1.0;
+        }
+        if (elapsed >= seconds) break;
+    }
+
+    const BerStats& s = tester.stats();
+    printf("Счетчик: %.1f Гбит/с, срывов синхронизации %llu, слов на поиск %llu\n",
+           s.bits / processing / 1e9, (unsigned long long)s.sync_losses,
+           (unsigned long long)s.search_words);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Псевдослучайные последовательности (ITU-T O.150) на РСЛОС x^n + x^m + 1:
+// b[k] = b[k - n] ^ b[k - m]. Биты упакованы по 64 в слово, первый бит - младший.
+//
+// Генерация сразу 64 бит: многочлен p(x)^(2^j) = x^(n*2^j) + x^(m*2^j) + 1 порождает
+// ту же последовательность, а при m*2^j >= 64 все отводы указывают в предыдущие слова.
+// Поэтому новое слово - это XOR двух сдвинутых окон истории из трех слов.
+// Заголовочный файл без зависимостей, чтобы им могли пользоваться и старые практики.
+
+enum class PrbsType { PRBS7, PRBS9, PRBS15, PRBS23, PRBS31 };
+
+struct PrbsTaps {
+    int n;       // степень многочлена
+    int m;       // второй отвод
+    int long_tap;   // n * 2^j, в битах назад
+    int short_tap;  // m * 2^j, в битах назад (>= 64)
+};
+
+constexpr int PRBS_HISTORY_WORDS = 3;
+constexpr int PRBS_HISTORY_BITS = PRBS_HISTORY_WORDS * 64;
+
+constexpr PrbsTaps prbs_taps(PrbsType type) {
+    switch (type) {
+        case PrbsType::PRBS7: return {7, 6, 7 * 16, 6 * 16};
+        case PrbsType::PRBS9: return {9, 5, 9 * 16, 5 * 16};
+        case PrbsType::PRBS15: return {15, 14, 15 * 8, 14 * 8};
+        case PrbsType::PRBS23: return {23, 18, 23 * 4, 18 * 4};
+        case PrbsType::PRBS31: return {31, 28, 31 * 4, 28 * 4};
+    }
+    return {7, 6, 7 * 16, 6 * 16};
+}
+
+inline PrbsType prbs_type_from_order(int order) {
+    switch (order) {
+        case 7: return PrbsType::PRBS7;
+        case 9: return PrbsType::PRBS9;
+        case 15: return PrbsType::PRBS15;
+        case 23: return PrbsType::PRBS23;
+        case 31: return PrbsType::PRBS31;
+    }
+    throw std::invalid_argument("Поддерживаются PRBS-7, 9, 15, 23, 31");
+}
+
+// 64 бита потока, начинающиеся за back бит до начала следующего слова.
+// history[0] - самое старое слово, history[2] - последнее; 64 <= back <= 192.
+inline uint64_t prbs_window(const uint64_t* history, int back) {
+    int offset = PRBS_HISTORY_BITS - back;
+    int word = offset / 64;
+    int shift = offset % 64;
+    if (shift == 0) return history[word];
+    return (history[word] >> shift) | (history[word + 1] << (64 - shift));
+}
+
+// Следующее слово последовательности по трем предыдущим
+inline uint64_t prbs_next_word(const uint64_t* history, const PrbsTaps& taps) {
+    return prbs_window(history, taps.long_tap) ^ prbs_window(history, taps.short_tap);
+}
+
+class PrbsGenerator {
+public:
+    // seed - начальное состояние регистра (младшие n бит, не ноль)
+    explicit PrbsGenerator(PrbsType type, uint32_t seed = 0xFFFFFFFFu) : taps(prbs_taps(type)) {
+        uint64_t mask = (uint64_t(1) << taps.n) - 1;
+        if ((seed & mask) == 0) throw std::invalid_argument("Нулевое состояние PRBS");
+
+        // Первые три слова - побитово, дальше работает только словная рекурсия
+        std::vector<uint8_t> bits(PRBS_HISTORY_BITS);
+        for (int k = 0; k < PRBS_HISTORY_BITS; ++k) {
+            bits[k] = k < taps.n ? (seed >> k) & 1 : bits[k - taps.n] ^ bits[k - taps.m];
+        }
+        for (int w = 0; w < PRBS_HISTORY_WORDS; ++w) {
+            history[w] = 0;
+            for (int b = 0; b < 64; ++b) history[w] |= uint64_t(bits[w * 64 + b]) << b;
+        }
+        pending = 0;
+    }
+
+    uint64_t next_word() {
+        // Сначала отдаем слова, посчитанные при инициализации
+        if (pending < PRBS_HISTORY_WORDS) return history[pending++];
+
+        uint64_t word = prbs_next_word(history, taps);
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = word;
+        return word;
+    }
+
+    void fill(uint64_t* words, size_t count) {
+        for (size_t i = 0; i < count; ++i) words[i] = next_word();
+    }
+
+    // Распакованные биты (0/1 по одному на байт) для мапперов;
+    // неиспользованный остаток последнего слова отбрасывается
+    void fill_bits(uint8_t* bits, size_t count) {
+        for (size_t i = 0; i < count; i += 64) {
+            uint64_t word = next_word();
+            size_t n = count - i < 64 ? count - i : 64;
+            for (size_t b = 0; b < n; ++b) bits[i + b] = (word >> b) & 1;
+        }
+    }
+
+    // Длина периода последовательности
+    uint64_t period() const { return (uint64_t(1) << taps.n) - 1; }
+
+private:
+    PrbsTaps taps;
+    uint64_t history[PRBS_HISTORY_WORDS];
+    int pending;
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+// Формирование импульсов с таблицей формы, посчитанной при компиляции.
+// Форма, число отсчетов на символ и длина в символах - параметры шаблона,
+// поэтому во время работы остается только умножение символа на таблицу.
+// Заголовочный файл целиком, подключается и из программ практик:
+// #include "../9_practice/src/pulse/pulse_shape.h"
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+enum class PulseType { Rect, Triangle, HalfSine, RaisedCosine, Gaussian };
+
+// constexpr-версии функций <cmath> (std::sin и std::exp в C++17 не constexpr)
+namespace pulse_math {
+
+constexpr double PI = 3.14159265358979323846;
+
+constexpr double sin(double x) {
+    // Приведение к [-pi, pi], затем ряд Тейлора
+    long long turns = static_cast<long long>(x / (2 * PI) + (x >= 0 ? 0.5 : -0.5));
+    x -= turns * 2 * PI;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cos(double x) {
+    return sin(x + PI / 2);
+}
+
+constexpr double exp(double x) {
+    // exp(x) = exp(x / 2^k)^(2^k), ряд для малого аргумента
+    int halvings = 0;
+    while (x > 0.5 || x < -0.5) {
+        x /= 2;
+        ++halvings;
+    }
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 20; ++n) {
+        term *= x / n;
+        sum += term;
+    }
+    for (int i = 0; i < halvings; ++i) sum *= sum;
+    return sum;
+}
+
+constexpr double abs(double x) {
+    return x < 0 ? -x : x;
+}
+
+constexpr double sinc(double x) {
+    return abs(x) < 1e-12 ? 1.0 : sin(PI * x) / (PI * x);
+}
+
+}  // namespace pulse_math
+
+// Значение формы в момент t (в символах). Для Rect/Triangle/HalfSine t in (0, 1),
+// для RaisedCosine/Gaussian t отсчитывается от центра импульса.
+// param: коэффициент скругления RC или произведение BT гауссова фильтра.
+constexpr double pulse_value(PulseType shape, double t, double param) {
+    switch (shape) {
+        case PulseType::Rect:
+            return 1.0;
+        case PulseType::Triangle:
+            return 1.0 - pulse_math::abs(2 * t - 1);
+        case PulseType::HalfSine:
+            return pulse_math::sin(pulse_math::PI * t);
+        case PulseType::RaisedCosine: {
+            double denominator = 1 - (2 * param * t) * (2 * param * t);
+            if (pulse_math::abs(denominator) < 1e-9) {
+                return pulse_math::PI / 4 * pulse_math::sinc(1 / (2 * param));
+            }
+            return pulse_math::sinc(t) * pulse_math::cos(pulse_math::PI * param * t) / denominator;
+        }
+        case PulseType::Gaussian:
+            // exp(-2 pi^2 BT^2 t^2 / ln 2), пик 1 в центре
+            return pulse_math::exp(-2 * pulse_math::PI * pulse_math::PI * param * param * t * t / 0.69314718055994531);
+    }
+    return 0.0;
+}
+
+// SPS - отсчетов на символ, SPAN - длина импульса в символах (только RC и Gaussian),
+// PARAM_PERCENT - коэффициент скругления или BT в процентах (вещественные параметры
+// шаблона в C++17 запрещены).
+template <PulseType Shape, size_t SPS, size_t SPAN = 1, int PARAM_PERCENT = 35>
+class PulseShaper {
+    static_assert(SPS > 0, "Нужен хотя бы один отсчет на символ");
+    static_assert(SPAN > 0, "Импульс не короче символа");
+    static_assert(SPAN == 1 || Shape == PulseType::RaisedCosine || Shape == PulseType::Gaussian,
+                  "Прямоугольник, треугольник и полусинус занимают один символ");
+
+public:
+    static constexpr size_t samples_per_symbol = SPS;
+    static constexpr size_t length = SPS * SPAN;
+
+    static constexpr std::array<float, length> make_taps() {
+        std::array<float, length> taps{};
+        for (size_t k = 0; k < length; ++k) {
+            double t = SPAN == 1 && Shape != PulseType::RaisedCosine && Shape != PulseType::Gaussian
+                           ? (k + 0.5) / SPS
+                           : (static_cast<double>(k) - static_cast<double>(length / 2)) / SPS;
+            taps[k] = static_cast<float>(pulse_value(Shape, t, PARAM_PERCENT / 100.0));
+        }
+        return taps;
+    }
+
+    static constexpr std::array<float, length> taps = make_taps();
+
+    // Отсчетов на выходе для count символов с учетом хвоста импульса
+    static constexpr size_t output_length(size_t count) {
+        return count ? (count + SPAN - 1) * SPS : 0;
+    }
+
+    // Символы -> отсчеты. Пишется ровно out_samples отсчетов: лишнее отбрасывается,
+    // недостающее заполняется нулями. Возвращает число отсчетов с сигналом.
+    static size_t shape(const std::complex<float>* symbols, size_t count, std::complex<float>* out,
+                        size_t out_samples) {
+        return run(count, out_samples,
+                   [&](size_t n) { return symbols[n]; },
+                   [&](size_t m, std::complex<float> value) { out[m] = value; });
+    }
+
+    // То же в CS16: value * scale с насыщением
+    static size_t shape_cs16(const std::complex<float>* symbols, size_t count, float scale, int16_t* iq,
+                             size_t out_samples) {
+        return run(count, out_samples,
+                   [&](size_t n) { return symbols[n] * scale; },
+                   [&](size_t m, std::complex<float> value) {
+                       iq[2 * m] = saturate(value.real());
+                       iq[2 * m + 1] = saturate(value.imag());
+                   });
+    }
+
+    // Амплитудная манипуляция как в 3-4 практиках: бит 1 -> (i_level, q_level), бит 0 -> 0.
+    // Бит умножается на уровень, ветвлений по значению бита нет.
+    static size_t shape_bits_cs16(const uint8_t* bits, size_t count, int16_t i_level, int16_t q_level, int16_t* iq,
+                                  size_t out_samples) {
+        std::complex<float> level(i_level, q_level);
+        return run(count, out_samples,
+                   [&](size_t n) { return level * static_cast<float>(bits[n] & 1); },
+                   [&](size_t m, std::complex<float> value) {
+                       iq[2 * m] = saturate(value.real());
+                       iq[2 * m + 1] = saturate(value.imag());
+                   });
+    }
+
+private:
+    static int16_t saturate(float value) {
+        if (value > 32767.0f) return 32767;
+        if (value < -32768.0f) return -32768;
+        return static_cast<int16_t>(value);
+    }
+
+    // Многофазная форма свертки: отсчет n * SPS + k = sum_j symbol[n - j] * taps[k + j * SPS].
+    // Границы по j считаются один раз на символ, внутренний цикл по k без условий.
+    template <typename Get, typename Put>
+    static size_t run(size_t count, size_t out_samples, Get get, Put put) {
+        size_t total = output_length(count);
+        size_t written = total < out_samples ? total : out_samples;
+
+        for (size_t n = 0; n * SPS < written; ++n) {
+            size_t j_first = n >= count ? n - count + 1 : 0;
+            size_t j_last = n < SPAN - 1 ? n : SPAN - 1;
+
+            std::complex<float> acc[SPS];
+            for (size_t k = 0; k < SPS; ++k) acc[k] = 0.0f;
+            for (size_t j = j_first; j <= j_last; ++j) {
+                std::complex<float> symbol = get(n - j);
+                const float* phase = &taps[j * SPS];
+                for (size_t k = 0; k < SPS; ++k) acc[k] += symbol * phase[k];
+            }
+
+            size_t end = written - n * SPS < SPS ? written - n * SPS : SPS;
+            for (size_t k = 0; k < end; ++k) put(n * SPS + k, acc[k]);
+        }
+
+        for (size_t m = written; m < out_samples; ++m) put(m, std::complex<float>());
+        return written;
+    }
+};
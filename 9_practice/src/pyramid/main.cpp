@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pyramid/pyramid.h"
+
+// Использование:
+//   pyramid.out build <capture.pcm> [threads]
+//   pyramid.out query <capture.pcm> <first> <last> <pixels>
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Использование:\n");
+        printf("  %s build <capture.pcm> [threads]\n", argv[0]);
+        printf("  %s query <capture.pcm> <first> <last> <pixels>\n", argv[0]);
+        return -1;
+    }
+
+    std::string mode = argv[1];
+    std::string capture_path = argv[2];
+    std::string index_path = capture_path + ".pyr";
+
+    CaptureFile capture;
+    if (!capture.open(capture_path)) return -1;
+
+    if (mode == "build") {
+        size_t threads = argc > 3 ? strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+
+        auto start = std::chrono::steady_clock::now();
+        if (!build_pyramid(capture, index_path, threads)) {
+            printf("Ошибка построения индекса\n");
+            return -1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("Индекс %s: %zu отсчетов за %.3f с (%.1f Мотсч/с)\n", index_path.c_str(),
+               capture.samples_count(), seconds, capture.samples_count() / seconds / 1e6);
+        return 0;
+    }
+
+    if (mode == "query" && argc > 5) {
+        PyramidIndex index;
+        if (!index.open(index_path)) return -1;
+
+        uint64_t first = strtoull(argv[3], nullptr, 10);
+        uint64_t last = strtoull(argv[4], nullptr, 10);
+        size_t pixels = strtoul(argv[5], nullptr, 10);
+
+        std::vector<PyramidEntry> columns;
+        index.query(first, last, pixels, columns, &capture);
+
+        for (size_t p = 0; p < columns.size(); ++p) {
+            const PyramidEntry& c = columns[p];
+            printf("%zu: I [%d, %d], Q [%d, %d], RMS %.1f\n", p, c.min_i, c.max_i, c.min_q, c.max_q,
+                   std::sqrt(c.mean_power));
+        }
+        return 0;
+    }
+
+    printf("Неизвестный режим: %s\n", mode.c_str());
+    return -1;
+}
@@ -0,0 +1,233 @@
+#include "pyramid/pyramid.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// Заголовок файла индекса
+struct PyramidHeader {
+    char magic[4];
+    uint32_t base_shift;
+    uint32_t levels_count;
+    uint32_t reserved;
+    uint64_t samples_count;
+};
+
+PyramidEntry summarize_samples(const int16_t* iq, size_t samples_count) {
+    int16_t min_i = INT16_MAX, max_i = INT16_MIN;
+    int16_t min_q = INT16_MAX, max_q = INT16_MIN;
+    float power = 0;
+
+    for (size_t i = 0; i < samples_count; ++i) {
+        int16_t re = iq[2 * i];
+        int16_t im = iq[2 * i + 1];
+        min_i = std::min(min_i, re);
+        max_i = std::max(max_i, re);
+        min_q = std::min(min_q, im);
+        max_q = std::max(max_q, im);
+        power += float(re) * re + float(im) * im;
+    }
+
+    PyramidEntry entry = {min_i, max_i, min_q, max_q, samples_count ? power / samples_count : 0.0f};
+    return entry;
+}
+
+PyramidEntry merge_entries(const PyramidEntry& a, const PyramidEntry& b) {
+    PyramidEntry entry = {
+        std::min(a.min_i, b.min_i), std::max(a.max_i, b.max_i),
+        std::min(a.min_q, b.min_q), std::max(a.max_q, b.max_q),
+        0.5f * (a.mean_power + b.mean_power),
+    };
+    return entry;
+}
+
+bool build_pyramid(const CaptureFile& capture, const std::string& index_path, size_t threads_count) {
+    const size_t bucket = size_t(1) << PYRAMID_BASE_SHIFT;
+    const size_t samples = capture.samples_count();
+    const size_t base_entries = (samples + bucket - 1) / bucket;
+
+    if (base_entries == 0) return false;
+    if (threads_count == 0) threads_count = 1;
+
+    std::vector<std::vector<PyramidEntry>> levels(1);
+    levels[0].resize(base_entries);
+
+    // Нижний уровень: каждый поток сворачивает свой кусок записи
+    std::vector<std::thread> threads;
+    size_t per_thread = (base_entries + threads_count - 1) / threads_count;
+    for (size_t t = 0; t < threads_count; ++t) {
+        size_t first = t * per_thread;
+        size_t last = std::min(base_entries, first + per_thread);
+        if (first >= last) break;
+
+        threads.emplace_back([&, first, last] {
+            for (size_t e = first; e < last; ++e) {
+                size_t offset = e * bucket;
+                size_t count = std::min(bucket, samples - offset);
+                levels[0][e] = summarize_samples(capture.data() + 2 * offset, count);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    // Верхние уровни: попарное слияние, пока не останется одна запись
+    while (levels.back().size() > 1) {
+        const std::vector<PyramidEntry>& lower = levels.back();
+        std::vector<PyramidEntry> upper((lower.size() + 1) / 2);
+        for (size_t i = 0; i < upper.size(); ++i) {
+            upper[i] = 2 * i + 1 < lower.size() ? merge_entries(lower[2 * i], lower[2 * i + 1]) : lower[2 * i];
+        }
+        levels.push_back(std::move(upper));
+    }
+
+    FILE* file = fopen(index_path.c_str(), "wb");
+    if (!file) {
+        printf("Не удалось открыть файл: %s\n", index_path.c_str());
+        return false;
+    }
+
+    PyramidHeader header = {{'P', 'Y', 'R', '1'}, PYRAMID_BASE_SHIFT, uint32_t(levels.size()), 0, samples};
+    fwrite(&header, sizeof(header), 1, file);
+    for (const std::vector<PyramidEntry>& level : levels) {
+        uint64_t count = level.size();
+        fwrite(&count, sizeof(count), 1, file);
+    }
+    for (const std::vector<PyramidEntry>& level : levels) {
+        fwrite(level.data(), sizeof(PyramidEntry), level.size(), file);
+    }
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
+
+PyramidIndex::~PyramidIndex() {
+    close();
+}
+
+bool PyramidIndex::open(const std::string& index_path) {
+    close();
+
+    int fd = ::open(index_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        printf("Не удалось открыть файл: %s\n", index_path.c_str());
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(PyramidHeader)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return false;
+
+    mapping = address;
+    mapping_size = info.st_size;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(mapping);
+    PyramidHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, "PYR1", 4) != 0) {
+        printf("Неверный формат индекса: %s\n", index_path.c_str());
+        close();
+        return false;
+    }
+
+    // Сдвиг уровня base_shift + level должен помещаться в uint64_t, поэтому уровней не
+    // больше 64 - base_shift (столько дает запись из 2^64 отсчетов); таблица длин - в файле
+    if (header.base_shift >= 63 || header.levels_count == 0 || header.levels_count > 64 - header.base_shift ||
+        sizeof(header) + header.levels_count * sizeof(uint64_t) > mapping_size) {
+        printf("Индекс поврежден: %s\n", index_path.c_str());
+        close();
+        return false;
+    }
+
+    base_shift = header.base_shift;
+    total_samples = header.samples_count;
+
+    const uint64_t* counts = reinterpret_cast<const uint64_t*>(bytes + sizeof(header));
+    size_t offset = sizeof(header) + header.levels_count * sizeof(uint64_t);
+    for (size_t level = 0; level < header.levels_count; ++level) {
+        // Деление вместо умножения: длина из файла не должна переполнить проверку
+        if (counts[level] > (mapping_size - offset) / sizeof(PyramidEntry)) {
+            printf("Индекс поврежден: %s\n", index_path.c_str());
+            close();
+            return false;
+        }
+        level_entries.push_back(counts[level]);
+        level_data.push_back(reinterpret_cast<const PyramidEntry*>(bytes + offset));
+        offset += counts[level] * sizeof(PyramidEntry);
+    }
+    return true;
+}
+
+void PyramidIndex::close() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+        mapping_size = 0;
+    }
+    level_data.clear();
+    level_entries.clear();
+    total_samples = 0;
+}
+
+void PyramidIndex::query(uint64_t first, uint64_t last, size_t pixels,
+                         std::vector<PyramidEntry>& out, const CaptureFile* capture) const {
+    out.clear();
+    last = std::min(last, total_samples);
+    if (first >= last || pixels == 0 || level_data.empty()) return;
+
+    uint64_t span = last - first;
+    pixels = std::min<uint64_t>(pixels, span);
+    uint64_t per_pixel = span / pixels;
+    out.resize(pixels);
+
+    // Мельче нижнего уровня: считаем прямо по отсчетам, это не больше 2^base_shift на столбец
+    if (per_pixel < (uint64_t(1) << base_shift) && capture && capture->samples_count() >= last) {
+        for (size_t p = 0; p < pixels; ++p) {
+            uint64_t begin = first + span * p / pixels;
+            uint64_t end = first + span * (p + 1) / pixels;
+            out[p] = summarize_samples(capture->data() + 2 * begin, end - begin);
+        }
+        return;
+    }
+
+    // Самый крупный уровень, у которого на столбец приходится хотя бы одна запись
+    size_t level = 0;
+    while (level + 1 < level_data.size() && (uint64_t(1) << (base_shift + level + 1)) <= per_pixel) {
+        ++level;
+    }
+
+    size_t shift = base_shift + level;
+    const PyramidEntry* entries = level_data[level];
+    uint64_t count = level_entries[level];
+
+    for (size_t p = 0; p < pixels; ++p) {
+        uint64_t begin = (first + span * p / pixels) >> shift;
+        uint64_t end = std::max(begin + 1, (first + span * (p + 1) / pixels) >> shift);
+        end = std::min(end, count);
+        begin = std::min(begin, count - 1);
+
+        PyramidEntry column = entries[begin];
+        double power = column.mean_power;
+        for (uint64_t e = begin + 1; e < end; ++e) {
+            const PyramidEntry& entry = entries[e];
+            column.min_i = std::min(column.min_i, entry.min_i);
+            column.max_i = std::max(column.max_i, entry.max_i);
+            column.min_q = std::min(column.min_q, entry.min_q);
+            column.max_q = std::max(column.max_q, entry.max_q);
+            power += entry.mean_power;
+        }
+        column.mean_power = static_cast<float>(power / (end - begin > 0 ? end - begin : 1));
+        out[p] = column;
+    }
+}
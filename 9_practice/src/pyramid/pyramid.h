@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "capture/capture_file.h"
+
+// Сводка по группе отсчетов: размах I/Q и средняя мощность (для RMS)
+struct PyramidEntry {
+    int16_t min_i;
+    int16_t max_i;
+    int16_t min_q;
+    int16_t max_q;
+    float mean_power;
+};
+
+// Уровень k пирамиды хранит по одной записи на 2^(base_shift + k) отсчетов.
+// Файл индекса кладется рядом с записью (<capture>.pyr).
+constexpr size_t PYRAMID_BASE_SHIFT = 4;
+
+// Строит индекс за один проход по отображенной записи.
+// Нижний уровень считается параллельно по threads_count потокам.
+bool build_pyramid(const CaptureFile& capture, const std::string& index_path, size_t threads_count);
+
+// Индекс, открытый для просмотра: запросы стоят O(пикселей), а не O(отсчетов)
+class PyramidIndex {
+public:
+    PyramidIndex() = default;
+    ~PyramidIndex();
+
+    PyramidIndex(const PyramidIndex&) = delete;
+    PyramidIndex& operator=(const PyramidIndex&) = delete;
+
+    bool open(const std::string& index_path);
+    void close();
+
+    size_t levels_count() const { return level_entries.size(); }
+    uint64_t samples_count() const { return total_samples; }
+
+    // Диапазон [first, last) в pixels столбцов. Если запрошенное разрешение
+    // мельче нижнего уровня, а capture передан, столбцы считаются по отсчетам.
+    void query(uint64_t first, uint64_t last, size_t pixels,
+               std::vector<PyramidEntry>& out, const CaptureFile* capture = nullptr) const;
+
+private:
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    size_t base_shift = PYRAMID_BASE_SHIFT;
+    uint64_t total_samples = 0;
+    std::vector<const PyramidEntry*> level_data;
+    std::vector<uint64_t> level_entries;
+};
+
+// Сводка по отсчетам CS16 (используется и при построении, и для мелкого масштаба)
+PyramidEntry summarize_samples(const int16_t* iq, size_t samples_count);
+
+// Объединение двух сводок одинакового веса
+PyramidEntry merge_entries(const PyramidEntry& a, const PyramidEntry& b);
@@ -0,0 +1,448 @@
+// Модуль Python sdr_dsp: DSP-блоки 9 практики для скриптов анализа.
+// Массивы принимаются через buffer protocol (numpy, array, memoryview) без копирования:
+// C++ работает прямо с памятью массива, GIL на время обработки отпускается.
+// Комплексные массивы - numpy.complex64 либо float32 с чередованием I/Q.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "capture/capture_file.h"
+#include "filter/fir.h"
+#include "modulation/fm_demod.h"
+#include "modulation/mapper.h"
+#include "nco/nco.h"
+#include "spectrum/spectrum.h"
+
+// Обертка над Py_buffer, освобождает буфер при выходе из области видимости
+class BufferView {
+public:
+    ~BufferView() {
+        if (acquired) PyBuffer_Release(&view);
+    }
+
+    // kind: 'c' - complex64, 'f' - float32, 'h' - int16, 'B' - uint8
+    bool acquire(PyObject* object, char kind, bool writable, const char* name) {
+        int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+        if (PyObject_GetBuffer(object, &view, flags) != 0) return false;
+        acquired = true;
+
+        // Порядок байт в формате ('<', '=', '@') не важен: работаем в родном
+        const char* format = view.format ? view.format : "B";
+        if (*format == '<' || *format == '=' || *format == '@') ++format;
+
+        bool matches = false;
+        switch (kind) {
+        case 'c':
+            matches = (strcmp(format, "Zf") == 0 && view.itemsize == 8) ||
+                      (strcmp(format, "f") == 0 && view.itemsize == 4 && (view.len / 4) % 2 == 0);
+            break;
+        case 'f': matches = strcmp(format, "f") == 0 && view.itemsize == 4; break;
+        case 'h': matches = strcmp(format, "h") == 0 && view.itemsize == 2; break;
+        case 'B': matches = (strcmp(format, "B") == 0 || strcmp(format, "?") == 0) && view.itemsize == 1; break;
+        }
+
+        if (!matches) {
+            PyErr_Format(PyExc_TypeError, "%s: неподходящий тип элементов '%s'", name, view.format);
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(view.buf); }
+
+    size_t bytes() const { return static_cast<size_t>(view.len); }
+    size_t complex_count() const { return bytes() / sizeof(cf32); }
+
+private:
+    Py_buffer view = {};
+    bool acquired = false;
+};
+
+static bool check_length(size_t have, size_t need, const char* name) {
+    if (have < need) {
+        PyErr_Format(PyExc_ValueError, "%s: нужно не меньше %zu элементов, передано %zu", name, need, have);
+        return false;
+    }
+    return true;
+}
+
+// ---------- Nco ----------
+
+// GIL на время mix отпускается, поэтому состояние гетеродина защищено своим мьютексом:
+// два потока Python с одним объектом работают по очереди. Мьютекс никогда не держится
+// в ожидании GIL, так что захват его под GIL не приводит к взаимной блокировке.
+struct NcoObject {
+    PyObject_HEAD
+    Nco* nco;
+    std::mutex* lock;
+};
+
+// Объект, созданный через Nco.__new__ без __init__, гетеродина не имеет
+static bool nco_ready(NcoObject* self) {
+    if (self->nco) return true;
+    PyErr_SetString(PyExc_RuntimeError, "Nco не инициализирован: создайте его как Nco(sample_rate, frequency)");
+    return false;
+}
+
+static int nco_init(NcoObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"sample_rate", "frequency", nullptr};
+    double sample_rate = 0;
+    double frequency = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "d|d", const_cast<char**>(keywords), &sample_rate, &frequency)) {
+        return -1;
+    }
+    if (!self->lock) self->lock = new std::mutex();
+
+    Nco* fresh = new Nco(sample_rate, frequency);
+    Nco* old;
+    {
+        std::lock_guard<std::mutex> guard(*self->lock);
+        old = self->nco;
+        self->nco = fresh;
+    }
+    delete old;
+    return 0;
+}
+
+static void nco_dealloc(NcoObject* self) {
+    delete self->nco;
+    delete self->lock;
+    // Тип создан PyType_FromSpec (в куче): каждый объект держит на него ссылку
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(type);
+}
+
+static PyObject* nco_mix(NcoObject* self, PyObject* args) {
+    PyObject* in_object;
+    PyObject* out_object;
+    if (!PyArg_ParseTuple(args, "OO", &in_object, &out_object)) return nullptr;
+    if (!nco_ready(self)) return nullptr;
+
+    BufferView in, out;
+    if (!in.acquire(in_object, 'c', false, "in") || !out.acquire(out_object, 'c', true, "out")) return nullptr;
+    if (!check_length(out.complex_count(), in.complex_count(), "out")) return nullptr;
+
+    size_t count = in.complex_count();
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::lock_guard<std::mutex> guard(*self->lock);
+        self->nco->mix(in.as<cf32>(), out.as<cf32>(), count);
+    }
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject* nco_set_frequency(NcoObject* self, PyObject* args) {
+    double frequency;
+    if (!PyArg_ParseTuple(args, "d", &frequency)) return nullptr;
+    if (!nco_ready(self)) return nullptr;
+
+    std::lock_guard<std::mutex> guard(*self->lock);
+    self->nco->set_frequency(frequency);
+    Py_RETURN_NONE;
+}
+
+static PyObject* nco_get_phase(NcoObject* self, void*) {
+    if (!nco_ready(self)) return nullptr;
+
+    std::lock_guard<std::mutex> guard(*self->lock);
+    return PyFloat_FromDouble(self->nco->phase());
+}
+
+static PyMethodDef nco_methods[] = {
+    {"mix", reinterpret_cast<PyCFunction>(nco_mix), METH_VARARGS, "mix(in, out): перенос частоты"},
+    {"set_frequency", reinterpret_cast<PyCFunction>(nco_set_frequency), METH_VARARGS,
+     "set_frequency(hz): смена частоты без разрыва фазы"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static PyGetSetDef nco_getset[] = {
+    {"phase", reinterpret_cast<getter>(nco_get_phase), nullptr, "текущая фаза, рад", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+static PyType_Slot nco_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Nco(sample_rate, frequency=0): цифровой гетеродин")},
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(nco_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(nco_dealloc)},
+    {Py_tp_methods, nco_methods},
+    {Py_tp_getset, nco_getset},
+    {0, nullptr},
+};
+
+static PyType_Spec nco_spec = {"sdr_dsp.Nco", sizeof(NcoObject), 0, Py_TPFLAGS_DEFAULT, nco_slots};
+
+// ---------- Capture ----------
+
+struct CaptureObject {
+    PyObject_HEAD
+    CaptureFile* capture;
+    Py_ssize_t shape;   // Длина int16 массива для buffer protocol
+    Py_ssize_t exports; // Выданные и еще не освобожденные буферы (memoryview, numpy)
+};
+
+static int capture_init(CaptureObject* self, PyObject* args, PyObject*) {
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path)) return -1;
+
+    // Выданные буферы указывают в отображение и на shape: закрывать запись под ними нельзя
+    if (self->exports > 0) {
+        PyErr_SetString(PyExc_BufferError, "запись используется открытыми буферами");
+        return -1;
+    }
+    delete self->capture;
+    self->capture = new CaptureFile();
+    if (!self->capture->open(path)) {
+        PyErr_Format(PyExc_OSError, "не удалось открыть запись %s", path);
+        return -1;
+    }
+    self->shape = static_cast<Py_ssize_t>(self->capture->samples_count() * 2);
+    return 0;
+}
+
+static void capture_dealloc(CaptureObject* self) {
+    delete self->capture;
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(type);
+}
+
+// Отдаем отображенную запись как int16 массив [I, Q, I, Q, ...] только для чтения
+static int capture_getbuffer(CaptureObject* self, Py_buffer* view, int flags) {
+    if (!self->capture || !self->capture->is_open()) {
+        PyErr_SetString(PyExc_ValueError, "запись не открыта");
+        return -1;
+    }
+    void* data = const_cast<int16_t*>(self->capture->data());
+    Py_ssize_t length = static_cast<Py_ssize_t>(self->capture->samples_count() * 2 * sizeof(int16_t));
+    if (PyBuffer_FillInfo(view, reinterpret_cast<PyObject*>(self), data, length, 1, flags) != 0) return -1;
+
+    view->itemsize = sizeof(int16_t);
+    if (flags & PyBUF_FORMAT) view->format = const_cast<char*>("h");
+    if (flags & PyBUF_ND) view->shape = &self->shape;
+    ++self->exports;
+    return 0;
+}
+
+static void capture_releasebuffer(CaptureObject* self, Py_buffer*) {
+    --self->exports;
+}
+
+
+static PyObject* capture_samples_count(CaptureObject* self, void*) {
+    return PyLong_FromSize_t(self->capture ? self->capture->samples_count() : 0);
+}
+
+static PyGetSetDef capture_getset[] = {
+    {"samples_count", reinterpret_cast<getter>(capture_samples_count), nullptr, "число отсчетов I/Q", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+static PyType_Slot capture_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Capture(path): запись CS16 через mmap, numpy.frombuffer(capture, numpy.int16)")},
+    {Py_tp_new, reinterpret_cast<void*>(PyType_GenericNew)},
+    {Py_tp_init, reinterpret_cast<void*>(capture_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(capture_dealloc)},
+    {Py_tp_getset, capture_getset},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(capture_getbuffer)},
+    {Py_bf_releasebuffer, reinterpret_cast<void*>(capture_releasebuffer)},
+    {0, nullptr},
+};
+
+static PyType_Spec capture_spec = {"sdr_dsp.Capture", sizeof(CaptureObject), 0, Py_TPFLAGS_DEFAULT, capture_slots};
+
+// ---------- Функции ----------
+
+static PyObject* py_cs16_to_cf32(PyObject*, PyObject* args) {
+    PyObject* in_object;
+    PyObject* out_object;
+    if (!PyArg_ParseTuple(args, "OO", &in_object, &out_object)) return nullptr;
+
+    BufferView in, out;
+    if (!in.acquire(in_object, 'h', false, "in") || !out.acquire(out_object, 'c', true, "out")) return nullptr;
+
+    size_t count = in.bytes() / (2 * sizeof(int16_t));
+    if (!check_length(out.complex_count(), count, "out")) return nullptr;
+
+    Py_BEGIN_ALLOW_THREADS
+    cs16_to_cf32(in.as<int16_t>(), out.as<cf32>(), count);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject* py_fir_filter(PyObject*, PyObject* args) {
+    PyObject* in_object;
+    PyObject* taps_object;
+    PyObject* out_object;
+    if (!PyArg_ParseTuple(args, "OOO", &in_object, &taps_object, &out_object)) return nullptr;
+
+    BufferView in, taps, out;
+    if (!in.acquire(in_object, 'c', false, "in") || !taps.acquire(taps_object, 'f', false, "taps") ||
+        !out.acquire(out_object, 'c', true, "out")) {
+        return nullptr;
+    }
+    if (!check_length(out.complex_count(), in.complex_count(), "out")) return nullptr;
+    if (taps.bytes() < sizeof(float)) {
+        PyErr_SetString(PyExc_ValueError, "taps: нужен хотя бы один коэффициент");
+        return nullptr;
+    }
+
+    size_t count = in.complex_count();
+    std::vector<float> coefficients(taps.as<float>(), taps.as<float>() + taps.bytes() / sizeof(float));
+    Py_BEGIN_ALLOW_THREADS
+    FirFilter filter(coefficients);
+    filter.process(in.as<cf32>(), out.as<cf32>(), count);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+// Общая обвязка для отображения бит в символы и обратно
+static PyObject* map_bits(PyObject* args, size_t bits_per_symbol,
+                          void (*mapper)(const uint8_t*, size_t, cf32*)) {
+    PyObject* bits_object;
+    PyObject* out_object;
+    if (!PyArg_ParseTuple(args, "OO", &bits_object, &out_object)) return nullptr;
+
+    BufferView bits, out;
+    if (!bits.acquire(bits_object, 'B', false, "bits") || !out.acquire(out_object, 'c', true, "out")) return nullptr;
+
+    size_t bits_count = bits.bytes();
+    if (!check_length(out.complex_count(), bits_count / bits_per_symbol, "out")) return nullptr;
+
+    Py_BEGIN_ALLOW_THREADS
+    mapper(bits.as<uint8_t>(), bits_count, out.as<cf32>());
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject* demap_symbols(PyObject* args, size_t bits_per_symbol,
+                               void (*demapper)(const cf32*, size_t, uint8_t*)) {
+    PyObject* in_object;
+    PyObject* bits_object;
+    if (!PyArg_ParseTuple(args, "OO", &in_object, &bits_object)) return nullptr;
+
+    BufferView in, bits;
+    if (!in.acquire(in_object, 'c', false, "in") || !bits.acquire(bits_object, 'B', true, "bits")) return nullptr;
+
+    size_t count = in.complex_count();
+    if (!check_length(bits.bytes(), count * bits_per_symbol, "bits")) return nullptr;
+
+    Py_BEGIN_ALLOW_THREADS
+    demapper(in.as<cf32>(), count, bits.as<uint8_t>());
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject* py_bpsk_modulate(PyObject*, PyObject* args) { return map_bits(args, 1, bpsk_map); }
+static PyObject* py_qpsk_modulate(PyObject*, PyObject* args) { return map_bits(args, 2, qpsk_map); }
+static PyObject* py_bpsk_demodulate(PyObject*, PyObject* args) { return demap_symbols(args, 1, bpsk_demap); }
+static PyObject* py_qpsk_demodulate(PyObject*, PyObject* args) { return demap_symbols(args, 2, qpsk_demap); }
+
+static PyObject* py_fm_demodulate(PyObject*, PyObject* args) {
+    PyObject* in_object;
+    PyObject* out_object;
+    if (!PyArg_ParseTuple(args, "OO", &in_object, &out_object)) return nullptr;
+
+    BufferView in, out;
+    if (!in.acquire(in_object, 'c', false, "in") || !out.acquire(out_object, 'f', true, "out")) return nullptr;
+
+    size_t count = in.complex_count();
+    if (!check_length(out.bytes() / sizeof(float), count, "out")) return nullptr;
+
+    Py_BEGIN_ALLOW_THREADS
+    FmDemodulator demodulator;
+    demodulator.process(in.as<cf32>(), out.as<float>(), count);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+// welch_psd(in, out): усредненный спектр всего массива, out - float32 длины fft_size (дБ)
+static PyObject* py_welch_psd(PyObject*, PyObject* args) {
+    PyObject* in_object;
+    PyObject* out_object;
+    double overlap = 0.5;
+    if (!PyArg_ParseTuple(args, "OO|d", &in_object, &out_object, &overlap)) return nullptr;
+
+    BufferView in, out;
+    if (!in.acquire(in_object, 'c', false, "in") || !out.acquire(out_object, 'f', true, "out")) return nullptr;
+
+    // Движок ограничивает перекрытие тем же диапазоном; за его пределами число
+    // усреднений не совпало бы с числом окон и строка не была бы выдана
+    if (!(overlap >= 0.0 && overlap <= 0.95)) {
+        PyErr_SetString(PyExc_ValueError, "overlap: допустимо от 0 до 0.95");
+        return nullptr;
+    }
+
+    SpectrumConfig config;
+    config.fft_size = out.bytes() / sizeof(float);
+    config.overlap = overlap;
+    if (!is_power_of_two(config.fft_size)) {
+        PyErr_SetString(PyExc_ValueError, "out: длина должна быть степенью двойки");
+        return nullptr;
+    }
+
+    size_t count = in.complex_count();
+    if (!check_length(count, config.fft_size, "in")) return nullptr;
+
+    bool produced = false;
+    Py_BEGIN_ALLOW_THREADS
+    config.averages = (count - config.fft_size) / SpectrumEngine::hop_for(config) + 1;
+    float* result = out.as<float>();
+    SpectrumEngine engine(config, [&](const std::vector<float>& power_db, uint64_t) {
+        std::copy(power_db.begin(), power_db.end(), result);
+        produced = true;
+    });
+    engine.process(in.as<cf32>(), count);
+    Py_END_ALLOW_THREADS
+
+    if (!produced) {
+        PyErr_SetString(PyExc_RuntimeError, "welch_psd: не получено ни одной строки PSD");
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef module_methods[] = {
+    {"cs16_to_cf32", py_cs16_to_cf32, METH_VARARGS, "cs16_to_cf32(iq_int16, out_complex64)"},
+    {"fir_filter", py_fir_filter, METH_VARARGS, "fir_filter(in, taps_float32, out)"},
+    {"bpsk_modulate", py_bpsk_modulate, METH_VARARGS, "bpsk_modulate(bits_uint8, out)"},
+    {"qpsk_modulate", py_qpsk_modulate, METH_VARARGS, "qpsk_modulate(bits_uint8, out)"},
+    {"bpsk_demodulate", py_bpsk_demodulate, METH_VARARGS, "bpsk_demodulate(in, bits_uint8)"},
+    {"qpsk_demodulate", py_qpsk_demodulate, METH_VARARGS, "qpsk_demodulate(in, bits_uint8)"},
+    {"fm_demodulate", py_fm_demodulate, METH_VARARGS, "fm_demodulate(in, out_float32)"},
+    {"welch_psd", py_welch_psd, METH_VARARGS, "welch_psd(in, out_float32[, overlap])"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static PyModuleDef sdr_dsp_module = {
+    PyModuleDef_HEAD_INIT, "sdr_dsp", "DSP-блоки SDR без копирования массивов", -1, module_methods,
+    nullptr, nullptr, nullptr, nullptr,
+};
+
+PyMODINIT_FUNC PyInit_sdr_dsp() {
+    PyObject* module = PyModule_Create(&sdr_dsp_module);
+    if (!module) return nullptr;
+
+    // Типы из спецификаций: все поля PyTypeObject, кроме перечисленных слотов, нулевые
+    // PyModule_AddObject забирает ссылку только при успехе
+    PyObject* nco_type = PyType_FromSpec(&nco_spec);
+    if (!nco_type || PyModule_AddObject(module, "Nco", nco_type) < 0) {
+        Py_XDECREF(nco_type);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    PyObject* capture_type = PyType_FromSpec(&capture_spec);
+    if (!capture_type || PyModule_AddObject(module, "Capture", capture_type) < 0) {
+        Py_XDECREF(capture_type);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "export/npy.h"
+#include "scan/scan.h"
+
+// Использование:
+//   scan.out backend=soapy|iio uri=... [sample_rate=20e6] [rx_gain=30] [start=70e6] [stop=6e9]
+//            [fft=1024] [averages=16] [usable=0.75] [channel=200e3] [threshold=10] [sweeps=1]
+//            [depth=4] [threads=0] [flush=0] [settle_block=256] [settle_tol=1] [max_settle_us=20000]
+//            [db=occupancy.occ] [npz=scan.npz] [report=20]
+//   scan.out db=occupancy.occ report=20 start=... stop=... channel=... - только отчет по базе
+// Усиление фиксированное, чтобы уровни разных шагов и проходов были сравнимы.
+// Backend file не перестраивается и для обзора не подходит.
+int main(int argc, char** argv) {
+    DeviceConfig device_config;
+    device_config.sample_rate = 20e6;
+    device_config.rx_gain = 30;
+    ScanConfig config;
+    double channel_width = 200e3;
+    double threshold_db = 10;
+    size_t sweeps = 1;
+    size_t threads = 0;
+    size_t report = 20;
+    bool report_only = true;
+    std::string db_path = "occupancy.occ";
+    std::string npz;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (key == "start") config.start_frequency = atof(value);
+        else if (key == "stop") config.stop_frequency = atof(value);
+        else if (key == "fft") config.spectrum.fft_size = strtoul(value, nullptr, 10);
+        else if (key == "averages") config.spectrum.averages = strtoul(value, nullptr, 10);
+        else if (key == "usable") config.usable_band = atof(value);
+        else if (key == "depth") config.pipeline_depth = strtoul(value, nullptr, 10);
+        else if (key == "flush") config.flush_samples = strtoul(value, nullptr, 10);
+        else if (key == "settle_block") config.settle_block = strtoul(value, nullptr, 10);
+        else if (key == "settle_tol") config.settle_tolerance_db = atof(value);
+        else if (key == "max_settle_us") config.max_settle_us = atof(value);
+        else if (key == "channel") channel_width = atof(value);
+        else if (key == "threshold") threshold_db = atof(value);
+        else if (key == "sweeps") sweeps = strtoul(value, nullptr, 10);
+        else if (key == "threads") threads = strtoul(value, nullptr, 10);
+        else if (key == "report") report = strtoul(value, nullptr, 10);
+        else if (key == "db") db_path = value;
+        else if (key == "npz") npz = value;
+        else if (!parse_device_arg(arg, device_config)) {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+        if (key == "backend" || key == "uri") report_only = false;
+    }
+
+    if (!is_power_of_two(config.spectrum.fft_size) || config.spectrum.fft_size < 16 ||
+        config.stop_frequency <= config.start_frequency || config.usable_band <= 0 || config.usable_band > 1 ||
+        channel_width <= 0 || config.spectrum.averages == 0) {
+        printf("fft - степень двойки от 16, stop > start, 0 < usable <= 1, channel > 0\n");
+        return -1;
+    }
+
+    OccupancyDb db(config.start_frequency, config.stop_frequency, channel_width);
+    if (!db_path.empty() && !db.load(db_path)) return -1;
+
+    if (report_only) {
+        print_occupancy(db, report);
+        return 0;
+    }
+
+    if (device_config.backend == "file") {
+        printf("Обзор требует перестройки гетеродина: backend=soapy или iio\n");
+        return -1;
+    }
+
+    std::unique_ptr<Device> device = make_device(device_config);
+    if (!device) return -1;
+    std::unique_ptr<RxStream> rx = device->open_rx();
+    if (!rx) {
+        printf("Не удалось открыть поток приема\n");
+        return -1;
+    }
+
+    WorkPool pool(threads);
+    FrequencyScanner scanner(*device, *rx, config, pool);
+    printf("План: %zu шагов по %.2f МГц (%zu бинов по %.1f кГц), %s, потоков БПФ: %zu\n", scanner.plan().size(),
+           scanner.step_bins() * scanner.bin_width() / 1e6, scanner.step_bins(), scanner.bin_width() / 1e3,
+           rx->direct_buffers() ? "буферы драйвера без копирования" : "чтение с копированием",
+           pool.threads_count());
+
+    ScanResult result;
+    std::vector<float> max_hold;
+    for (size_t sweep = 0; sweep < sweeps; ++sweep) {
+        if (!scanner.sweep(result)) return -1;
+
+        double retune_sum = 0, retune_max = 0, settle_sum = 0, settle_max = 0;
+        size_t unsettled = 0, overflows = 0;
+        for (const ScanStep& step : result.steps) {
+            retune_sum += step.retune_us;
+            retune_max = std::max(retune_max, step.retune_us);
+            settle_sum += step.settle_us;
+            settle_max = std::max(settle_max, step.settle_us);
+            unsettled += !step.settled;
+            overflows += step.overflows;
+        }
+        size_t steps = result.steps.size();
+        size_t occupied = db.update(result, threshold_db);
+        printf("Проход %u: %.2f с (%.0f МГц/с), перестройка %.0f / %.0f мкс, установление %.0f / %.0f мкс "
+               "(среднее / макс), не установилось %zu, перезахватов %zu, занято каналов %zu\n",
+               db.sweeps(), result.seconds, (config.stop_frequency - config.start_frequency) / result.seconds / 1e6,
+               retune_sum / steps, retune_max, settle_sum / steps, settle_max, unsettled, overflows, occupied);
+
+        if (max_hold.empty()) max_hold = result.power_db;
+        for (size_t k = 0; k < max_hold.size(); ++k) max_hold[k] = std::max(max_hold[k], result.power_db[k]);
+
+        // Сохраняем после каждого прохода: прерванный обзор не теряет накопленное
+        if (!db_path.empty() && !db.save(db_path)) return -1;
+    }
+
+    if (!npz.empty()) {
+        std::vector<double> frequencies(result.steps.size());
+        std::vector<float> settle_us(result.steps.size());
+        for (size_t k = 0; k < result.steps.size(); ++k) {
+            frequencies[k] = result.steps[k].frequency;
+            settle_us[k] = static_cast<float>(result.steps[k].settle_us);
+        }
+        NpzWriter writer;
+        bool ok = writer.open(npz) && writer.add_scalar("start_frequency", result.start_frequency) &&
+                  writer.add_scalar("bin_width", result.bin_width) &&
+                  writer.add("power_db", result.power_db.data(), {result.power_db.size()}) &&
+                  writer.add("max_hold_db", max_hold.data(), {max_hold.size()}) &&
+                  writer.add("noise_floor_db", result.noise_floor_db.data(), {result.noise_floor_db.size()}) &&
+                  writer.add("step_frequency", frequencies.data(), {frequencies.size()}) &&
+                  writer.add("settle_us", settle_us.data(), {settle_us.size()});
+        if (!ok) return -1;
+        printf("Спектр: %s\n", npz.c_str());
+    }
+
+    if (!db_path.empty()) print_occupancy(db, report);
+    return 0;
+}
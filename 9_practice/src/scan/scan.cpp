@@ -0,0 +1,356 @@
+#include "scan/scan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Подряд идущих таймаутов приема, после которых шаг считается ошибкой
+constexpr size_t SCAN_MAX_TIMEOUTS = 10;
+// Перезахватов шага из-за переполнений, после которых обзор останавливается
+constexpr size_t SCAN_MAX_RESTARTS = 100;
+
+// ---------- SettleDetector ----------
+
+SettleDetector::SettleDetector(size_t block, double tolerance_db, size_t stable_blocks, size_t max_samples)
+    : block(block ? block : 1), tolerance_db(tolerance_db), stable_blocks(stable_blocks ? stable_blocks : 1),
+      max_samples(max_samples) {}
+
+void SettleDetector::reset() {
+    block_power = 0;
+    block_fill = 0;
+    previous_db = 0;
+    stable_run = 0;
+    discarded_samples = 0;
+    have_previous = false;
+    done = false;
+    timeout = false;
+}
+
+size_t SettleDetector::feed(const int16_t* iq, size_t samples_count) {
+    if (done) return 0;
+
+    for (size_t n = 0; n < samples_count; ++n) {
+        double i = iq[2 * n];
+        double q = iq[2 * n + 1];
+        block_power += i * i + q * q;
+        discarded_samples++;
+        if (++block_fill < block) continue;
+
+        double level = 10 * std::log10(block_power / block + 1e-3);
+        block_power = 0;
+        block_fill = 0;
+
+        stable_run = have_previous && std::fabs(level - previous_db) < tolerance_db ? stable_run + 1 : 0;
+        previous_db = level;
+        have_previous = true;
+
+        bool stable = stable_run + 1 >= stable_blocks;
+        if (stable || discarded_samples >= max_samples) {
+            done = true;
+            timeout = !stable;
+            return n + 1;
+        }
+    }
+    return samples_count;
+}
+
+size_t SettleDetector::settle_samples() const {
+    if (!done || timeout) return discarded_samples;
+    size_t verification = stable_blocks * block;
+    return discarded_samples > verification ? discarded_samples - verification : 0;
+}
+
+// ---------- FrequencyScanner ----------
+
+FrequencyScanner::FrequencyScanner(Device& device, RxStream& rx, const ScanConfig& config, WorkPool& pool)
+    : device(device), rx(rx), config(config), pool(pool), sample_rate(device.config().sample_rate),
+      detector(config.settle_block, config.settle_tolerance_db, config.settle_stable_blocks,
+               static_cast<size_t>(config.max_settle_us * device.config().sample_rate / 1e6)) {
+    const size_t n = config.spectrum.fft_size;
+
+    // Четное число бинов, чтобы шаг был симметричен относительно центра
+    usable_bins = static_cast<size_t>(config.usable_band * n) & ~size_t(1);
+    usable_bins = std::min(std::max<size_t>(usable_bins, 2), n);
+
+    const double step = usable_bins * bin_width();
+    for (size_t k = 0; config.start_frequency + k * step < config.stop_frequency; ++k) {
+        centers.push_back(config.start_frequency + (k + 0.5) * step);
+    }
+
+    // Слоты создаются до лямбд, которые держат на них указатели
+    slots.resize(std::max<size_t>(config.pipeline_depth, 1));
+    for (Slot& slot : slots) {
+        Slot* target = &slot;
+        slot.engine.reset(new SpectrumEngine(config.spectrum, [target](const std::vector<float>& power_db, uint64_t) {
+            target->row = power_db;
+        }));
+        free_slots.push_back(&slot);
+    }
+
+    SpectrumEngine& engine = *slots.front().engine;
+    capture_samples = engine.fft_size() + (config.spectrum.averages - 1) * engine.hop_size();
+    for (Slot& slot : slots) slot.samples.resize(capture_samples);
+}
+
+FrequencyScanner::Slot* FrequencyScanner::take_slot() {
+    std::unique_lock<std::mutex> lock(slot_mutex);
+    slot_freed.wait(lock, [&] { return !free_slots.empty(); });
+    Slot* slot = free_slots.back();
+    free_slots.pop_back();
+    return slot;
+}
+
+void FrequencyScanner::return_slot(Slot* slot) {
+    std::lock_guard<std::mutex> lock(slot_mutex);
+    free_slots.push_back(slot);
+    slot_freed.notify_one();
+}
+
+bool FrequencyScanner::sweep(ScanResult& result) {
+    result.start_frequency = config.start_frequency;
+    result.bin_width = bin_width();
+    result.power_db.assign(centers.size() * usable_bins, 0.0f);
+    result.noise_floor_db.assign(centers.size() * usable_bins, 0.0f);
+    result.steps.assign(centers.size(), ScanStep());
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (size_t index = 0; index < centers.size(); ++index) {
+        // Нет свободного слота - пул БПФ не успевает; ждем, устройство тем временем
+        // может переполниться, но эти отсчеты все равно отбросятся после перестройки
+        Slot* slot = take_slot();
+        if (!capture_step(index, *slot, result.steps[index])) {
+            return_slot(slot);
+            ok = false;
+            break;
+        }
+        pool.submit([this, index, slot, &result] {
+            finish_step(index, *slot, result);
+            return_slot(slot);
+        });
+    }
+    pool.wait();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool FrequencyScanner::capture_step(size_t index, Slot& slot, ScanStep& step) {
+    step.frequency = centers[index];
+
+    auto retune_start = std::chrono::steady_clock::now();
+    if (!device.set_frequency(false, step.frequency)) {
+        printf("Ошибка перестройки на %.3f МГц\n", step.frequency / 1e6);
+        return false;
+    }
+    step.retune_us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - retune_start).count();
+
+    // Буферы, принятые до перестройки, еще в очереди драйвера: их отбрасываем всегда.
+    // С временем устройства старые отсчеты видны по меткам, иначе - вся очередь целиком
+    long long tuned_ns = 0;
+    bool timed = device.hardware_time(&tuned_ns);
+    size_t flush = config.flush_samples;
+    if (!flush && !timed) flush = rx.queued_buffers() * rx.mtu();
+    detector.reset();
+    slot.filled = 0;
+    size_t timeouts = 0;
+
+    while (slot.filled < capture_samples) {
+        RxView view;
+        long received = rx.acquire(view, config.timeout_us);
+        if (received < 0) {
+            printf("Ошибка приема: %ld\n", received);
+            return false;
+        }
+        // Разрыв внутри захвата портит оценку Уэлча: захват начинается заново
+        if ((view.flags & STREAM_OVERFLOW) && slot.filled) {
+            slot.filled = 0;
+            if (++step.overflows >= SCAN_MAX_RESTARTS) {
+                printf("Переполнения не дают захватить шаг %.3f МГц: уменьшите averages или sample_rate\n",
+                       step.frequency / 1e6);
+                if (received > 0) rx.release(view);
+                return false;
+            }
+        }
+        if (received == 0) {
+            if (view.flags & STREAM_OVERFLOW) continue;
+            if (++timeouts >= SCAN_MAX_TIMEOUTS) {
+                printf("Нет отсчетов на %.3f МГц\n", step.frequency / 1e6);
+                return false;
+            }
+            continue;
+        }
+        timeouts = 0;
+
+        const int16_t* iq = view.iq;
+        size_t count = view.samples;
+        // Поток без меток: возвращаемся к сбросу очереди целиком
+        if (timed && !(view.flags & STREAM_HAS_TIME)) {
+            timed = false;
+            if (!config.flush_samples) flush = rx.queued_buffers() * rx.mtu();
+        }
+        size_t skip = std::min(flush, count);
+        flush -= skip;
+        if (timed && view.time_ns < tuned_ns) {
+            double stale = std::ceil((tuned_ns - view.time_ns) * 1e-9 * sample_rate);
+            skip = std::max(skip, static_cast<size_t>(std::min(stale, static_cast<double>(count))));
+        }
+        if (count > skip && !detector.settled()) skip += detector.feed(iq + 2 * skip, count - skip);
+        iq += 2 * skip;
+        count -= skip;
+
+        size_t take = std::min(count, capture_samples - slot.filled);
+        cs16_to_cf32(iq, slot.samples.data() + slot.filled, take);
+        slot.filled += take;
+        rx.release(view);
+    }
+
+    step.settle_us = detector.settle_samples() * 1e6 / sample_rate;
+    step.settled = !detector.timed_out();
+    return true;
+}
+
+void FrequencyScanner::finish_step(size_t index, Slot& slot, ScanResult& result) {
+    SpectrumEngine& engine = *slot.engine;
+    engine.reset();
+    engine.process(slot.samples.data(), capture_samples);
+
+    // Бин нулевой частоты - утечка гетеродина: заменяем средним соседей
+    const size_t n = engine.fft_size();
+    std::vector<float>& row = slot.row;
+    row[n / 2] = 0.5f * (row[n / 2 - 1] + row[n / 2 + 1]);
+
+    float* power = result.power_db.data() + index * usable_bins;
+    std::copy(row.begin() + (n - usable_bins) / 2, row.begin() + (n + usable_bins) / 2, power);
+
+    // Медиана по бинам шага - уровень шума при занятой части полосы
+    std::vector<float> sorted(power, power + usable_bins);
+    std::nth_element(sorted.begin(), sorted.begin() + usable_bins / 2, sorted.end());
+    float floor_db = sorted[usable_bins / 2];
+
+    std::fill_n(result.noise_floor_db.data() + index * usable_bins, usable_bins, floor_db);
+    result.steps[index].noise_floor_db = floor_db;
+}
+
+// ---------- OccupancyDb ----------
+
+struct OccupancyHeader {
+    char magic[4];
+    uint32_t channels;
+    uint32_t sweeps;
+    uint32_t reserved;
+    double start;
+    double width;
+};
+
+OccupancyDb::OccupancyDb(double start_frequency, double stop_frequency, double channel_width)
+    : start(start_frequency), width(channel_width) {
+    size_t count = static_cast<size_t>(std::ceil((stop_frequency - start_frequency) / channel_width));
+    records.assign(count, OccupancyRecord{0, 0, 0.0f, 0.0f});
+}
+
+bool OccupancyDb::load(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return true;
+
+    OccupancyHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, "OCC1", 4) == 0;
+    if (!ok) {
+        printf("Не файл базы занятости: %s\n", path.c_str());
+        fclose(file);
+        return false;
+    }
+    if (header.channels != records.size() || std::fabs(header.start - start) > 1 ||
+        std::fabs(header.width - width) > 1) {
+        printf("База %s: другая сетка каналов (%u по %.1f кГц от %.3f МГц)\n", path.c_str(), header.channels,
+               header.width / 1e3, header.start / 1e6);
+        fclose(file);
+        return false;
+    }
+
+    ok = fread(records.data(), sizeof(OccupancyRecord), records.size(), file) == records.size();
+    fclose(file);
+    if (!ok) {
+        printf("База %s обрезана\n", path.c_str());
+        return false;
+    }
+    sweeps_count = header.sweeps;
+    return true;
+}
+
+bool OccupancyDb::save(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) {
+        printf("Не удалось создать файл: %s\n", temporary.c_str());
+        return false;
+    }
+
+    OccupancyHeader header = {{'O', 'C', 'C', '1'}, uint32_t(records.size()), sweeps_count, 0, start, width};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(records.data(), sizeof(OccupancyRecord), records.size(), file) == records.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        printf("Ошибка записи базы: %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+size_t OccupancyDb::update(const ScanResult& result, double threshold_db) {
+    sweeps_count++;
+    size_t occupied = 0;
+    const size_t bins = result.power_db.size();
+
+    for (size_t channel = 0; channel < records.size(); ++channel) {
+        double low = (start + channel * width - result.start_frequency) / result.bin_width;
+        double high = low + width / result.bin_width;
+        // Канал уже бина - берется бин, в который попадает его центр
+        size_t first = static_cast<size_t>(std::max(0.0, std::floor(low)));
+        size_t last = std::max(first + 1, static_cast<size_t>(std::max(0.0, std::ceil(high))));
+        last = std::min(last, bins);
+        if (first >= last) continue;
+
+        double power = 0;
+        double floor_db = 0;
+        for (size_t k = first; k < last; ++k) {
+            power += std::pow(10.0, result.power_db[k] / 10);
+            floor_db += result.noise_floor_db[k];
+        }
+        float level = static_cast<float>(10 * std::log10(power / (last - first) + 1e-20));
+        floor_db /= last - first;
+
+        OccupancyRecord& r = records[channel];
+        r.mean_db += (level - r.mean_db) / sweeps_count;
+        r.max_db = sweeps_count == 1 ? level : std::max(r.max_db, level);
+        if (level > floor_db + threshold_db) {
+            r.occupied++;
+            r.last_sweep = sweeps_count;
+            occupied++;
+        }
+    }
+    return occupied;
+}
+
+void print_occupancy(const OccupancyDb& db, size_t top) {
+    std::vector<size_t> order;
+    for (size_t channel = 0; channel < db.channels_count(); ++channel) {
+        if (db.record(channel).occupied) order.push_back(channel);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const OccupancyRecord& x = db.record(a);
+        const OccupancyRecord& y = db.record(b);
+        return x.occupied != y.occupied ? x.occupied > y.occupied : x.mean_db > y.mean_db;
+    });
+    printf("\nКаналов %zu, проходов %u, занятых хотя бы раз %zu\n", db.channels_count(), db.sweeps(), order.size());
+    if (order.size() > top) order.resize(top);
+
+    printf("  Частота, МГц   Занятость   Среднее, дБ   Макс, дБ   Последний проход\n");
+    for (size_t channel : order) {
+        const OccupancyRecord& r = db.record(channel);
+        printf("  %12.3f   %8.1f%%   %11.1f   %8.1f   %u\n", db.channel_frequency(channel) / 1e6,
+               100.0 * r.occupied / db.sweeps(), r.mean_db, r.max_db, r.last_sweep);
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "batch/work_pool.h"
+#include "sdr/device.h"
+#include "spectrum/spectrum.h"
+
+// Обзор диапазона перестройкой гетеродина по плану частот.
+// Каждый шаг: перестройка -> отброс неустановившихся отсчетов -> захват -> PSD (Уэлч).
+// Захват идет в потоке вызывающего, БПФ - задачами в пуле, поэтому следующая
+// перестройка начинается, пока считается спектр предыдущего шага.
+
+struct ScanConfig {
+    double start_frequency = 70e6;
+    double stop_frequency = 6e9;
+    SpectrumConfig spectrum;         // fft_size, averages, overlap, окно
+    double usable_band = 0.75;       // доля полосы шага, идущая в сшивку (края - спад фильтров)
+    size_t pipeline_depth = 4;       // шагов, захваченных, но еще не посчитанных
+    size_t flush_samples = 0;        // безусловно отбросить после перестройки; 0 - по меткам
+                                     // времени устройства, без них - очередь драйвера целиком
+    size_t settle_block = 256;       // размер блока для оценки установления
+    double settle_tolerance_db = 1.0;
+    size_t settle_stable_blocks = 3; // столько подряд блоков с близкой мощностью
+    double max_settle_us = 20000;    // дольше - шаг помечается неустановившимся
+    long timeout_us = 100000;
+};
+
+// Отброс отсчетов после перестройки: мощность считается блоками, отсчеты
+// считаются установившимися после stable_blocks подряд блоков, отличающихся
+// меньше чем на tolerance_db. Проверочные блоки тоже отбрасываются.
+class SettleDetector {
+public:
+    SettleDetector(size_t block, double tolerance_db, size_t stable_blocks, size_t max_samples);
+
+    void reset();
+
+    // Сколько отсчетов с начала iq отбросить; остальные (если есть) уже установились
+    size_t feed(const int16_t* iq, size_t samples_count);
+
+    bool settled() const { return done; }
+    bool timed_out() const { return timeout; }
+    size_t discarded() const { return discarded_samples; }
+    // Оценка длительности переходного процесса без проверочных блоков
+    size_t settle_samples() const;
+
+private:
+    size_t block;
+    double tolerance_db;
+    size_t stable_blocks;
+    size_t max_samples;
+
+    double block_power = 0;
+    size_t block_fill = 0;
+    double previous_db = 0;
+    size_t stable_run = 0;
+    size_t discarded_samples = 0;
+    bool have_previous = false;
+    bool done = false;
+    bool timeout = false;
+};
+
+struct ScanStep {
+    double frequency = 0;
+    double retune_us = 0;            // время вызова set_frequency
+    double settle_us = 0;            // переходный процесс по отсчетам
+    bool settled = true;
+    size_t overflows = 0;
+    float noise_floor_db = 0;        // медиана мощности по бинам шага
+};
+
+// Сшитый спектр одного прохода: бин k - частота start_frequency + k * bin_width
+struct ScanResult {
+    double start_frequency = 0;
+    double bin_width = 0;
+    std::vector<float> power_db;
+    std::vector<float> noise_floor_db;  // по бинам: уровень шума шага, к которому бин относится
+    std::vector<ScanStep> steps;
+    double seconds = 0;
+};
+
+class FrequencyScanner {
+public:
+    FrequencyScanner(Device& device, RxStream& rx, const ScanConfig& config, WorkPool& pool);
+
+    const std::vector<double>& plan() const { return centers; }
+    size_t step_bins() const { return usable_bins; }
+    double bin_width() const { return sample_rate / config.spectrum.fft_size; }
+
+    // Один проход по плану; false - ошибка приема
+    bool sweep(ScanResult& result);
+
+private:
+    struct Slot {
+        std::unique_ptr<SpectrumEngine> engine;
+        std::vector<float> row;
+        std::vector<cf32> samples;
+        size_t filled = 0;
+    };
+
+    Slot* take_slot();
+    void return_slot(Slot* slot);
+    bool capture_step(size_t index, Slot& slot, ScanStep& step);
+    void finish_step(size_t index, Slot& slot, ScanResult& result);
+
+    Device& device;
+    RxStream& rx;
+    ScanConfig config;
+    WorkPool& pool;
+    double sample_rate;
+    size_t usable_bins;
+    size_t capture_samples;
+    std::vector<double> centers;
+    SettleDetector detector;
+
+    std::vector<Slot> slots;
+    std::vector<Slot*> free_slots;
+    std::mutex slot_mutex;
+    std::condition_variable slot_freed;
+};
+
+// База занятости по каналам ширины channel_width: сколько проходов канал был выше
+// шума шага на threshold_db, средняя и максимальная мощность, номер последнего
+// прохода с занятостью. Файл - заголовок и 16 байт на канал (70 МГц - 6 ГГц по
+// 200 кГц - около 470 КБ); при следующем запуске статистика продолжается.
+struct OccupancyRecord {
+    uint32_t occupied;
+    uint32_t last_sweep;
+    float mean_db;
+    float max_db;
+};
+
+class OccupancyDb {
+public:
+    OccupancyDb(double start_frequency, double stop_frequency, double channel_width);
+
+    size_t channels_count() const { return records.size(); }
+    uint32_t sweeps() const { return sweeps_count; }
+    double channel_frequency(size_t channel) const { return start + (channel + 0.5) * width; }
+    const OccupancyRecord& record(size_t channel) const { return records[channel]; }
+
+    // Файла нет - база пустая (true); другая сетка каналов - false
+    bool load(const std::string& path);
+    // Через временный файл и rename, чтобы прерванная запись не портила базу
+    bool save(const std::string& path) const;
+
+    // Возвращает число занятых в этом проходе каналов
+    size_t update(const ScanResult& result, double threshold_db);
+
+private:
+    double start;
+    double width;
+    uint32_t sweeps_count = 0;
+    std::vector<OccupancyRecord> records;
+};
+
+// Отчет: top каналов по доле занятости
+void print_occupancy(const OccupancyDb& db, size_t top);
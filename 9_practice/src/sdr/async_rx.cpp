@@ -0,0 +1,121 @@
+#include "sdr/async_rx.h"
+
+#include <algorithm>
+
+constexpr long ASYNC_READ_TIMEOUT_US = 100000;
+
+static size_t pool_size(const RxStream& stream, size_t buffers_count) {
+    size_t count = buffers_count ? buffers_count : 1;
+    if (stream.direct_buffers() >= 2) count = std::min(count, stream.direct_buffers() - 1);
+    return count;
+}
+
+AsyncReceiver::AsyncReceiver(RxStream& stream, size_t buffers_count, Callback callback)
+    : stream(stream), callback(std::move(callback)), direct(stream.direct_buffers() >= 2),
+      blocks(pool_size(stream, buffers_count)) {
+    // При прямом доступе свои буферы не нужны
+    size_t mtu = direct ? 0 : stream.mtu();
+    for (RxBlock& block : blocks) {
+        block.iq.resize(mtu * 2);
+        free_blocks.push_back(&block);
+    }
+    spare.iq.resize(mtu * 2);
+}
+
+AsyncReceiver::~AsyncReceiver() {
+    stop();
+}
+
+void AsyncReceiver::start() {
+    if (active) return;
+    active = true;
+    reader = std::thread(&AsyncReceiver::reader_loop, this);
+    dispatcher = std::thread(&AsyncReceiver::dispatch_loop, this);
+}
+
+void AsyncReceiver::stop() {
+    active = false;
+    block_ready.notify_all();
+    block_freed.notify_all();
+    if (reader.joinable()) reader.join();
+    if (dispatcher.joinable()) dispatcher.join();
+}
+
+void AsyncReceiver::reader_loop() {
+    while (active) {
+        RxBlock* block = nullptr;
+        bool dropping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Буфер драйвера, взятый в запасной, еще в очереди: следующий acquire
+            // превысил бы число буферов, которые можно держать
+            if (direct) block_freed.wait(lock, [&] { return !active || !free_blocks.empty() || !spare_busy; });
+            if (!active) break;
+            if (!free_blocks.empty()) {
+                block = free_blocks.back();
+                free_blocks.pop_back();
+            } else {
+                // Пул исчерпан: читаем все равно, чтобы не переполнить буфер устройства
+                dropping = true;
+                block = &spare;
+                spare_busy = direct;
+            }
+        }
+        block->drop = dropping;
+
+        long result;
+        if (direct) {
+            result = stream.acquire(block->view, ASYNC_READ_TIMEOUT_US);
+            block->data = block->view.iq;
+            block->time_ns = block->view.time_ns;
+            block->flags = block->view.flags;
+        } else {
+            result = stream.read(block->iq.data(), block->iq.size() / 2, &block->time_ns, &block->flags,
+                                 ASYNC_READ_TIMEOUT_US);
+            block->data = block->iq.data();
+        }
+        block->completed = std::chrono::steady_clock::now();
+
+        if (dropping && result > 0) blocks_dropped++;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result <= 0) {
+            if (result < 0) read_errors++;
+            if (dropping) spare_busy = false;
+            else free_blocks.push_back(block);
+            if (result < 0 && read_errors > 100) active = false;
+            continue;
+        }
+        // Без прямого доступа запасной - свой буфер, возвращать драйверу нечего
+        if (dropping && !direct) continue;
+
+        block->samples = static_cast<size_t>(result);
+        completed.push_back(block);
+        block_ready.notify_one();
+    }
+    block_ready.notify_all();
+}
+
+void AsyncReceiver::dispatch_loop() {
+    while (true) {
+        RxBlock* block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            block_ready.wait(lock, [&] { return !active || !completed.empty(); });
+            if (completed.empty()) return;
+            block = completed.front();
+            completed.pop_front();
+        }
+
+        if (!block->drop) {
+            callback(*block);
+            blocks_delivered++;
+        }
+        if (direct) stream.release(block->view);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (block->drop) spare_busy = false;
+        else free_blocks.push_back(block);
+        block_freed.notify_one();
+    }
+}
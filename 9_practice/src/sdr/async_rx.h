@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sdr/device.h"
+
+// Заполненный буфер приема. data - в собственный iq или, при прямом доступе,
+// в память драйвера (view) до возврата блока в пул.
+struct RxBlock {
+    std::vector<int16_t> iq;
+    const int16_t* data = nullptr;
+    RxView view;
+    size_t samples = 0;
+    long long time_ns = 0;
+    int flags = 0;
+    // Прочитан в запасной при заполненном пуле: доставка только возвращает его драйверу
+    bool drop = false;
+    // Момент завершения чтения: по нему считается задержка доставки потребителю
+    std::chrono::steady_clock::time_point completed;
+};
+
+// Асинхронный прием: поток чтения заполняет буферы из пула и кладет их
+// в очередь завершения, поток доставки вызывает callback для каждого буфера
+// и возвращает его в пул. Поток приложения в цикле readStream не участвует.
+// Если драйвер дает не меньше двух буферов прямого доступа, блоки - это view
+// в его память без memcpy: пул ограничен числом буферов драйвера минус один
+// (запасной для чтения при заполненном пуле), release вызывается из потока доставки
+// в порядке приема - и для сброшенных блоков тоже. Пока запасной не вернулся,
+// новый буфер у драйвера не берется.
+class AsyncReceiver {
+public:
+    using Callback = std::function<void(const RxBlock& block)>;
+
+    AsyncReceiver(RxStream& stream, size_t buffers_count, Callback callback);
+    ~AsyncReceiver();
+
+    AsyncReceiver(const AsyncReceiver&) = delete;
+    AsyncReceiver& operator=(const AsyncReceiver&) = delete;
+
+    void start();
+    void stop();
+
+    uint64_t delivered() const { return blocks_delivered; }
+    // Буферы, прочитанные в запасной, потому что потребитель не успел вернуть пул
+    uint64_t dropped() const { return blocks_dropped; }
+    uint64_t errors() const { return read_errors; }
+    bool zero_copy() const { return direct; }
+
+private:
+    void reader_loop();
+    void dispatch_loop();
+
+    RxStream& stream;
+    Callback callback;
+    bool direct;
+
+    std::vector<RxBlock> blocks;
+    RxBlock spare;
+    std::vector<RxBlock*> free_blocks;
+    std::deque<RxBlock*> completed;
+
+    std::mutex mutex;
+    std::condition_variable block_ready;
+    std::condition_variable block_freed;
+    bool spare_busy = false;
+
+    std::thread reader;
+    std::thread dispatcher;
+    std::atomic<bool> active{false};
+
+    std::atomic<uint64_t> blocks_delivered{0};
+    std::atomic<uint64_t> blocks_dropped{0};
+    std::atomic<uint64_t> read_errors{0};
+};
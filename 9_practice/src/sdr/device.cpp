@@ -0,0 +1,234 @@
+#include "sdr/device.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "iio/iio_stream.h"
+
+#ifdef HAVE_SOAPYSDR
+std::unique_ptr<Device> make_soapy_device(const DeviceConfig& config);
+#endif
+
+bool parse_device_arg(const std::string& arg, DeviceConfig& config) {
+    size_t equals = arg.find('=');
+    if (equals == std::string::npos) return true;
+
+    std::string key = arg.substr(0, equals);
+    std::string value = arg.substr(equals + 1);
+    char* end = nullptr;
+
+    auto number = [&](double& field) {
+        field = strtod(value.c_str(), &end);
+        return end && *end == '\0';
+    };
+
+    if (key == "backend") config.backend = value;
+    else if (key == "uri") config.uri = value;
+    else if (key == "tx_uri") config.tx_uri = value;
+    else if (key == "sample_rate") return number(config.sample_rate);
+    else if (key == "frequency") {
+        if (!number(config.rx_frequency)) return false;
+        config.tx_frequency = config.rx_frequency;
+    }
+    else if (key == "rx_frequency") return number(config.rx_frequency);
+    else if (key == "tx_frequency") return number(config.tx_frequency);
+    else if (key == "rx_gain") return number(config.rx_gain);
+    else if (key == "tx_gain") return number(config.tx_gain);
+    else if (key == "buffer_samples") config.buffer_samples = strtoul(value.c_str(), nullptr, 10);
+    else if (key == "loopback") config.loopback = value == "1";
+    else if (key == "zero_copy") config.zero_copy = value == "1";
+    return true;
+}
+
+// Запасной путь без прямого доступа: одна копия во внутренний буфер, как в read/write
+long RxStream::acquire(RxView& view, long timeout_us) {
+    copy_buffer.resize(2 * mtu());
+    long result = read(copy_buffer.data(), mtu(), &view.time_ns, &view.flags, timeout_us);
+    view.iq = copy_buffer.data();
+    view.samples = result > 0 ? static_cast<size_t>(result) : 0;
+    view.handle = 0;
+    return result;
+}
+
+long TxStream::acquire(TxView& view, long) {
+    copy_buffer.resize(2 * mtu());
+    view.iq = copy_buffer.data();
+    view.samples = mtu();
+    view.handle = 0;
+    return static_cast<long>(view.samples);
+}
+
+long TxStream::release(const TxView& view, size_t samples_count, long long time_ns, int flags, long timeout_us) {
+    return write(view.iq, samples_count, time_ns, flags, timeout_us);
+}
+
+// ---------- Реализация поверх StreamBackend (libiio и файлы) ----------
+
+// Время считается по числу отсчетов: у этих backend'ов нет меток времени устройства
+class BackendRxStream : public RxStream {
+public:
+    BackendRxStream(std::unique_ptr<StreamBackend> backend, double sample_rate, bool zero_copy,
+                    StreamBackend** live)
+        : backend(std::move(backend)), sample_rate(sample_rate), zero_copy(zero_copy), live(live) {
+        *live = this->backend.get();
+    }
+
+    ~BackendRxStream() override {
+        if (*live == backend.get()) *live = nullptr;
+        backend->close();
+    }
+
+    long read(int16_t* iq, size_t samples_count, long long* time_ns, int* flags, long) override {
+        // Остаток прошлого буфера отдается первым
+        if (offset == available) {
+            long received = backend->refill();
+            if (received <= 0) return received;
+            available = static_cast<size_t>(received);
+            offset = 0;
+        }
+
+        size_t count = std::min(samples_count, available - offset);
+        memcpy(iq, backend->buffer() + 2 * offset, count * 2 * sizeof(int16_t));
+        offset += count;
+
+        *time_ns = static_cast<long long>(samples_read * 1e9 / sample_rate);
+        *flags = STREAM_HAS_TIME;
+        samples_read += count;
+        return static_cast<long>(count);
+    }
+
+    size_t mtu() const override { return backend->buffer_samples(); }
+
+    // Буфер libiio один: следующий refill перезаписывает его, поэтому держать можно только один
+    size_t direct_buffers() const override { return zero_copy ? 1 : 0; }
+
+    size_t queued_buffers() const override { return backend->queued_buffers(); }
+
+    long acquire(RxView& view, long timeout_us) override {
+        if (!zero_copy) return RxStream::acquire(view, timeout_us);
+        if (offset == available) {
+            long received = backend->refill();
+            if (received <= 0) return received;
+            available = static_cast<size_t>(received);
+            offset = 0;
+        }
+
+        view.iq = backend->buffer() + 2 * offset;
+        view.samples = available - offset;
+        view.time_ns = static_cast<long long>(samples_read * 1e9 / sample_rate);
+        view.flags = STREAM_HAS_TIME;
+        view.handle = 0;
+        samples_read += view.samples;
+        offset = available;
+        return static_cast<long>(view.samples);
+    }
+
+private:
+    std::unique_ptr<StreamBackend> backend;
+    double sample_rate;
+    bool zero_copy;
+    StreamBackend** live;
+    size_t available = 0;
+    size_t offset = 0;
+    uint64_t samples_read = 0;
+};
+
+class BackendTxStream : public TxStream {
+public:
+    BackendTxStream(std::unique_ptr<StreamBackend> backend, bool zero_copy, StreamBackend** live)
+        : backend(std::move(backend)), zero_copy(zero_copy), live(live) {
+        *live = this->backend.get();
+    }
+
+    ~BackendTxStream() override {
+        if (*live == backend.get()) *live = nullptr;
+        backend->close();
+    }
+
+    long write(const int16_t* iq, size_t samples_count, long long, int, long) override {
+        // Метки времени libiio не поддерживает: отсчеты уходят сразу
+        size_t count = std::min(samples_count, backend->buffer_samples());
+        memcpy(backend->buffer(), iq, count * 2 * sizeof(int16_t));
+        return backend->push(count);
+    }
+
+    size_t mtu() const override { return backend->buffer_samples(); }
+
+    size_t direct_buffers() const override { return zero_copy ? 1 : 0; }
+
+    long acquire(TxView& view, long timeout_us) override {
+        if (!zero_copy) return TxStream::acquire(view, timeout_us);
+        view.iq = backend->buffer();
+        view.samples = backend->buffer_samples();
+        view.handle = 0;
+        return static_cast<long>(view.samples);
+    }
+
+    long release(const TxView& view, size_t samples_count, long long time_ns, int flags, long timeout_us) override {
+        if (!zero_copy) return TxStream::release(view, samples_count, time_ns, flags, timeout_us);
+        return backend->push(std::min(samples_count, backend->buffer_samples()));
+    }
+
+private:
+    std::unique_ptr<StreamBackend> backend;
+    bool zero_copy;
+    StreamBackend** live;
+};
+
+class BackendDevice : public Device {
+public:
+    explicit BackendDevice(const DeviceConfig& config) : settings(config) {}
+
+    const char* name() const override { return settings.backend == "file" ? "file" : "libiio"; }
+    const DeviceConfig& config() const override { return settings; }
+
+    bool set_frequency(bool tx, double frequency) override {
+        // Без открытого потока частота применяется при открытии; открытый libiio
+        // перестраивается через свой контекст, файл - не перестраивается
+        (tx ? settings.tx_frequency : settings.rx_frequency) = frequency;
+        StreamBackend* backend = tx ? live_tx : live_rx;
+        if (!backend) return true;
+        if (backend->set_frequency(frequency)) return true;
+        printf("Backend %s не перестраивается при открытом потоке\n", name());
+        return false;
+    }
+
+    std::unique_ptr<RxStream> open_rx() override {
+        std::string uri = settings.backend == "file" ? "file:" + settings.uri : settings.uri;
+        std::unique_ptr<StreamBackend> backend =
+            make_stream_backend(uri, StreamDirection::RX, settings.sample_rate, settings.rx_frequency, settings.rx_gain);
+        if (!backend || !backend->open(settings.buffer_samples, false)) return nullptr;
+        return std::unique_ptr<RxStream>(
+            new BackendRxStream(std::move(backend), settings.sample_rate, settings.zero_copy, &live_rx));
+    }
+
+    std::unique_ptr<TxStream> open_tx() override {
+        std::string uri = settings.uri;
+        if (settings.backend == "file") uri = "file:" + (settings.tx_uri.empty() ? "/dev/null" : settings.tx_uri);
+        std::unique_ptr<StreamBackend> backend =
+            make_stream_backend(uri, StreamDirection::TX, settings.sample_rate, settings.tx_frequency, settings.tx_gain);
+        if (!backend || !backend->open(settings.buffer_samples, false)) return nullptr;
+        return std::unique_ptr<TxStream>(new BackendTxStream(std::move(backend), settings.zero_copy, &live_tx));
+    }
+
+private:
+    DeviceConfig settings;
+    // Открытые сейчас потоки (потоки не переживают устройство)
+    StreamBackend* live_rx = nullptr;
+    StreamBackend* live_tx = nullptr;
+};
+
+std::unique_ptr<Device> make_device(const DeviceConfig& config) {
+    if (config.backend == "iio" || config.backend == "file") {
+        return std::unique_ptr<Device>(new BackendDevice(config));
+    }
+
+#ifdef HAVE_SOAPYSDR
+    if (config.backend == "soapy") return make_soapy_device(config);
+#endif
+
+    printf("Неизвестный или не собранный backend: %s\n", config.backend.c_str());
+    return nullptr;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Все настройки радио в одном месте вместо копий в каждом main
+struct DeviceConfig {
+    std::string backend = "soapy";   // "soapy", "iio" или "file"
+    std::string uri = "usb:";        // для file - путь к записи RX
+    std::string tx_uri;              // для file - куда писать TX (по умолчанию /dev/null)
+    double sample_rate = 1000000;
+    double rx_frequency = 800000000;
+    double tx_frequency = 800000000;
+    double rx_gain = 10.0;
+    double tx_gain = -90.0;
+    size_t buffer_samples = 1920;    // timestamp_every
+    bool loopback = false;
+    bool zero_copy = true;           // прямой доступ к буферам драйвера, если он есть
+};
+
+// Разбор аргументов вида key=value (backend=iio uri=ip:192.168.2.1 rx_gain=20 ...).
+// Неизвестные ключи оставляются вызывающему: возвращается false только при ошибке значения.
+bool parse_device_arg(const std::string& arg, DeviceConfig& config);
+
+// Флаги, общие для всех реализаций
+constexpr int STREAM_HAS_TIME = 1 << 0;
+// Устройство потеряло отсчеты (переполнение буфера приема). Это не ошибка:
+// read/acquire возвращают 0 с этим флагом, следующий буфер идет после разрыва.
+constexpr int STREAM_OVERFLOW = 1 << 1;
+
+// Принятый буфер без копирования: iq указывает в память драйвера (DMA) и
+// действителен до release. handle - номер буфера у драйвера.
+struct RxView {
+    const int16_t* iq = nullptr;
+    size_t samples = 0;
+    long long time_ns = 0;
+    int flags = 0;
+    size_t handle = 0;
+};
+
+// Буфер передачи: iq заполняется на месте, до samples отсчетов
+struct TxView {
+    int16_t* iq = nullptr;
+    size_t samples = 0;
+    size_t handle = 0;
+};
+
+// Поток приема. Закрывается и останавливается в деструкторе.
+class RxStream {
+public:
+    virtual ~RxStream() = default;
+
+    // Прочитать до samples_count отсчетов CS16. Возвращает число отсчетов,
+    // 0 - таймаут или переполнение (flags & STREAM_OVERFLOW), < 0 - ошибка.
+    // time_ns - время первого отсчета (время устройства).
+    virtual long read(int16_t* iq, size_t samples_count, long long* time_ns, int* flags, long timeout_us) = 0;
+
+    virtual size_t mtu() const = 0;
+
+    // Сколько буферов драйвера можно держать одновременно (между acquire и release).
+    // 0 - прямого доступа нет: acquire читает через read во внутренний буфер.
+    virtual size_t direct_buffers() const { return 0; }
+
+    // Сколько буферов устройство принимает заранее: после перестройки столько
+    // буферов по mtu() еще содержат отсчеты старой частоты
+    virtual size_t queued_buffers() const { return 1; }
+
+    // Следующий буфер целиком. Возвращает view.samples, 0 - таймаут или переполнение
+    // (view.flags & STREAM_OVERFLOW), < 0 - ошибка; release нужен только при результате > 0.
+    virtual long acquire(RxView& view, long timeout_us);
+    virtual void release(const RxView& view) { (void)view; }
+
+private:
+    std::vector<int16_t> copy_buffer;
+};
+
+// Поток передачи. Закрывается и останавливается в деструкторе.
+class TxStream {
+public:
+    virtual ~TxStream() = default;
+
+    // Передать samples_count отсчетов; при STREAM_HAS_TIME - начиная с времени time_ns
+    virtual long write(const int16_t* iq, size_t samples_count, long long time_ns, int flags, long timeout_us) = 0;
+
+    // Асинхронный статус: true, если устройство сообщило об опустошении буфера
+    // (time_ns - время события, если известно). Без поддержки - всегда false.
+    virtual bool poll_underflow(long long* time_ns, long timeout_us) {
+        (void)time_ns;
+        (void)timeout_us;
+        return false;
+    }
+
+    virtual size_t mtu() const = 0;
+
+    virtual size_t direct_buffers() const { return 0; }
+
+    // Свободный буфер передачи. Возвращает view.samples, 0 - таймаут, < 0 - ошибка.
+    // release отправляет первые samples_count отсчетов; без прямого доступа - через write.
+    virtual long acquire(TxView& view, long timeout_us);
+    virtual long release(const TxView& view, size_t samples_count, long long time_ns, int flags, long timeout_us);
+
+private:
+    std::vector<int16_t> copy_buffer;
+};
+
+// Радио с взаимозаменяемыми реализациями (SoapySDR, libiio, файл)
+class Device {
+public:
+    virtual ~Device() = default;
+
+    virtual const char* name() const = 0;
+    virtual const DeviceConfig& config() const = 0;
+
+    // Перестройка гетеродина без пересоздания устройства. true - открытый поток
+    // уже принимает/передает на новой частоте (или потока нет и частота запомнена).
+    virtual bool set_frequency(bool tx, double frequency) = 0;
+
+    // Текущее время устройства в шкале меток RxView::time_ns; false - недоступно
+    virtual bool hardware_time(long long* time_ns) {
+        (void)time_ns;
+        return false;
+    }
+
+    virtual std::unique_ptr<RxStream> open_rx() = 0;
+    virtual std::unique_ptr<TxStream> open_tx() = 0;
+};
+
+// Создает и настраивает устройство по config.backend; nullptr при ошибке
+std::unique_ptr<Device> make_device(const DeviceConfig& config);
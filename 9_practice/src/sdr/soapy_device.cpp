@@ -0,0 +1,207 @@
+#include <SoapySDR/Device.h>
+#include <SoapySDR/Formats.h>
+#include <algorithm>
+#include <cstdio>
+
+#include "sdr/device.h"
+
+// Реализация Device поверх C API SoapySDR (как во 2-6 практиках)
+
+// Буферов в очереди приема, если драйвер не сообщает больше (4 буфера ядра libiio)
+constexpr size_t SOAPY_QUEUED_BUFFERS = 4;
+
+class SoapyRxStream : public RxStream {
+public:
+    SoapyRxStream(SoapySDRDevice* device, SoapySDRStream* stream, bool zero_copy) : device(device), stream(stream) {
+        SoapySDRDevice_activateStream(device, stream, 0, 0, 0);
+        stream_mtu = SoapySDRDevice_getStreamMTU(device, stream);
+        // Драйвер без прямого доступа вернет 0: тогда acquire идет через readStream
+        if (zero_copy) direct_count = SoapySDRDevice_getNumDirectAccessBuffers(device, stream);
+    }
+
+    ~SoapyRxStream() override {
+        SoapySDRDevice_deactivateStream(device, stream, 0, 0);
+        SoapySDRDevice_closeStream(device, stream);
+    }
+
+    long read(int16_t* iq, size_t samples_count, long long* time_ns, int* flags, long timeout_us) override {
+        void* buffers[] = {iq};
+        int soapy_flags = 0;
+        int result = SoapySDRDevice_readStream(device, stream, buffers, samples_count, &soapy_flags, time_ns, timeout_us);
+        return convert_result(result, soapy_flags, flags);
+    }
+
+    size_t mtu() const override { return stream_mtu; }
+
+    size_t direct_buffers() const override { return direct_count; }
+
+    // Очередь драйвера не сообщается: plutosdr держит не меньше буферов ядра libiio
+    size_t queued_buffers() const override { return std::max<size_t>(direct_count, SOAPY_QUEUED_BUFFERS); }
+
+    long acquire(RxView& view, long timeout_us) override {
+        if (!direct_count) return RxStream::acquire(view, timeout_us);
+        const void* buffers[] = {nullptr};
+        int soapy_flags = 0;
+        int result = SoapySDRDevice_acquireReadBuffer(device, stream, &view.handle, buffers, &soapy_flags,
+                                                      &view.time_ns, timeout_us);
+        long count = convert_result(result, soapy_flags, &view.flags);
+        view.iq = static_cast<const int16_t*>(buffers[0]);
+        view.samples = count > 0 ? static_cast<size_t>(count) : 0;
+        return count;
+    }
+
+    void release(const RxView& view) override {
+        if (direct_count) SoapySDRDevice_releaseReadBuffer(device, stream, view.handle);
+    }
+
+private:
+    static long convert_result(int result, int soapy_flags, int* flags) {
+        *flags = (soapy_flags & SOAPY_SDR_HAS_TIME) ? STREAM_HAS_TIME : 0;
+        if (result == SOAPY_SDR_TIMEOUT) return 0;
+        // Переполнение - не ошибка потока: отсчеты потеряны, буфер не выдан
+        if (result == SOAPY_SDR_OVERFLOW) {
+            *flags |= STREAM_OVERFLOW;
+            return 0;
+        }
+        return result;
+    }
+
+    SoapySDRDevice* device;
+    SoapySDRStream* stream;
+    size_t stream_mtu = 0;
+    size_t direct_count = 0;
+};
+
+class SoapyTxStream : public TxStream {
+public:
+    SoapyTxStream(SoapySDRDevice* device, SoapySDRStream* stream, bool zero_copy) : device(device), stream(stream) {
+        SoapySDRDevice_activateStream(device, stream, 0, 0, 0);
+        stream_mtu = SoapySDRDevice_getStreamMTU(device, stream);
+        if (zero_copy) direct_count = SoapySDRDevice_getNumDirectAccessBuffers(device, stream);
+    }
+
+    ~SoapyTxStream() override {
+        SoapySDRDevice_deactivateStream(device, stream, 0, 0);
+        SoapySDRDevice_closeStream(device, stream);
+    }
+
+    long write(const int16_t* iq, size_t samples_count, long long time_ns, int flags, long timeout_us) override {
+        const void* buffers[] = {iq};
+        int soapy_flags = (flags & STREAM_HAS_TIME) ? SOAPY_SDR_HAS_TIME : 0;
+        return SoapySDRDevice_writeStream(device, stream, buffers, samples_count, &soapy_flags, time_ns, timeout_us);
+    }
+
+    bool poll_underflow(long long* time_ns, long timeout_us) override {
+        size_t channel_mask = 0;
+        int flags = 0;
+        long long event_time = 0;
+        int result = SoapySDRDevice_readStreamStatus(device, stream, &channel_mask, &flags, &event_time, timeout_us);
+        if (result != SOAPY_SDR_UNDERFLOW) return false;
+        if (time_ns) *time_ns = (flags & SOAPY_SDR_HAS_TIME) ? event_time : 0;
+        return true;
+    }
+
+    size_t mtu() const override { return stream_mtu; }
+
+    size_t direct_buffers() const override { return direct_count; }
+
+    long acquire(TxView& view, long timeout_us) override {
+        if (!direct_count) return TxStream::acquire(view, timeout_us);
+        void* buffers[] = {nullptr};
+        int result = SoapySDRDevice_acquireWriteBuffer(device, stream, &view.handle, buffers, timeout_us);
+        if (result == SOAPY_SDR_TIMEOUT) return 0;
+        view.iq = static_cast<int16_t*>(buffers[0]);
+        view.samples = result > 0 ? static_cast<size_t>(result) : 0;
+        return result;
+    }
+
+    long release(const TxView& view, size_t samples_count, long long time_ns, int flags, long timeout_us) override {
+        if (!direct_count) return TxStream::release(view, samples_count, time_ns, flags, timeout_us);
+        int soapy_flags = (flags & STREAM_HAS_TIME) ? SOAPY_SDR_HAS_TIME : 0;
+        SoapySDRDevice_releaseWriteBuffer(device, stream, view.handle, samples_count, &soapy_flags, time_ns);
+        return static_cast<long>(samples_count);
+    }
+
+private:
+    SoapySDRDevice* device;
+    SoapySDRStream* stream;
+    size_t stream_mtu = 0;
+    size_t direct_count = 0;
+};
+
+class SoapyDevice : public Device {
+public:
+    SoapyDevice(const DeviceConfig& config, SoapySDRDevice* device) : settings(config), device(device) {}
+
+    ~SoapyDevice() override { SoapySDRDevice_unmake(device); }
+
+    const char* name() const override { return "soapy"; }
+    const DeviceConfig& config() const override { return settings; }
+
+    void configure() {
+        // Конфигурация приемника
+        SoapySDRDevice_setSampleRate(device, SOAPY_SDR_RX, 0, settings.sample_rate);
+        SoapySDRDevice_setFrequency(device, SOAPY_SDR_RX, 0, settings.rx_frequency, nullptr);
+
+        // Конфигурация передатчика
+        SoapySDRDevice_setSampleRate(device, SOAPY_SDR_TX, 0, settings.sample_rate);
+        SoapySDRDevice_setFrequency(device, SOAPY_SDR_TX, 0, settings.tx_frequency, nullptr);
+
+        // Настройка усиления
+        SoapySDRDevice_setGain(device, SOAPY_SDR_RX, 0, settings.rx_gain);
+        SoapySDRDevice_setGain(device, SOAPY_SDR_TX, 0, settings.tx_gain);
+    }
+
+    bool set_frequency(bool tx, double frequency) override {
+        (tx ? settings.tx_frequency : settings.rx_frequency) = frequency;
+        return SoapySDRDevice_setFrequency(device, tx ? SOAPY_SDR_TX : SOAPY_SDR_RX, 0, frequency, nullptr) == 0;
+    }
+
+    bool hardware_time(long long* time_ns) override {
+        if (!SoapySDRDevice_hasHardwareTime(device, nullptr)) return false;
+        *time_ns = SoapySDRDevice_getHardwareTime(device, nullptr);
+        return true;
+    }
+
+    std::unique_ptr<RxStream> open_rx() override {
+        SoapySDRStream* stream = setup(SOAPY_SDR_RX);
+        return stream ? std::unique_ptr<RxStream>(new SoapyRxStream(device, stream, settings.zero_copy)) : nullptr;
+    }
+
+    std::unique_ptr<TxStream> open_tx() override {
+        SoapySDRStream* stream = setup(SOAPY_SDR_TX);
+        return stream ? std::unique_ptr<TxStream>(new SoapyTxStream(device, stream, settings.zero_copy)) : nullptr;
+    }
+
+private:
+    SoapySDRStream* setup(int direction) {
+        const size_t channels[] = {0};
+        SoapySDRStream* stream = SoapySDRDevice_setupStream(device, direction, SOAPY_SDR_CS16, channels, 1, nullptr);
+        if (!stream) printf("Ошибка настройки потока: %s\n", SoapySDRDevice_lastError());
+        return stream;
+    }
+
+    DeviceConfig settings;
+    SoapySDRDevice* device;
+};
+
+std::unique_ptr<Device> make_soapy_device(const DeviceConfig& config) {
+    SoapySDRKwargs args = {};
+    SoapySDRKwargs_set(&args, "driver", "plutosdr");
+    SoapySDRKwargs_set(&args, "uri", config.uri.c_str());
+    SoapySDRKwargs_set(&args, "direct", "1");
+    SoapySDRKwargs_set(&args, "timestamp_every", std::to_string(config.buffer_samples).c_str());
+    SoapySDRKwargs_set(&args, "loopback", config.loopback ? "1" : "0");
+
+    SoapySDRDevice* device = SoapySDRDevice_make(&args);
+    SoapySDRKwargs_clear(&args);
+
+    if (!device) {
+        printf("Ошибка инициализации SDR устройства\n");
+        return nullptr;
+    }
+
+    SoapyDevice* soapy = new SoapyDevice(config, device);
+    soapy->configure();
+    return std::unique_ptr<Device>(soapy);
+}
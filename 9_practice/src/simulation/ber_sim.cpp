@@ -0,0 +1,200 @@
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+#include "export/npy.h"
+#include "modulation/mapper.h"
+#include "nco/nco.h"
+#include "simulation/ber_sim.h"
+
+// Кадров на один захват общих счетчиков
+constexpr size_t SIM_FRAMES_PER_BATCH = 8;
+
+double SimPoint::evm_percent() const {
+    return symbols ? 100.0 * std::sqrt(error_power / symbols) : 0.0;
+}
+
+double theoretical_ber(double ebn0_db) {
+    return 0.5 * std::erfc(std::sqrt(std::pow(10.0, ebn0_db / 10.0)));
+}
+
+// Комплексный гауссов шум: Бокса-Мюллера из одного 64-битного числа
+static cf32 gaussian(std::mt19937_64& gen, float sigma) {
+    uint64_t r = gen();
+    float u1 = ((r >> 40) + 1) * (1.0f / 16777217.0f);
+    float u2 = ((r >> 16) & 0xFFFFFF) * (1.0f / 16777216.0f);
+    float radius = sigma * std::sqrt(-2.0f * std::log(u1));
+    float angle = 2.0f * static_cast<float>(PI) * u2;
+    return cf32(radius * std::cos(angle), radius * std::sin(angle));
+}
+
+// Состояние одного потока: буферы кадра переиспользуются между кадрами
+struct SimWorker {
+    SimWorker(const SimConfig& config, uint64_t seed)
+        : config(config), gen(seed), nco(1.0, config.cfo / config.samples_per_symbol) {
+        size_t bps = config.modulation == SimModulation::QPSK ? 2 : 1;
+        bits.resize(config.frame_symbols * bps);
+        decided.resize(bits.size());
+        symbols.resize(config.frame_symbols);
+        samples.resize(config.frame_symbols * config.samples_per_symbol);
+        delayed.resize(samples.size());
+    }
+
+    void run_frame(float sigma, SimPoint& result) {
+        const size_t sps = config.samples_per_symbol;
+        const size_t bps = config.modulation == SimModulation::QPSK ? 2 : 1;
+
+        for (size_t i = 0; i < bits.size(); i += 64) {
+            uint64_t word = gen();
+            for (size_t b = 0; b < 64 && i + b < bits.size(); ++b) bits[i + b] = (word >> b) & 1;
+        }
+
+        if (config.modulation == SimModulation::QPSK) qpsk_map(bits.data(), bits.size(), symbols.data());
+        else bpsk_map(bits.data(), bits.size(), symbols.data());
+
+        for (size_t k = 0; k < symbols.size(); ++k) {
+            for (size_t s = 0; s < sps; ++s) samples[k * sps + s] = symbols[k];
+        }
+
+        // Задержка: y[n] = x[n - tau], до начала кадра сигнал нулевой
+        double tau = config.timing * sps;
+        size_t whole = static_cast<size_t>(tau);
+        float frac = static_cast<float>(tau - whole);
+        for (size_t n = 0; n < samples.size(); ++n) {
+            cf32 a = n >= whole ? samples[n - whole] : cf32();
+            cf32 b = n >= whole + 1 ? samples[n - whole - 1] : cf32();
+            delayed[n] = a + frac * (b - a);
+        }
+
+        // Фаза известна в начале кадра (как после преамбулы), дальше CFO не компенсируется
+        if (config.cfo != 0.0) {
+            nco.set_phase(0.0);
+            nco.mix(delayed.data(), delayed.data(), delayed.size());
+        }
+
+        for (cf32& x : delayed) x += gaussian(gen, sigma);
+
+        // Согласованный фильтр для прямоугольного импульса - накопление за символ
+        for (size_t k = 0; k < symbols.size(); ++k) {
+            cf32 sum = 0;
+            for (size_t s = 0; s < sps; ++s) sum += delayed[k * sps + s];
+            symbols[k] = sum / static_cast<float>(sps) - symbols[k];
+        }
+
+        // В symbols теперь вектор ошибки; решения принимаются по r = s + e
+        for (size_t k = 0; k < symbols.size(); ++k) {
+            cf32 reference;
+            if (config.modulation == SimModulation::QPSK) {
+                reference = cf32(QPSK_AMPLITUDE * (1.0f - 2.0f * bits[2 * k]),
+                                 QPSK_AMPLITUDE * (1.0f - 2.0f * bits[2 * k + 1]));
+            } else {
+                reference = cf32(1.0f - 2.0f * bits[k], 0.0f);
+            }
+            symbols[k] += reference;
+            result.error_power += std::norm(symbols[k] - reference);
+        }
+
+        if (config.modulation == SimModulation::QPSK) qpsk_demap(symbols.data(), symbols.size(), decided.data());
+        else bpsk_demap(symbols.data(), symbols.size(), decided.data());
+
+        for (size_t k = 0; k < symbols.size(); ++k) {
+            int errors = 0;
+            for (size_t b = 0; b < bps; ++b) errors += decided[k * bps + b] != bits[k * bps + b];
+            result.bit_errors += errors;
+            result.symbol_errors += errors != 0;
+        }
+        result.bits += bits.size();
+        result.symbols += symbols.size();
+    }
+
+    const SimConfig& config;
+    std::mt19937_64 gen;
+    Nco nco;
+    std::vector<uint8_t> bits;
+    std::vector<uint8_t> decided;
+    std::vector<cf32> symbols;
+    std::vector<cf32> samples;
+    std::vector<cf32> delayed;
+};
+
+SimPoint simulate_point(const SimConfig& config, double ebn0_db, size_t point_index) {
+    size_t threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    // Es = 1 на отсчет, символ длится sps отсчетов: Eb = sps / bps, N0 = Eb / (Eb/N0)
+    double bps = config.modulation == SimModulation::QPSK ? 2.0 : 1.0;
+    double ebn0 = std::pow(10.0, ebn0_db / 10.0);
+    double n0 = config.samples_per_symbol / bps / ebn0;
+    float sigma = static_cast<float>(std::sqrt(n0 / 2.0));
+
+    SimPoint total;
+    total.ebn0_db = ebn0_db;
+    std::mutex total_mutex;
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> bits{0};
+
+    auto worker_loop = [&](size_t index) {
+        // Независимые потоки ГСЧ: seed_seq перемешивает (seed, точка, поток)
+        std::seed_seq seq{config.seed, uint64_t(point_index), uint64_t(index)};
+        std::mt19937_64 seeder(seq);
+        SimWorker worker(config, seeder());
+
+        SimPoint local;
+        while (errors < config.target_errors && bits < config.max_bits) {
+            SimPoint batch;
+            for (size_t f = 0; f < SIM_FRAMES_PER_BATCH; ++f) worker.run_frame(sigma, batch);
+            errors += batch.bit_errors;
+            bits += batch.bits;
+
+            local.bits += batch.bits;
+            local.bit_errors += batch.bit_errors;
+            local.symbols += batch.symbols;
+            local.symbol_errors += batch.symbol_errors;
+            local.error_power += batch.error_power;
+        }
+
+        std::lock_guard<std::mutex> lock(total_mutex);
+        total.bits += local.bits;
+        total.bit_errors += local.bit_errors;
+        total.symbols += local.symbols;
+        total.symbol_errors += local.symbol_errors;
+        total.error_power += local.error_power;
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) pool.emplace_back(worker_loop, t);
+    for (std::thread& t : pool) t.join();
+
+    return total;
+}
+
+std::vector<SimPoint> simulate_curve(const SimConfig& config, const std::vector<double>& ebn0_db) {
+    std::vector<SimPoint> points;
+    for (size_t i = 0; i < ebn0_db.size(); ++i) points.push_back(simulate_point(config, ebn0_db[i], i));
+    return points;
+}
+
+bool save_curve(const std::string& path, const SimConfig& config, const std::vector<SimPoint>& points) {
+    std::vector<double> ebn0, ber, ser, evm, theory;
+    std::vector<int64_t> bits;
+    for (const SimPoint& p : points) {
+        ebn0.push_back(p.ebn0_db);
+        ber.push_back(p.ber());
+        ser.push_back(p.ser());
+        evm.push_back(p.evm_percent());
+        theory.push_back(theoretical_ber(p.ebn0_db));
+        bits.push_back(static_cast<int64_t>(p.bits));
+    }
+
+    NpzWriter npz;
+    if (!npz.open(path)) return false;
+    std::vector<size_t> shape = {points.size()};
+    bool ok = npz.add("ebn0_db", ebn0.data(), shape) && npz.add("ber", ber.data(), shape) &&
+              npz.add("ser", ser.data(), shape) && npz.add("evm", evm.data(), shape) &&
+              npz.add("theory", theory.data(), shape) && npz.add("bits", bits.data(), shape) &&
+              npz.add_string("modulation", config.modulation == SimModulation::QPSK ? "qpsk" : "bpsk") &&
+              npz.add_scalar("cfo", config.cfo) && npz.add_scalar("timing", config.timing) &&
+              npz.add_scalar("samples_per_symbol", static_cast<int64_t>(config.samples_per_symbol));
+    return npz.close() && ok;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sub_funcs.h"
+
+// Monte-Carlo моделирование цепочки
+// маппер -> прямоугольные импульсы -> канал (AWGN, CFO, задержка) -> согласованный фильтр -> решения.
+// Кадры независимы и раздаются потокам; у каждого потока свой генератор,
+// засеянный от (seed, точка, поток), поэтому потоки не делят состояние.
+
+enum class SimModulation { BPSK, QPSK };
+
+struct SimConfig {
+    SimModulation modulation = SimModulation::QPSK;
+    size_t samples_per_symbol = 4;
+    size_t frame_symbols = 4096;
+
+    // Расстройка по частоте в долях символьной скорости; фаза обнуляется в начале кадра,
+    // поэтому ухудшение растет с frame_symbols
+    double cfo = 0.0;
+    // Задержка в долях символа (0..1), дробная часть - линейной интерполяцией
+    double timing = 0.0;
+
+    // Адаптивная остановка: точка считается, пока не набрано target_errors
+    // битовых ошибок или не передано max_bits бит
+    uint64_t target_errors = 200;
+    uint64_t max_bits = 100000000;
+
+    size_t threads = 0;  // 0 - все ядра
+    uint64_t seed = 1;
+};
+
+struct SimPoint {
+    double ebn0_db = 0.0;
+    uint64_t bits = 0;
+    uint64_t bit_errors = 0;
+    uint64_t symbols = 0;
+    uint64_t symbol_errors = 0;
+    double error_power = 0.0;  // сумма |r - s|^2 для EVM
+
+    double ber() const { return bits ? double(bit_errors) / bits : 0.0; }
+    double ser() const { return symbols ? double(symbol_errors) / symbols : 0.0; }
+    // EVM в процентах относительно единичной энергии символа
+    double evm_percent() const;
+};
+
+// Теоретическая BER для BPSK/QPSK с когерентным приемом: 0.5 * erfc(sqrt(Eb/N0))
+double theoretical_ber(double ebn0_db);
+
+SimPoint simulate_point(const SimConfig& config, double ebn0_db, size_t point_index = 0);
+
+std::vector<SimPoint> simulate_curve(const SimConfig& config, const std::vector<double>& ebn0_db);
+
+// Результаты в .npz: массивы ebn0_db, ber, ser, evm, bits, theory и параметры сценария
+bool save_curve(const std::string& path, const SimConfig& config, const std::vector<SimPoint>& points);
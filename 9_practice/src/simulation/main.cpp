@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "simulation/ber_sim.h"
+
+// Список значений "a,b,c" или диапазон "start:stop:step"
+static std::vector<double> parse_values(const std::string& text) {
+    std::vector<double> values;
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        double start = atof(text.c_str());
+        size_t colon2 = text.find(':', colon + 1);
+        double stop = atof(text.c_str() + colon + 1);
+        double step = colon2 == std::string::npos ? 1.0 : atof(text.c_str() + colon2 + 1);
+        for (double v = start; step > 0 && v <= stop + step * 1e-9; v += step) values.push_back(v);
+        return values;
+    }
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t comma = text.find(',', begin);
+        if (comma == std::string::npos) comma = text.size();
+        values.push_back(atof(text.substr(begin, comma - begin).c_str()));
+        begin = comma + 1;
+    }
+    return values;
+}
+
+// Использование: ber_sim.out [mod=qpsk] [ebn0=0:10:1] [cfo=0] [timing=0] [sps=4]
+//                            [errors=200] [max_bits=1e8] [threads=0] [out=ber_curve]
+int main(int argc, char** argv) {
+    SimConfig config;
+    std::vector<double> ebn0 = parse_values("0:10:1");
+    std::vector<double> cfos = {0.0};
+    std::vector<double> timings = {0.0};
+    std::string out = "ber_curve";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "mod") config.modulation = value == "bpsk" ? SimModulation::BPSK : SimModulation::QPSK;
+        else if (key == "ebn0") ebn0 = parse_values(value);
+        else if (key == "cfo") cfos = parse_values(value);
+        else if (key == "timing") timings = parse_values(value);
+        else if (key == "sps") config.samples_per_symbol = strtoul(value.c_str(), nullptr, 10);
+        else if (key == "errors") config.target_errors = strtoull(value.c_str(), nullptr, 10);
+        else if (key == "max_bits") config.max_bits = static_cast<uint64_t>(atof(value.c_str()));
+        else if (key == "threads") config.threads = strtoul(value.c_str(), nullptr, 10);
+        else if (key == "out") out = value;
+        else {
+            printf("Неизвестный параметр: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+    if (config.samples_per_symbol == 0) config.samples_per_symbol = 1;
+
+    for (double cfo : cfos) {
+        for (double timing : timings) {
+            config.cfo = cfo;
+            config.timing = timing;
+            printf("\n%s, CFO %.4g Rs, задержка %.3g T\n",
+                   config.modulation == SimModulation::QPSK ? "QPSK" : "BPSK", cfo, timing);
+            printf(" Eb/N0, дБ        BER     теория        SER   EVM, %%       бит   время, с\n");
+
+            std::vector<SimPoint> points;
+            for (size_t p = 0; p < ebn0.size(); ++p) {
+                auto start = std::chrono::steady_clock::now();
+                points.push_back(simulate_point(config, ebn0[p], p));
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                const SimPoint& r = points.back();
+                printf("%11.2f %10.3e %10.3e %10.3e %8.2f %9.2e %10.2f\n", r.ebn0_db, r.ber(),
+                       theoretical_ber(r.ebn0_db), r.ser(), r.evm_percent(), double(r.bits), seconds);
+            }
+
+            char path[512];
+            snprintf(path, sizeof(path), "%s_cfo%g_t%g.npz", out.c_str(), cfo, timing);
+            if (save_curve(path, config, points)) printf("Кривая сохранена в %s\n", path);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "export/npy.h"
+#include "sounder/sounder.h"
+
+// Модель канала для проверки без радио: задержка, эхо и шум
+static std::vector<cf32> simulate_channel(const ChannelSounder& sounder, double delay, double snr_db,
+                                          std::mt19937& gen) {
+    const std::vector<cf32>& probe = sounder.probe();
+    std::vector<cf32> rx(sounder.window_samples());
+    size_t whole = static_cast<size_t>(delay);
+    float frac = static_cast<float>(delay - whole);
+
+    // Основной луч с дробной задержкой (линейная интерполяция) и эхо -6 дБ через 5 отсчетов
+    for (size_t n = 0; n < probe.size(); ++n) {
+        for (auto [offset, gain] : {std::pair<size_t, cf32>{0, cf32(1.0f, 0.0f)}, {5, cf32(0.0f, 0.5f)}}) {
+            size_t index = whole + offset + n;
+            if (index + 1 >= rx.size()) continue;
+            rx[index] += gain * probe[n] * (1 - frac);
+            rx[index + 1] += gain * probe[n] * frac;
+        }
+    }
+
+    double signal_power = 0;
+    for (const cf32& p : probe) signal_power += std::norm(p);
+    signal_power /= probe.size();
+    std::normal_distribution<float> noise(0.0f, static_cast<float>(std::sqrt(signal_power / std::pow(10, snr_db / 10) / 2)));
+    for (cf32& x : rx) x += cf32(noise(gen), noise(gen));
+    return rx;
+}
+
+// Использование:
+//   sounder.out sim [probe=prbs|chirp] [length=1023] [repeats=100] [delay=37.3] [snr=10]
+//   sounder.out backend=... uri=... [probe=...] [repeats=100] [lead_us=4000] [out=sounder.npz]
+int main(int argc, char** argv) {
+    DeviceConfig device_config;
+    SounderConfig config;
+    bool simulation = false;
+    size_t repeats = 100;
+    double sim_delay = 37.3;
+    double sim_snr = 10.0;
+    std::string out = "sounder.npz";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        const char* value = eq == std::string::npos ? "" : arg.c_str() + eq + 1;
+        if (arg == "sim") simulation = true;
+        else if (key == "probe") config.type = std::string(value) == "chirp" ? ProbeType::Chirp : ProbeType::PRBS;
+        else if (key == "length") config.probe_length = strtoul(value, nullptr, 10);
+        else if (key == "repeats") repeats = strtoul(value, nullptr, 10);
+        else if (key == "lead_us") config.lead_ns = static_cast<long long>(atof(value) * 1000);
+        else if (key == "delay") sim_delay = atof(value);
+        else if (key == "snr") sim_snr = atof(value);
+        else if (key == "out") out = value;
+        else if (!parse_device_arg(arg, device_config)) {
+            printf("Неверное значение: %s\n", arg.c_str());
+            return -1;
+        }
+    }
+
+    ChannelSounder sounder(config, device_config.sample_rate);
+
+    std::unique_ptr<Device> device;
+    std::unique_ptr<RxStream> rx;
+    std::unique_ptr<TxStream> tx;
+    if (!simulation) {
+        device = make_device(device_config);
+        if (!device) return -1;
+        rx = device->open_rx();
+        tx = device->open_tx();
+        if (!rx || !tx) {
+            printf("Не удалось открыть потоки\n");
+            return -1;
+        }
+    }
+
+    std::mt19937 gen(1);
+    std::vector<double> delays, snrs, margins;
+    std::vector<float> cir_sum(config.cir_taps, 0.0f);
+    size_t missed = 0;
+
+    for (size_t r = 0; r < repeats; ++r) {
+        SoundingResult result;
+        if (simulation) {
+            std::vector<cf32> window = simulate_channel(sounder, sim_delay, sim_snr, gen);
+            result = sounder.analyze(window.data(), window.size());
+        } else if (!sounder.measure(*rx, *tx, result)) {
+            printf("Ошибка обмена с устройством\n");
+            return -1;
+        }
+
+        if (!result.found) {
+            missed++;
+            continue;
+        }
+        delays.push_back(result.delay_samples);
+        snrs.push_back(result.snr_db);
+        margins.push_back(result.margin_us);
+        for (size_t t = 0; t < result.cir_db.size(); ++t) cir_sum[t] += std::pow(10.0f, result.cir_db[t] / 10);
+    }
+
+    if (delays.empty()) {
+        printf("Зондирующий сигнал не найден ни в одном из %zu повторов\n", repeats);
+        return -1;
+    }
+
+    auto mean = [](const std::vector<double>& v) {
+        double sum = 0;
+        for (double x : v) sum += x;
+        return sum / v.size();
+    };
+    double delay_mean = mean(delays);
+    double delay_var = 0;
+    for (double d : delays) delay_var += (d - delay_mean) * (d - delay_mean);
+    double delay_std = std::sqrt(delay_var / delays.size());
+
+    printf("Повторов %zu, не найдено %zu\n", repeats, missed);
+    printf("Задержка: %.2f ± %.2f отсчетов (%.3f мкс), [%.2f, %.2f]\n", delay_mean, delay_std,
+           delay_mean * 1e6 / device_config.sample_rate, *std::min_element(delays.begin(), delays.end()),
+           *std::max_element(delays.begin(), delays.end()));
+    printf("SNR: %.1f дБ\n", mean(snrs));
+    if (!simulation) {
+        printf("Запас планирования: среднее %.0f мкс, минимум %.0f мкс\n", mean(margins),
+               *std::min_element(margins.begin(), margins.end()));
+    }
+    printf("Импульсная характеристика (средняя, дБ от пика):");
+    std::vector<float> cir(config.cir_taps);
+    for (size_t t = 0; t < cir.size(); ++t) {
+        cir[t] = 10 * std::log10(cir_sum[t] / delays.size() + 1e-30f);
+        if (t < 12) printf(" %.1f", cir[t]);
+    }
+    printf("\n");
+
+    NpzWriter npz;
+    if (npz.open(out)) {
+        npz.add("delay_samples", delays.data(), {delays.size()});
+        npz.add("snr_db", snrs.data(), {snrs.size()});
+        npz.add("margin_us", margins.data(), {margins.size()});
+        npz.add("cir_db", cir.data(), {cir.size()});
+        npz.add_scalar("sample_rate", device_config.sample_rate);
+        npz.close();
+    }
+    return 0;
+}
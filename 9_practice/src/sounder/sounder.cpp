@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "prbs/prbs.h"
+#include "sounder/sounder.h"
+
+// Меньше отсчетов без сигнала - оценка шума ненадежна, SNR не считается
+constexpr size_t SOUNDER_MIN_NOISE_SAMPLES = 64;
+// Подряд пропущенных повторов (переполнение, таймаут), после которых measure - ошибка
+constexpr size_t SOUNDER_MAX_ATTEMPTS = 10;
+
+static size_t correlation_size(size_t probe, size_t search) {
+    size_t size = 1;
+    while (size < probe + search + probe) size <<= 1;
+    return size;
+}
+
+ChannelSounder::ChannelSounder(const SounderConfig& config, double sample_rate)
+    : config(config), sample_rate(sample_rate),
+      forward(correlation_size(config.probe_length, config.search_samples)),
+      inverse(correlation_size(config.probe_length, config.search_samples), true) {
+    probe_signal.resize(config.probe_length);
+
+    if (config.type == ProbeType::PRBS) {
+        // BPSK по одному отсчету на символ
+        std::vector<uint8_t> bits(config.probe_length);
+        PrbsGenerator generator(prbs_type_from_order(config.prbs_order), 0x5A5A5A5Au);
+        generator.fill_bits(bits.data(), bits.size());
+        for (size_t n = 0; n < bits.size(); ++n) probe_signal[n] = cf32(config.amplitude * (1.0f - 2.0f * bits[n]), 0);
+    } else {
+        // ЛЧМ от -B/2 до +B/2: фаза pi * k * n^2 + 2 pi f0 n
+        double length = static_cast<double>(config.probe_length);
+        double rate = config.chirp_bandwidth / length;
+        double f0 = -config.chirp_bandwidth / 2;
+        for (size_t n = 0; n < config.probe_length; ++n) {
+            double phase = 2 * PI * (f0 * n + 0.5 * rate * n * n);
+            probe_signal[n] = std::polar(config.amplitude, static_cast<float>(phase));
+        }
+    }
+
+    probe_energy = 0;
+    for (const cf32& s : probe_signal) probe_energy += std::norm(s);
+
+    probe_spectrum.assign(forward.size(), cf32());
+    std::copy(probe_signal.begin(), probe_signal.end(), probe_spectrum.begin());
+    forward.execute(probe_spectrum.data());
+    // Нормировка обратного БПФ (1/N) заранее внесена в спектр зонда
+    float scale = 1.0f / forward.size();
+    for (cf32& s : probe_spectrum) s = std::conj(s) * scale;
+
+    work.resize(forward.size());
+}
+
+SoundingResult ChannelSounder::analyze(const cf32* rx, size_t samples_count) {
+    SoundingResult result;
+    size_t window = std::min(samples_count, window_samples());
+    size_t n_fft = forward.size();
+
+    // c[k] = sum rx[k + n] * conj(p[n]) = IFFT(FFT(rx) * conj(FFT(p)))
+    std::fill(work.begin(), work.end(), cf32());
+    std::copy(rx, rx + window, work.begin());
+    forward.execute(work.data());
+    for (size_t k = 0; k < n_fft; ++k) work[k] *= probe_spectrum[k];
+    inverse.execute(work.data());
+
+    // Допустимые задержки: пик должен целиком укладываться в окно
+    size_t lags = window > probe_signal.size() ? window - probe_signal.size() + 1 : 0;
+    if (lags == 0) return result;
+
+    size_t peak = 0;
+    float peak_power = 0;
+    double total_power = 0;
+    for (size_t k = 0; k < lags; ++k) {
+        float power = std::norm(work[k]);
+        total_power += power;
+        if (power > peak_power) {
+            peak_power = power;
+            peak = k;
+        }
+    }
+
+    // Шум корреляции - вне окрестности пика (там многолучевость)
+    double noise_power = 0;
+    size_t noise_count = 0;
+    for (size_t k = 0; k < lags; ++k) {
+        if (k + 2 >= peak && k <= peak + config.cir_taps) continue;
+        noise_power += std::norm(work[k]);
+        noise_count++;
+    }
+    noise_power = noise_count ? noise_power / noise_count : total_power / lags;
+
+    // Пик значим, если заметно выше фона корреляции
+    result.found = peak_power > 10 * noise_power;
+    if (!result.found) return result;
+
+    // Дробная часть задержки по параболе через соседние отсчеты модуля
+    double offset = 0;
+    if (peak > 0 && peak + 1 < lags) {
+        double a = std::abs(work[peak - 1]), b = std::abs(work[peak]), c = std::abs(work[peak + 1]);
+        double denominator = a - 2 * b + c;
+        if (denominator != 0) offset = 0.5 * (a - c) / denominator;
+    }
+    result.delay_samples = peak + offset;
+    result.delay_ns = result.delay_samples * 1e9 / sample_rate;
+
+    for (size_t t = 0; t < config.cir_taps && peak + t < lags; ++t) {
+        result.cir_db.push_back(10.0f * std::log10(std::norm(work[peak + t]) / peak_power + 1e-30f));
+    }
+
+    // SNR: шум - по отсчетам окна до прихода сигнала и после хвоста импульсной
+    // характеристики, сигнал - превышение мощности над шумом на интервале зонда.
+    // Боковые лепестки корреляции в оценку не попадают.
+    size_t signal_end = std::min(window, peak + probe_signal.size() + config.cir_taps);
+    double noise_sum = 0, signal_sum = 0;
+    size_t noise_samples = 0;
+    for (size_t n = 0; n < window; ++n) {
+        double power = std::norm(rx[n]);
+        if (n + 1 < peak || n >= signal_end) {
+            noise_sum += power;
+            noise_samples++;
+        } else if (n >= peak && n < peak + probe_signal.size()) {
+            signal_sum += power;
+        }
+    }
+    if (noise_samples >= SOUNDER_MIN_NOISE_SAMPLES) {
+        double noise_level = noise_sum / noise_samples;
+        double signal_level = signal_sum / std::min(probe_signal.size(), window - peak) - noise_level;
+        result.snr_db = 10 * std::log10(std::max(signal_level, 1e-30) / std::max(noise_level, 1e-30));
+    } else {
+        result.snr_db = NAN;
+    }
+    return result;
+}
+
+bool ChannelSounder::measure(RxStream& rx, TxStream& tx, SoundingResult& result) {
+    for (size_t attempt = 0; attempt < SOUNDER_MAX_ATTEMPTS; ++attempt) {
+        long status = measure_once(rx, tx, result);
+        if (status > 0) return true;
+        if (status < 0) return false;
+    }
+    printf("Повтор зондирования не удался %zu раз подряд (переполнения или таймауты)\n", SOUNDER_MAX_ATTEMPTS);
+    return false;
+}
+
+long ChannelSounder::measure_once(RxStream& rx, TxStream& tx, SoundingResult& result) {
+    const size_t mtu = rx.mtu();
+    std::vector<int16_t> block(2 * mtu);
+    std::vector<int16_t> probe_iq(2 * probe_signal.size());
+    cf32_to_cs16(probe_signal.data(), probe_iq.data(), probe_signal.size());
+
+    // Первый буфер задает шкалу времени, передача - через lead_ns.
+    // Переполнение или таймаут (0) - повтор пропущен, измерение начинается заново
+    long long time_ns = 0;
+    int flags = 0;
+    long got = rx.read(block.data(), mtu, &time_ns, &flags, 1000000);
+    if (got <= 0) return got;
+    auto read_done = std::chrono::steady_clock::now();
+    bool timed = flags & STREAM_HAS_TIME;
+    long long block_end_ns = time_ns + static_cast<long long>(got * 1e9 / sample_rate);
+    long long tx_time = time_ns + config.lead_ns;
+
+    // write может принять меньше: остаток дописывается, метка - только до первого принятого отсчета
+    for (size_t pos = 0; pos < probe_signal.size();) {
+        size_t count = std::min(tx.mtu(), probe_signal.size() - pos);
+        int tx_flags = pos == 0 ? STREAM_HAS_TIME : 0;
+        long sent = tx.write(&probe_iq[2 * pos], count, tx_time, tx_flags, 1000000);
+        if (sent < 0) return sent;
+        if (sent == 0) return 0;
+        pos += static_cast<size_t>(sent);
+    }
+
+    // Запас: сколько времени устройства оставалось до передачи, когда отправка закончилась.
+    // Текущее время устройства - конец прочитанного буфера плюс прошедшее время хоста.
+    double host_elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - read_done).count();
+    result.margin_us = (tx_time - (block_end_ns + host_elapsed_ns)) / 1e3;
+
+    // Сбор окна от времени передачи; без меток время ведется по числу отсчетов.
+    // Разрыв внутри окна портит его целиком: этот повтор пропускается
+    std::vector<cf32> window(window_samples());
+    size_t filled = 0;
+    long long stream_ns = block_end_ns;
+    while (filled < window.size()) {
+        got = rx.read(block.data(), mtu, &time_ns, &flags, 1000000);
+        if (got <= 0) return got;
+        if (!timed || !(flags & STREAM_HAS_TIME)) time_ns = stream_ns;
+        stream_ns = time_ns + static_cast<long long>(got * 1e9 / sample_rate);
+
+        // Индекс отсчета, принятого в момент tx_time
+        long long first = static_cast<long long>(std::llround((tx_time - time_ns) * sample_rate / 1e9));
+        for (long n = 0; n < got && filled < window.size(); ++n) {
+            long long index = n - first;
+            if (index < static_cast<long long>(filled) || index >= static_cast<long long>(window.size())) continue;
+            cs16_to_cf32(&block[2 * n], &window[index], 1);
+            filled = index + 1;
+        }
+    }
+
+    SoundingResult analyzed = analyze(window.data(), window.size());
+    analyzed.margin_us = result.margin_us;
+    result = analyzed;
+    return 1;
+}
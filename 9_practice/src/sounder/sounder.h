@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "fft/fft.h"
+#include "sdr/device.h"
+
+// Зондирование канала TX -> RX: известный сигнал передается в назначенное время
+// устройства (как tx_time = timeNs + 4 мс во 2-6 практиках), в принятом потоке ищется
+// корреляцией. Отсчет RX, соответствующий времени передачи, находится по меткам
+// времени, поэтому положение пика - задержка тракта с точностью до отсчета
+// (и дробная часть по параболе). Корреляция считается через БПФ с кэшированными планами.
+
+enum class ProbeType { PRBS, Chirp };
+
+struct SounderConfig {
+    ProbeType type = ProbeType::PRBS;
+    int prbs_order = 15;              // PRBS: берутся первые probe_length бит
+    size_t probe_length = 1023;       // отсчетов зондирующего сигнала
+    double chirp_bandwidth = 0.8;     // ЛЧМ: полоса в долях частоты дискретизации
+    float amplitude = 0.5f;
+    long long lead_ns = 4000000;      // передача через столько после метки RX
+    size_t search_samples = 4096;     // максимальная ожидаемая задержка тракта
+    size_t cir_taps = 32;             // отсчетов импульсной характеристики после пика
+};
+
+struct SoundingResult {
+    bool found = false;
+    double delay_samples = 0;         // задержка относительно назначенного времени передачи
+    double delay_ns = 0;
+    double snr_db = 0;                // на отсчет; NAN, если в окне мало отсчетов без сигнала
+    double margin_us = 0;             // запас между отправкой и временем передачи на устройстве
+    std::vector<float> cir_db;        // |h|^2 от пика, дБ относительно пика
+};
+
+class ChannelSounder {
+public:
+    ChannelSounder(const SounderConfig& config, double sample_rate);
+
+    const std::vector<cf32>& probe() const { return probe_signal; }
+    size_t window_samples() const { return probe_signal.size() + config.search_samples; }
+
+    // rx[0] - отсчет, принятый в назначенное время передачи; нужно window_samples() отсчетов
+    SoundingResult analyze(const cf32* rx, size_t samples_count);
+
+    // Одно измерение на устройстве: прием, передача по метке, сбор окна, анализ.
+    // Повтор, прерванный переполнением или таймаутом, выполняется заново
+    bool measure(RxStream& rx, TxStream& tx, SoundingResult& result);
+
+private:
+    // 1 - измерено, 0 - повтор пропущен (переполнение, таймаут), < 0 - ошибка устройства
+    long measure_once(RxStream& rx, TxStream& tx, SoundingResult& result);
+
+    SounderConfig config;
+    double sample_rate;
+
+    std::vector<cf32> probe_signal;
+    std::vector<cf32> probe_spectrum;   // сопряженный спектр зонда
+    FftPlan forward;
+    FftPlan inverse;
+    std::vector<cf32> work;
+    float probe_energy;
+};
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "capture/capture_file.h"
+#include "fft/fft.h"
+#include "spectrum/spectrum.h"
+
+constexpr double SAMPLING_RATE = 1000000;
+constexpr size_t BLOCK_SIZE = 1920;
+constexpr float DB_MIN = -120.0f;
+constexpr float DB_MAX = 0.0f;
+
+// Использование:
+//   spectrum.out <capture.pcm | -> <waterfall.wfl | host:port> [fft_size] [averages]
+// "-" - читать CS16 из stdin (например, из конвейера приемника)
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("Использование: %s <capture.pcm | -> <waterfall.wfl | host:port> [fft_size] [averages]\n", argv[0]);
+        return -1;
+    }
+
+    SpectrumConfig config;
+    if (argc > 3) config.fft_size = strtoul(argv[3], nullptr, 10);
+    if (argc > 4) config.averages = strtoul(argv[4], nullptr, 10);
+    if (!is_power_of_two(config.fft_size) || config.fft_size < 2) {
+        printf("fft_size - степень двойки не меньше 2\n");
+        return -1;
+    }
+
+    WaterfallWriter writer(config.fft_size, SAMPLING_RATE, DB_MIN, DB_MAX);
+
+    std::string target = argv[2];
+    size_t colon = target.rfind(':');
+    bool opened = colon != std::string::npos
+        ? writer.connect_tcp(target.substr(0, colon), atoi(target.c_str() + colon + 1))
+        : writer.open_file(target);
+    if (!opened) return -1;
+
+    SpectrumEngine engine(config, [&](const std::vector<float>& power_db, uint64_t first_sample) {
+        writer.write_row(power_db, first_sample);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total_samples = 0;
+
+    if (std::string(argv[1]) == "-") {
+        std::vector<int16_t> block(BLOCK_SIZE * 2);
+        size_t read_samples;
+        while ((read_samples = fread(block.data(), sizeof(int16_t) * 2, BLOCK_SIZE, stdin)) > 0) {
+            engine.process_cs16(block.data(), read_samples);
+            total_samples += read_samples;
+        }
+    } else {
+        CaptureFile capture;
+        if (!capture.open(argv[1])) return -1;
+
+        // Подаем запись блоками размера буфера приемника, как в живом потоке
+        for (size_t offset = 0; offset < capture.samples_count(); offset += BLOCK_SIZE) {
+            size_t count = std::min(BLOCK_SIZE, capture.samples_count() - offset);
+            engine.process_cs16(capture.data() + offset * 2, count);
+        }
+        total_samples = capture.samples_count();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Обработано %llu отсчетов, строк водопада: %zu, скорость %.1f Мотсч/с\n",
+           (unsigned long long)total_samples, writer.rows_written(), total_samples / seconds / 1e6);
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "spectrum/spectrum.h"
+
+#include <arpa/inet.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+size_t SpectrumEngine::hop_for(const SpectrumConfig& config) {
+    double overlap = config.overlap < 0.0 ? 0.0 : (config.overlap > 0.95 ? 0.95 : config.overlap);
+    size_t hop = static_cast<size_t>(config.fft_size * (1.0 - overlap));
+    return hop ? hop : 1;
+}
+
+SpectrumEngine::SpectrumEngine(const SpectrumConfig& config, RowHandler handler)
+    : config(config), handler(std::move(handler)), plan(config.fft_size), hop(hop_for(config)) {
+    if (this->config.averages == 0) this->config.averages = 1;
+
+    window.resize(config.fft_size);
+    double window_power = 0;
+    for (size_t i = 0; i < config.fft_size; ++i) {
+        window[i] = static_cast<float>(window_value(config.window, i, config.fft_size));
+        window_power += window[i] * window[i];
+    }
+
+    // Нормировка: мощность на бин без зависимости от окна и числа усреднений
+    power_scale = static_cast<float>(1.0 / (window_power * this->config.averages));
+
+    work.resize(config.fft_size);
+    accumulator.assign(config.fft_size, 0.0f);
+    row.resize(config.fft_size);
+}
+
+void SpectrumEngine::reset() {
+    pending.clear();
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+    frames_in_row = 0;
+    samples_seen = 0;
+    row_first_sample = 0;
+}
+
+void SpectrumEngine::process(const cf32* in, size_t samples_count) {
+    pending.insert(pending.end(), in, in + samples_count);
+    consume_pending();
+}
+
+void SpectrumEngine::process_cs16(const int16_t* iq, size_t samples_count) {
+    // Конвертируем сразу в хвост очереди, без промежуточного буфера
+    size_t old_size = pending.size();
+    pending.resize(old_size + samples_count);
+    cs16_to_cf32(iq, pending.data() + old_size, samples_count);
+    consume_pending();
+}
+
+void SpectrumEngine::consume_pending() {
+    size_t position = 0;
+    while (pending.size() - position >= config.fft_size) {
+        run_fft(pending.data() + position);
+        position += hop;
+        samples_seen += hop;
+    }
+
+    pending.erase(pending.begin(), pending.begin() + position);
+}
+
+void SpectrumEngine::run_fft(const cf32* frame) {
+    size_t n = config.fft_size;
+
+    if (frames_in_row == 0) row_first_sample = samples_seen;
+
+    for (size_t i = 0; i < n; ++i) {
+        work[i] = frame[i] * window[i];
+    }
+
+    plan.execute(work.data());
+
+    const float* spectrum = reinterpret_cast<const float*>(work.data());
+    float* acc = accumulator.data();
+    for (size_t i = 0; i < n; ++i) {
+        acc[i] += spectrum[2 * i] * spectrum[2 * i] + spectrum[2 * i + 1] * spectrum[2 * i + 1];
+    }
+
+    if (++frames_in_row < config.averages) return;
+
+    // Строка готова: переводим в дБ и переставляем нулевую частоту в центр
+    size_t half = n / 2;
+    for (size_t i = 0; i < n; ++i) {
+        float power = acc[(i + half) & (n - 1)] * power_scale;
+        row[i] = 10.0f * std::log10(power + 1e-20f);
+    }
+
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+    frames_in_row = 0;
+
+    if (handler) handler(row, row_first_sample);
+}
+
+void quantize_row(const std::vector<float>& power_db, float db_min, float db_max, uint8_t* out) {
+    float scale = 255.0f / (db_max - db_min);
+
+    for (size_t i = 0; i < power_db.size(); ++i) {
+        float level = (power_db[i] - db_min) * scale;
+        level = level < 0.0f ? 0.0f : (level > 255.0f ? 255.0f : level);
+        out[i] = static_cast<uint8_t>(level + 0.5f);
+    }
+}
+
+WaterfallWriter::WaterfallWriter(size_t fft_size, double sample_rate, float db_min, float db_max)
+    : fft_size(fft_size), sample_rate(sample_rate), db_min(db_min), db_max(db_max),
+      record(sizeof(uint64_t) + fft_size) {}
+
+WaterfallWriter::~WaterfallWriter() {
+    close();
+}
+
+bool WaterfallWriter::open_file(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        printf("Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+    return write_header();
+}
+
+bool WaterfallWriter::connect_tcp(const std::string& host, int port) {
+    close();
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) {
+        printf("Не удалось найти адрес: %s\n", host.c_str());
+        return false;
+    }
+
+    for (addrinfo* entry = result; entry; entry = entry->ai_next) {
+        fd = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, entry->ai_addr, entry->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd < 0) {
+        printf("Не удалось подключиться к %s:%d\n", host.c_str(), port);
+        return false;
+    }
+    socket_sink = true;
+    return write_header();
+}
+
+void WaterfallWriter::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    socket_sink = false;
+}
+
+bool WaterfallWriter::write_header() {
+    // "WFL1", uint32 fft_size, double sample_rate, float db_min, float db_max
+    uint8_t header[4 + sizeof(uint32_t) + sizeof(double) + 2 * sizeof(float)];
+    uint32_t size = static_cast<uint32_t>(fft_size);
+    uint8_t* p = header;
+
+    memcpy(p, "WFL1", 4);                       p += 4;
+    memcpy(p, &size, sizeof(size));             p += sizeof(size);
+    memcpy(p, &sample_rate, sizeof(sample_rate)); p += sizeof(sample_rate);
+    memcpy(p, &db_min, sizeof(db_min));         p += sizeof(db_min);
+    memcpy(p, &db_max, sizeof(db_max));
+
+    rows = 0;
+    return write_all(header, sizeof(header));
+}
+
+bool WaterfallWriter::write_row(const std::vector<float>& power_db, uint64_t first_sample) {
+    if (fd < 0 || power_db.size() != fft_size) return false;
+
+    memcpy(record.data(), &first_sample, sizeof(first_sample));
+    quantize_row(power_db, db_min, db_max, record.data() + sizeof(first_sample));
+
+    if (!write_all(record.data(), record.size())) return false;
+    ++rows;
+    return true;
+}
+
+bool WaterfallWriter::write_all(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        // Отключившийся клиент не должен завершать процесс сигналом SIGPIPE
+        ssize_t written = socket_sink ? send(fd, bytes, size, MSG_NOSIGNAL) : ::write(fd, bytes, size);
+        if (written <= 0) {
+            // Приемник закрывается: следующие строки отбрасываются без повторных сообщений
+            printf("Ошибка записи водопада\n");
+            close();
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
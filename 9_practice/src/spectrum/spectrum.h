@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "fft/fft.h"
+#include "filter/fir.h"
+#include "sub_funcs.h"
+
+struct SpectrumConfig {
+    size_t fft_size = 1024;
+    double overlap = 0.5;           // Доля перекрытия соседних окон (0..1)
+    size_t averages = 16;           // Сколько БПФ усредняется в одну строку
+    Window window = Window::Blackman;
+};
+
+// Потоковая оценка спектральной плотности мощности методом Уэлча.
+// Окно и план БПФ вычисляются один раз; отсчеты подаются блоками любого размера.
+class SpectrumEngine {
+public:
+    // Строка: мощность в дБ, частоты от -fs/2 до +fs/2; first_sample - номер первого отсчета строки
+    using RowHandler = std::function<void(const std::vector<float>& power_db, uint64_t first_sample)>;
+
+    SpectrumEngine(const SpectrumConfig& config, RowHandler handler);
+
+    size_t fft_size() const { return config.fft_size; }
+    size_t hop_size() const { return hop; }
+    // Шаг окон для config (перекрытие ограничивается 0..0.95) - до создания движка
+    static size_t hop_for(const SpectrumConfig& config);
+
+    void process(const cf32* in, size_t samples_count);
+    void process_cs16(const int16_t* iq, size_t samples_count);
+
+    void reset();
+
+private:
+    void consume_pending();
+    void run_fft(const cf32* frame);
+
+    SpectrumConfig config;
+    RowHandler handler;
+    FftPlan plan;
+    size_t hop;
+
+    std::vector<float> window;
+    float power_scale;
+
+    std::vector<cf32> pending;
+    std::vector<cf32> work;
+    std::vector<float> accumulator;
+    std::vector<float> row;
+    size_t frames_in_row = 0;
+    uint64_t samples_seen = 0;
+    uint64_t row_first_sample = 0;
+};
+
+// Квантование строки в uint8: db_min -> 0, db_max -> 255
+void quantize_row(const std::vector<float>& power_db, float db_min, float db_max, uint8_t* out);
+
+// Двоичный водопад: заголовок, затем строки (uint64 номер отсчета + fft_size байт).
+// Пишет в файл или в TCP-сокет, в обоих случаях через один write() на строку.
+class WaterfallWriter {
+public:
+    WaterfallWriter(size_t fft_size, double sample_rate, float db_min, float db_max);
+    ~WaterfallWriter();
+
+    WaterfallWriter(const WaterfallWriter&) = delete;
+    WaterfallWriter& operator=(const WaterfallWriter&) = delete;
+
+    bool open_file(const std::string& path);
+    bool connect_tcp(const std::string& host, int port);
+    void close();
+
+    bool write_row(const std::vector<float>& power_db, uint64_t first_sample);
+
+    size_t rows_written() const { return rows; }
+
+private:
+    bool write_header();
+    bool write_all(const void* data, size_t size);
+
+    size_t fft_size;
+    double sample_rate;
+    float db_min;
+    float db_max;
+    int fd = -1;
+    bool socket_sink = false;
+    size_t rows = 0;
+    std::vector<uint8_t> record;
+};
@@ -0,0 +1,18 @@
+#include "sub_funcs.h"
+
+void cs16_to_cf32(const int16_t* iq, cf32* out, size_t samples_count) {
+    const float scale = 1.0f / CS16_FULL_SCALE;
+    float* dst = reinterpret_cast<float*>(out);
+
+    for (size_t i = 0; i < samples_count * 2; ++i) {
+        dst[i] = iq[i] * scale;
+    }
+}
+
+void cf32_to_cs16(const cf32* in, int16_t* iq, size_t samples_count) {
+    const float* src = reinterpret_cast<const float*>(in);
+
+    for (size_t i = 0; i < samples_count * 2; ++i) {
+        iq[i] = saturate_int16(src[i] * CS16_FULL_SCALE);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+// Комплексный отсчет, с которым работают все DSP-блоки
+using cf32 = std::complex<float>;
+
+constexpr double PI = 3.14159265358979323846;
+
+// Полная шкала ЦАП/АЦП Pluto: 12 бит, выровненные влево в int16
+constexpr int SAMPLE_SHIFT = 4;
+constexpr float CS16_FULL_SCALE = 2047 << SAMPLE_SHIFT;
+
+// CS16 (I, Q, I, Q, ...) -> cf32 в диапазоне [-1, 1)
+void cs16_to_cf32(const int16_t* iq, cf32* out, size_t samples_count);
+
+// cf32 -> CS16 с насыщением
+void cf32_to_cs16(const cf32* in, int16_t* iq, size_t samples_count);
+
+// Насыщение float -> int16
+inline int16_t saturate_int16(float value) {
+    if (value > 32767.0f) return 32767;
+    if (value < -32768.0f) return -32768;
+    return static_cast<int16_t>(value);
+}